@@ -12,9 +12,13 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import numpy as np
+
 from dimod.core.composite import ComposedSampler
 from dimod.sampleset import SampleSet
 
+from dwave.preprocessing.cybias_statistics import clip_wrapper
+
 __all__ = ['ClipComposite']
 
 class ClipComposite(ComposedSampler):
@@ -92,6 +96,10 @@ def _clip_bqm(bqm, lower_bound, upper_bound):
     """Helper function for clipping a bqm."""
 
     bqm_copy = bqm.copy()
+    if bqm_copy.dtype == np.float64:
+        clip_wrapper(bqm_copy, lower_bound, upper_bound)
+        return bqm_copy
+
     if lower_bound is not None:
         linear = bqm_copy.linear
         for k, v in linear.items():
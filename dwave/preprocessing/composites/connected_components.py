@@ -14,7 +14,8 @@
 
 from dimod.core.composite import ComposedSampler
 from dimod.sampleset import SampleSet, append_variables
-from dimod.traversal import connected_components
+
+from dwave.preprocessing.cyfix_variables import connected_components_wrapper
 
 __all__ = ['ConnectedComponentsComposite']
 
@@ -24,6 +25,8 @@ class ConnectedComponentsComposite(ComposedSampler):
 
     Connected components of a binary quadratic model (BQM) graph are computed
     (if not provided), and each subproblem is passed to the child sampler.
+    When the components are not provided, they are found and extracted as
+    binary quadratic models of their own in a single pass over the BQM.
     Returned samples from each child sampler are merged. Only the best solution
     of each response is selected and merged with others (i.e. this composite 
     returns a single solution).
@@ -88,16 +91,12 @@ class ConnectedComponentsComposite(ComposedSampler):
 
         # solve the problem on the child system
         child = self.child
-        variables = bqm.variables
         if components is None:
-            components = list(connected_components(bqm))
-        if isinstance(components, set):
-            components = [components]
+            subbqms = connected_components_wrapper(bqm)
+        else:
+            subbqms = self._fix_components(bqm, components)
         sampleset = None
-        fixed_value = min(bqm.vartype.value)
-        for component in components:
-            bqm_copy = bqm.copy()
-            bqm_copy.fix_variables({i: fixed_value for i in (variables - component)})
+        for bqm_copy in subbqms:
             if sampleset is None:
                 # here .truncate(1) is used to pick the best solution only. The other options
                 # for future development is to combine all sample with all.
@@ -111,3 +110,15 @@ class ConnectedComponentsComposite(ComposedSampler):
         else:
             return SampleSet.from_samples_bqm(sampleset, bqm)
 
+    @staticmethod
+    def _fix_components(bqm, components):
+        """Yield, for each of the given components, ``bqm`` with the variables
+        of the other components fixed."""
+        variables = bqm.variables
+        if isinstance(components, set):
+            components = [components]
+        fixed_value = min(bqm.vartype.value)
+        for component in components:
+            bqm_copy = bqm.copy()
+            bqm_copy.fix_variables({i: fixed_value for i in (variables - component)})
+            yield bqm_copy
@@ -12,10 +12,16 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+from numbers import Number
+
+import numpy as np
+
 from dimod.core.composite import ComposedSampler
 from dimod.decorators import nonblocking_sample_method
 from dimod.sampleset import SampleSet
 
+from dwave.preprocessing.cybias_statistics import bias_statistics_wrapper, scale_wrapper
+
 __all__ = ['ScaleComposite']
 
 class ScaleComposite(ComposedSampler):
@@ -114,7 +120,14 @@ class ScaleComposite(ComposedSampler):
         original_bqm = bqm
         bqm = bqm.copy()  # we're going to be scaling
 
-        if scalar is not None:
+        if bqm.dtype == np.float64 and not (ignored_variables or ignored_interactions):
+            # the ranges of the biases are found, and the biases scaled, in
+            # one pass each over the bqm
+            if scalar is None:
+                scalar = _normalization_scalar(bias_statistics_wrapper(bqm),
+                                               bias_range, quadratic_range)
+            scale_wrapper(bqm, scalar, ignore_offset=ignore_offset)
+        elif scalar is not None:
             bqm.scale(scalar,
                       ignored_variables=ignored_variables,
                       ignored_interactions=ignored_interactions,
@@ -142,3 +155,27 @@ class ScaleComposite(ComposedSampler):
         sampleset.info.update(scalar=scalar)
 
         yield sampleset
+
+
+def _normalization_scalar(stats, bias_range, quadratic_range):
+    """The scalar :meth:`.BinaryQuadraticModel.normalize` scales a BQM by, given
+    the bias statistics of the BQM as returned by ``bias_statistics_wrapper``.
+    """
+    def parse_range(r):
+        if isinstance(r, Number):
+            return -abs(r), abs(r)
+        return r
+
+    if quadratic_range is None:
+        linear_range, quadratic_range = bias_range, bias_range
+    else:
+        linear_range = bias_range
+
+    lin_range, quad_range = map(parse_range, (linear_range, quadratic_range))
+
+    inv_scalar = max(stats['min_linear'] / lin_range[0],
+                     stats['max_linear'] / lin_range[1],
+                     stats['min_quadratic'] / quad_range[0],
+                     stats['max_quadratic'] / quad_range[1])
+
+    return 1.0 / inv_scalar if inv_scalar != 0 else 1.0
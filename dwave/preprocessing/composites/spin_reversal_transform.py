@@ -17,7 +17,8 @@ import typing
 import dimod
 import numpy as np
 
-from dimod import Vartype
+from dwave.preprocessing.cyspin_reversal_transform import (
+    spin_reversal_transform_batch_wrapper, spin_reversal_unflip_batch_wrapper)
 
 __all__ = ['SpinReversalTransformComposite']
 
@@ -158,42 +159,30 @@ class SpinReversalTransformComposite(dimod.core.Sampler, dimod.core.Composite):
             yield sampleset  # this is the one actually used by the user
             return
 
-        # we'll be modifying the BQM, so make a copy
-        bqm = bqm.copy()
-
         # We maintain the Leap behavior that num_spin_reversal_transforms == 1
         # corresponds to a single problem with randomly flipped variables.
 
         # Get the SRT matrix
         SRT = self.rng.random((num_spin_reversal_transforms, bqm.num_variables)) > .5
 
-        # Submit the problems
-        samplesets: typing.List[dimod.SampleSet] = []
-        flipped = np.zeros(bqm.num_variables, dtype=bool)  # what variables are currently flipped
-        for i in range(num_spin_reversal_transforms):
-            # determine what needs to be flipped
-            transform = flipped != SRT[i, :]
-
-            # apply the transform
-            for v, flip in zip(bqm.variables, transform):
-                if flip:
-                    bqm.flip_variable(v)
-            flipped[transform] = ~flipped[transform]
-
-            samplesets.append(sampler.sample(bqm, **kwargs))
+        # Submit the problems, all the transformed BQMs are built in one call
+        # rather than by flipping the variables of a copy one transform at a time
+        samplesets: typing.List[dimod.SampleSet] = [
+            sampler.sample(transformed, **kwargs)
+            for transformed in spin_reversal_transform_batch_wrapper(bqm, SRT)]
 
         # Yield a view of the samplesets that reports done()-ness
         yield self._SampleSets(samplesets)
 
-        # Undo the SRTs according to vartype
-        if bqm.vartype is Vartype.BINARY:
-            for i, sampleset in enumerate(samplesets):
-                sampleset.record.sample[:, SRT[i, :]] = 1 - sampleset.record.sample[:, SRT[i, :]]
-        elif bqm.vartype is Vartype.SPIN:
-            for i, sampleset in enumerate(samplesets):
-                sampleset.record.sample[:, SRT[i, :]] *= -1
-        else:
-            raise RuntimeError("unexpected vartype")
-
-        # finally combine all samplesets together
-        yield dimod.concatenate(samplesets)
+        # Combine all samplesets together, then undo the SRTs of all the samples
+        # in one call. The samples are in the variable order of the first
+        # sampleset, so the SRT matrix is reordered to match.
+        sampleset = dimod.concatenate(samplesets)
+        if len(sampleset) and sampleset.variables:
+            order = [bqm.variables.index(v) for v in sampleset.variables]
+            samples = np.ascontiguousarray(sampleset.record.sample, dtype=np.int8)
+            spin_reversal_unflip_batch_wrapper(samples, [len(ss) for ss in samplesets],
+                                               SRT[:, order], bqm.vartype)
+            sampleset.record.sample[:] = samples
+
+        yield sampleset
@@ -0,0 +1,140 @@
+# distutils: language = c++
+# cython: language_level=3
+#
+# Copyright 2023 D-Wave Systems Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from cython.operator cimport dereference as deref
+
+from libc.math cimport INFINITY
+from libc.stdint cimport int32_t
+
+import dimod
+import numpy as np
+
+from dimod.libcpp cimport BinaryQuadraticModel as cppBinaryQuadraticModel
+from dimod.binary.cybqm cimport cyBQM_float64
+
+
+cdef extern from "include/dwave-preprocessing/bias_statistics.hpp" nogil:
+    cdef cppclass BiasStatistics[B]:
+        size_t num_linear
+        B min_linear
+        B max_linear
+        B max_abs_linear
+        B min_abs_linear
+
+        size_t num_quadratic
+        B min_quadratic
+        B max_quadratic
+        B max_abs_quadratic
+        B min_abs_quadratic
+
+    BiasStatistics[B] biasStatistics[B, V](const cppBinaryQuadraticModel[B, V]& bqm) except +
+
+    void scaleBiases[B, V](cppBinaryQuadraticModel[B, V]& bqm, B scalar, bint scale_offset,
+                           BiasStatistics[B]* stats) except +
+
+    void clipBiases[B, V](cppBinaryQuadraticModel[B, V]& bqm, B lower_bound, B upper_bound,
+                          BiasStatistics[B]* stats) except +
+
+
+cdef cyBQM_float64 _as_cybqm(bqm):
+    if bqm.dtype != np.float64:
+        raise ValueError("bqm must have float64 biases")
+    return bqm.data
+
+
+def bias_statistics_wrapper(bqm):
+    """Cython wrapper for biasStatistics().
+
+    Args:
+        bqm (:class:`.BinaryQuadraticModel`):
+            A binary quadratic model.
+
+    Returns:
+        dict: The number, minimum, maximum, largest absolute value and smallest
+        non-zero absolute value of the linear biases, with keys
+        ``'num_linear'``, ``'min_linear'``, ``'max_linear'``, ``'max_abs_linear'``
+        and ``'min_abs_linear'``, and the same for the quadratic biases. They
+        are all 0 for a kind of bias that ``bqm`` has none of.
+    """
+    bqm = dimod.as_bqm(bqm, dtype=np.float64)
+
+    cdef cyBQM_float64 cybqm = _as_cybqm(bqm)
+    cdef BiasStatistics[double] stats
+    with nogil:
+        stats = biasStatistics[double, int32_t](deref(cybqm.cppbqm))
+
+    return dict(
+        num_linear=stats.num_linear,
+        min_linear=stats.min_linear,
+        max_linear=stats.max_linear,
+        max_abs_linear=stats.max_abs_linear,
+        min_abs_linear=stats.min_abs_linear,
+        num_quadratic=stats.num_quadratic,
+        min_quadratic=stats.min_quadratic,
+        max_quadratic=stats.max_quadratic,
+        max_abs_quadratic=stats.max_abs_quadratic,
+        min_abs_quadratic=stats.min_abs_quadratic,
+        )
+
+
+def scale_wrapper(bqm, scalar, ignore_offset=False):
+    """Cython wrapper for scaleBiases().
+
+    Scale the biases of ``bqm``, in place.
+
+    Args:
+        bqm (:class:`.BinaryQuadraticModel`):
+            A binary quadratic model with float64 biases.
+
+        scalar (number):
+            The value the biases are multiplied by.
+
+        ignore_offset (bool, optional, default=False):
+            If True, the offset is not scaled.
+    """
+    cdef cyBQM_float64 cybqm = _as_cybqm(bqm)
+    cdef double cppscalar = scalar
+    cdef bint scale_offset = not ignore_offset
+    with nogil:
+        scaleBiases[double, int32_t](deref(cybqm.cppbqm), cppscalar, scale_offset, NULL)
+
+
+def clip_wrapper(bqm, lower_bound=None, upper_bound=None):
+    """Cython wrapper for clipBiases().
+
+    Clip the linear and quadratic biases of ``bqm``, in place.
+
+    Args:
+        bqm (:class:`.BinaryQuadraticModel`):
+            A binary quadratic model with float64 biases.
+
+        lower_bound (number, optional):
+            The value biases below are set to. No lower bound if not given.
+
+        upper_bound (number, optional):
+            The value biases above are set to. No upper bound if not given.
+    """
+    cdef cyBQM_float64 cybqm = _as_cybqm(bqm)
+    cdef double lb = -INFINITY if lower_bound is None else lower_bound
+    cdef double ub = INFINITY if upper_bound is None else upper_bound
+
+    # the statistics let clipBiases() return without writing anything when
+    # all the biases are in bounds
+    cdef BiasStatistics[double] stats
+    with nogil:
+        stats = biasStatistics[double, int32_t](deref(cybqm.cppbqm))
+        clipBiases[double, int32_t](deref(cybqm.cppbqm), lb, ub, &stats)
@@ -17,6 +17,7 @@
 
 from cython.operator cimport dereference as deref
 
+from libc.stdint cimport int32_t
 from libcpp.utility cimport pair
 from libcpp.vector cimport vector
 
@@ -26,12 +27,45 @@ import numpy as np
 from dimod.libcpp cimport BinaryQuadraticModel as cppBinaryQuadraticModel
 from dimod.binary.cybqm cimport cyBQM_float64
 
+# The type of cyBQM_float64.cppbqm
+ctypedef cppBinaryQuadraticModel[double, int32_t] cppBQM_float64
 
-cdef extern from "include/dwave-preprocessing/fix_variables.hpp" namespace "fix_variables_":
+
+cdef extern from "include/dwave-preprocessing/fix_variables.hpp" namespace "fix_variables_" nogil:
     pair[double, vector[pair[int, int]]] fixQuboVariables[V, B](cppBinaryQuadraticModel[B, V]& refBQM,
                                                                 bint strict, 
                                                                 double offset) except +
 
+    vector[pair[double, vector[pair[int, int]]]] fixQuboVariablesBatch[V, B](
+        const vector[cppBinaryQuadraticModel[B, V]*]& bqms,
+        bint strict,
+        const vector[double]& offsets,
+        int num_threads) except +
+
+
+cdef extern from "include/dwave-preprocessing/connected_components.hpp" nogil:
+    cdef cppclass BQMComponent[B, V]:
+        vector[V] variables
+        vector[B] linear
+        vector[V] irow
+        vector[V] icol
+        vector[B] quadratic
+
+    vector[BQMComponent[B, V]] connectedComponents[B, V](
+        const cppBinaryQuadraticModel[B, V]& bqm,
+        int num_threads) except +
+
+
+def _as_binary_bqm(bqm):
+    bqm = dimod.as_bqm(bqm, dtype=np.float64)
+
+    if bqm.vartype is not dimod.BINARY:
+        raise ValueError("bqm must be BINARY")
+    if not all(v in bqm.linear for v in range(len(bqm))):
+        raise ValueError("bqm must be linearly indexed")
+
+    return bqm
+
 def fix_variables_wrapper(bqm, strict):
     """Cython wrapper for fix_variables().
 
@@ -46,13 +80,101 @@ def fix_variables_wrapper(bqm, strict):
             for which the assignments are true for some but not all minimizing 
             points (weak persistency).
     """
-    bqm = dimod.as_bqm(bqm, dtype=np.float64)
-
-    if bqm.vartype is not dimod.BINARY:
-        raise ValueError("bqm must be BINARY")
-    if not all(v in bqm.linear for v in range(len(bqm))):
-        raise ValueError("bqm must be linearly indexed")
+    bqm = _as_binary_bqm(bqm)
 
     cdef cyBQM_float64 cybqm = bqm.data
     lower_bound, fixed = fixQuboVariables(deref(cybqm.cppbqm), bool(strict), bqm.offset)
     return lower_bound, {int(v): int(val) for v, val in fixed}
+
+
+def fix_variables_batch_wrapper(bqms, strict, num_threads=1):
+    """Cython wrapper for fixQuboVariablesBatch().
+
+    The GIL is released while the variables are fixed.
+
+    Args:
+        bqms (list[:class:`.BinaryQuadraticModel`]):
+            Binary quadratic models with binary-valued variables, indexed
+            linearly from zero.
+
+        strict (bool):
+            See :func:`fix_variables_wrapper`.
+
+        num_threads (int, optional, default=1):
+            The number of threads the binary quadratic models are spread over.
+            Has no effect unless the package was built with OpenMP.
+
+    Returns:
+        list: A ``(lower_bound, fixed)`` 2-tuple for each binary quadratic
+        model, as returned by :func:`fix_variables_wrapper`.
+    """
+    # keep the references for as long as the C++ code uses the models
+    bqms = [_as_binary_bqm(bqm) for bqm in bqms]
+
+    if num_threads < 1:
+        raise ValueError("num_threads must be positive")
+
+    cdef vector[cppBQM_float64*] cppbqms
+    cdef vector[double] offsets
+    cdef cyBQM_float64 cybqm
+    for bqm in bqms:
+        cybqm = bqm.data
+        cppbqms.push_back(cybqm.cppbqm)
+        offsets.push_back(bqm.offset)
+
+    cdef bint cppstrict = strict
+    cdef int cppnum_threads = num_threads
+    cdef vector[pair[double, vector[pair[int, int]]]] results
+    with nogil:
+        results = fixQuboVariablesBatch[int32_t, double](cppbqms, cppstrict, offsets, cppnum_threads)
+
+    return [(results[i].first, {int(v): int(val) for v, val in results[i].second})
+            for i in range(results.size())]
+
+
+def connected_components_wrapper(bqm, num_threads=1):
+    """Cython wrapper for connectedComponents().
+
+    The GIL is released while the components are found.
+
+    Args:
+        bqm (:class:`.BinaryQuadraticModel`):
+            A binary quadratic model, with any vartype and labels.
+
+        num_threads (int, optional, default=1):
+            The number of threads used to find and extract the components.
+            Has no effect unless the package was built with OpenMP.
+
+    Returns:
+        list[:class:`.BinaryQuadraticModel`]: A binary quadratic model for each
+        connected component of ``bqm``, with the labels and vartype of ``bqm``,
+        ordered by the first of their variables in ``bqm``. The offset of
+        ``bqm`` is not included in any of them.
+    """
+    bqm = dimod.as_bqm(bqm, dtype=np.float64)
+
+    if num_threads < 1:
+        raise ValueError("num_threads must be positive")
+
+    labels = bqm.variables
+    if not all(v == i for i, v in enumerate(labels)):
+        # the labels are kept, only the copy is relabelled
+        bqm, _ = bqm.relabel_variables_as_integers(inplace=False)
+
+    cdef cyBQM_float64 cybqm = bqm.data
+    cdef int cppnum_threads = num_threads
+    cdef vector[BQMComponent[double, int32_t]] components
+    with nogil:
+        components = connectedComponents[double, int32_t](deref(cybqm.cppbqm), cppnum_threads)
+
+    subbqms = []
+    for i in range(components.size()):
+        subbqms.append(dimod.BinaryQuadraticModel.from_numpy_vectors(
+            np.asarray(components[i].linear, dtype=np.float64),
+            (np.asarray(components[i].irow, dtype=np.int32),
+             np.asarray(components[i].icol, dtype=np.int32),
+             np.asarray(components[i].quadratic, dtype=np.float64)),
+            0,
+            bqm.vartype,
+            variable_order=[labels[v] for v in components[i].variables]))
+    return subbqms
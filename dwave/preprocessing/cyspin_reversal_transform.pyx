@@ -0,0 +1,189 @@
+# distutils: language = c++
+# cython: language_level=3
+#
+# Copyright 2023 D-Wave Systems Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from cython.operator cimport dereference as deref
+
+from libc.stddef cimport ptrdiff_t
+from libc.stdint cimport int8_t, int32_t
+
+import dimod
+import numpy as np
+
+from dimod.libcpp cimport BinaryQuadraticModel as cppBinaryQuadraticModel
+from dimod.binary.cybqm cimport cyBQM_float64
+
+
+cdef extern from "dimod/vartypes.h" namespace "dimod" nogil:
+    enum cppVartype "dimod::Vartype":
+        cppBINARY "dimod::Vartype::BINARY"
+        cppSPIN "dimod::Vartype::SPIN"
+
+
+cdef extern from "include/dwave-preprocessing/spin_reversal_transform.hpp" nogil:
+    void spinReversalTransformBatch[B, V](
+        const cppBinaryQuadraticModel[B, V]& bqm,
+        const int8_t* flips,
+        ptrdiff_t num_transforms,
+        B* linear,
+        B* quadratic,
+        B* offsets,
+        V* irow,
+        V* icol,
+        int num_threads) except +
+
+    void spinReversalUnflipBatch[T](
+        T* samples,
+        const ptrdiff_t* num_samples,
+        ptrdiff_t num_variables,
+        const int8_t* flips,
+        ptrdiff_t num_transforms,
+        cppVartype vartype,
+        int num_threads) except +
+
+
+def spin_reversal_transform_batch_wrapper(bqm, flips, num_threads=1):
+    """Cython wrapper for spinReversalTransformBatch().
+
+    The GIL is released while the biases are transformed.
+
+    Args:
+        bqm (:class:`.BinaryQuadraticModel`):
+            A binary quadratic model with spin- or binary-valued variables.
+
+        flips (array-like):
+            A boolean array with one row per transform and one column per
+            variable of ``bqm``, in the order of ``bqm.variables``. The variables
+            flipped by each transform are those that are true in its row.
+
+        num_threads (int, optional, default=1):
+            The number of threads the transforms are spread over. Has no
+            effect unless the package was built with OpenMP.
+
+    Returns:
+        list[:class:`.BinaryQuadraticModel`]: The transformed binary quadratic
+        model for each row of ``flips``, with the labels of ``bqm``.
+    """
+    bqm = dimod.as_bqm(bqm, dtype=np.float64)
+
+    if bqm.vartype is not dimod.SPIN and bqm.vartype is not dimod.BINARY:
+        raise ValueError("bqm must be SPIN or BINARY")
+    if num_threads < 1:
+        raise ValueError("num_threads must be positive")
+
+    flips = np.ascontiguousarray(flips, dtype=np.int8)
+    if flips.ndim != 2 or flips.shape[1] != bqm.num_variables:
+        raise ValueError("flips must have one column per variable")
+    cdef int8_t[:, ::1] cyflips = flips
+
+    labels = bqm.variables
+    if not all(v == i for i, v in enumerate(labels)):
+        # the labels are kept, only the copy is relabelled
+        bqm, _ = bqm.relabel_variables_as_integers(inplace=False)
+
+    cdef ptrdiff_t num_transforms = cyflips.shape[0]
+    cdef ptrdiff_t num_variables = bqm.num_variables
+    cdef ptrdiff_t num_interactions = bqm.num_interactions
+
+    linear = np.empty((num_transforms, num_variables), dtype=np.float64)
+    quadratic = np.empty((num_transforms, num_interactions), dtype=np.float64)
+    offsets = np.empty(num_transforms, dtype=np.float64)
+    irow = np.empty(num_interactions, dtype=np.int32)
+    icol = np.empty(num_interactions, dtype=np.int32)
+
+    if not num_transforms:
+        return []
+
+    cdef double[:, ::1] cylinear = linear
+    cdef double[:, ::1] cyquadratic = quadratic
+    cdef double[::1] cyoffsets = offsets
+    cdef int32_t[::1] cyirow = irow
+    cdef int32_t[::1] cyicol = icol
+
+    cdef cyBQM_float64 cybqm = bqm.data
+    cdef int cppnum_threads = num_threads
+    with nogil:
+        spinReversalTransformBatch[double, int32_t](
+            deref(cybqm.cppbqm), &cyflips[0, 0] if num_variables else NULL, num_transforms,
+            &cylinear[0, 0] if num_variables else NULL,
+            &cyquadratic[0, 0] if num_interactions else NULL,
+            &cyoffsets[0],
+            &cyirow[0] if num_interactions else NULL,
+            &cyicol[0] if num_interactions else NULL,
+            cppnum_threads)
+
+    return [dimod.BinaryQuadraticModel.from_numpy_vectors(
+                linear[t], (irow, icol, quadratic[t]), offsets[t], bqm.vartype,
+                variable_order=labels)
+            for t in range(num_transforms)]
+
+
+def spin_reversal_unflip_batch_wrapper(samples, num_samples, flips, vartype, num_threads=1):
+    """Cython wrapper for spinReversalUnflipBatch().
+
+    The GIL is released while the samples are unflipped.
+
+    Args:
+        samples (:class:`numpy.ndarray`):
+            The samples of all the transforms, stacked, with one column per
+            variable. They are unflipped in place, so they must be a C-contiguous
+            array of type :class:`numpy.int8`.
+
+        num_samples (array-like):
+            The number of rows of ``samples`` that belong to each transform, in
+            order.
+
+        flips (array-like):
+            See :func:`spin_reversal_transform_batch_wrapper`, with one column
+            per column of ``samples``.
+
+        vartype (:class:`dimod.Vartype`):
+            The vartype of the samples.
+
+        num_threads (int, optional, default=1):
+            The number of threads the transforms are spread over. Has no
+            effect unless the package was built with OpenMP.
+    """
+    vartype = dimod.as_vartype(vartype)
+
+    if vartype is not dimod.SPIN and vartype is not dimod.BINARY:
+        raise ValueError("vartype must be SPIN or BINARY")
+    if num_threads < 1:
+        raise ValueError("num_threads must be positive")
+
+    cdef int8_t[:, ::1] cysamples = samples
+    cdef ptrdiff_t num_variables = cysamples.shape[1]
+
+    flips = np.ascontiguousarray(flips, dtype=np.int8)
+    if flips.ndim != 2 or flips.shape[1] != num_variables:
+        raise ValueError("flips must have one column per column of samples")
+    cdef int8_t[:, ::1] cyflips = flips
+    cdef ptrdiff_t[::1] cynum_samples = np.ascontiguousarray(num_samples, dtype=np.intp)
+
+    cdef ptrdiff_t num_transforms = cyflips.shape[0]
+    if cynum_samples.shape[0] != num_transforms:
+        raise ValueError("there must be one number of samples per transform")
+    if np.sum(num_samples) != cysamples.shape[0]:
+        raise ValueError("num_samples must add up to the number of samples")
+    if not cysamples.shape[0] or not num_variables:
+        return
+
+    cdef cppVartype cppvartype = cppBINARY if vartype is dimod.BINARY else cppSPIN
+    cdef int cppnum_threads = num_threads
+    with nogil:
+        spinReversalUnflipBatch[int8_t](
+            &cysamples[0, 0], &cynum_samples[0], num_variables, &cyflips[0, 0],
+            num_transforms, cppvartype, cppnum_threads)
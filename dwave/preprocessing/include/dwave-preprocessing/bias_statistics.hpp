@@ -0,0 +1,183 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BIAS_STATISTICS_HPP_INCLUDED
+#define BIAS_STATISTICS_HPP_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include "dimod/binary_quadratic_model.h"
+
+// The ranges of the linear and of the quadratic biases of a BQM, found in a
+// single pass so that scaling, clipping and the conversion ratio of
+// PosiformInfo don't each need to read the biases again. When there are no
+// biases of a kind, all their statistics are 0. The smallest absolute values
+// are those of the non-zero biases, 0 if there are none.
+template <class B> struct BiasStatistics {
+  std::size_t num_linear = 0;
+  B min_linear = 0;
+  B max_linear = 0;
+  B max_abs_linear = 0;
+  B min_abs_linear = 0;
+
+  std::size_t num_quadratic = 0;
+  B min_quadratic = 0;
+  B max_quadratic = 0;
+  B max_abs_quadratic = 0;
+  B min_abs_quadratic = 0;
+
+  // The largest absolute value of all the biases.
+  B maxAbsBias() const { return std::max(max_abs_linear, max_abs_quadratic); }
+
+  // The smallest absolute value of the non-zero biases, 0 if there are none.
+  B minAbsBias() const {
+    if (!min_abs_linear || !min_abs_quadratic) {
+      return std::max(min_abs_linear, min_abs_quadratic);
+    }
+    return std::min(min_abs_linear, min_abs_quadratic);
+  }
+
+  // The statistics after all the biases are multiplied by scalar.
+  void scale(B scalar) {
+    min_linear *= scalar;
+    max_linear *= scalar;
+    min_quadratic *= scalar;
+    max_quadratic *= scalar;
+    if (scalar < 0) {
+      std::swap(min_linear, max_linear);
+      std::swap(min_quadratic, max_quadratic);
+    }
+    B abs_scalar = std::fabs(scalar);
+    max_abs_linear *= abs_scalar;
+    min_abs_linear *= abs_scalar;
+    max_abs_quadratic *= abs_scalar;
+    min_abs_quadratic *= abs_scalar;
+  }
+};
+
+namespace bias_statistics_ {
+
+// Fold a bias into the running min, max, max abs and min non-zero abs. The
+// comparisons are written as selects so that they don't branch.
+template <class B>
+inline void accumulate(B bias, B &min, B &max, B &max_abs, B &min_abs) {
+  B abs = std::fabs(bias);
+  min = (bias < min) ? bias : min;
+  max = (bias > max) ? bias : max;
+  max_abs = (abs > max_abs) ? abs : max_abs;
+  min_abs = (abs && (!min_abs || abs < min_abs)) ? abs : min_abs;
+}
+
+} // namespace bias_statistics_
+
+// Compute the BiasStatistics of a BQM, reading each linear bias and each
+// quadratic bias once.
+template <class B, class V>
+BiasStatistics<B>
+biasStatistics(const dimod::BinaryQuadraticModel<B, V> &bqm) {
+  BiasStatistics<B> stats;
+  std::ptrdiff_t num_variables = bqm.num_variables();
+  if (!num_variables) {
+    return stats;
+  }
+
+  stats.num_linear = num_variables;
+  stats.min_linear = stats.max_linear = bqm.linear(0);
+  bool has_quadratic = false;
+  for (std::ptrdiff_t u = 0; u < num_variables; u++) {
+    bias_statistics_::accumulate(bqm.linear(u), stats.min_linear,
+                                 stats.max_linear, stats.max_abs_linear,
+                                 stats.min_abs_linear);
+
+    auto it = std::lower_bound(bqm.cbegin_neighborhood(u),
+                               bqm.cend_neighborhood(u), u + 1);
+    auto end = bqm.cend_neighborhood(u);
+    if (it != end && !has_quadratic) {
+      stats.min_quadratic = stats.max_quadratic = it->bias;
+      has_quadratic = true;
+    }
+    stats.num_quadratic += end - it;
+    for (; it != end; it++) {
+      bias_statistics_::accumulate(it->bias, stats.min_quadratic,
+                                   stats.max_quadratic, stats.max_abs_quadratic,
+                                   stats.min_abs_quadratic);
+    }
+  }
+  return stats;
+}
+
+// Multiply the biases of a BQM by scalar, in place, and update its statistics
+// if given. The offset is scaled too unless scale_offset is false.
+template <class B, class V>
+void scaleBiases(dimod::BinaryQuadraticModel<B, V> &bqm, B scalar,
+                 bool scale_offset = true,
+                 BiasStatistics<B> *stats = nullptr) {
+  B offset = bqm.offset();
+  bqm.scale(scalar);
+  if (!scale_offset) {
+    bqm.set_offset(offset);
+  }
+  if (stats) {
+    stats->scale(scalar);
+  }
+}
+
+// Clip the linear and quadratic biases of a BQM to [lower_bound, upper_bound],
+// in place. The statistics, if given, are used to skip the BQM entirely when
+// no bias is out of the bounds and are recomputed otherwise.
+template <class B, class V>
+void clipBiases(dimod::BinaryQuadraticModel<B, V> &bqm, B lower_bound,
+                B upper_bound, BiasStatistics<B> *stats = nullptr) {
+  if (stats &&
+      (!stats->num_linear || (stats->min_linear >= lower_bound &&
+                              stats->max_linear <= upper_bound)) &&
+      (!stats->num_quadratic || (stats->min_quadratic >= lower_bound &&
+                                 stats->max_quadratic <= upper_bound))) {
+    return;
+  }
+
+  auto clip = [&](B bias) {
+    return std::min(std::max(bias, lower_bound), upper_bound);
+  };
+
+  // The interactions are changed after reading them all, since setting a
+  // quadratic bias writes to the neighbourhoods of both its variables.
+  std::vector<std::tuple<V, V, B>> clipped;
+  std::ptrdiff_t num_variables = bqm.num_variables();
+  for (std::ptrdiff_t u = 0; u < num_variables; u++) {
+    B linear = bqm.linear(u);
+    if (clip(linear) != linear) {
+      bqm.set_linear(u, clip(linear));
+    }
+    auto end = bqm.cend_neighborhood(u);
+    for (auto it = bqm.cbegin_neighborhood(u); it != end; it++) {
+      if (it->v > u && clip(it->bias) != it->bias) {
+        clipped.emplace_back(u, it->v, clip(it->bias));
+      }
+    }
+  }
+  for (auto &[u, v, bias] : clipped) {
+    bqm.set_quadratic(u, v, bias);
+  }
+
+  if (stats) {
+    *stats = biasStatistics(bqm);
+  }
+}
+
+#endif // BIAS_STATISTICS_HPP_INCLUDED
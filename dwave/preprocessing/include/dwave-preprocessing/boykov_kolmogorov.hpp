@@ -0,0 +1,345 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BOYKOV_KOLMOGOROV_HPP_INCLUDED
+#define BOYKOV_KOLMOGOROV_HPP_INCLUDED
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "helper_data_structures.hpp"
+
+// Maximum flow solver based on the augmenting path algorithm of Boykov, Y.,
+// Kolmogorov, V. An Experimental Comparison of Min-Cut/Max-Flow Algorithms for
+// Energy Minimization in Vision. IEEE Transactions on Pattern Analysis and
+// Machine Intelligence 26, 1124-1137 (2004).
+// https://doi.org/10.1109/TPAMI.2004.60.
+//
+// Two search trees are grown, one from the source along edges with residual
+// capacity and one from the sink along reverse edges with residual capacity.
+// When they touch, flow is augmented along the path found, and the vertices cut
+// off from their tree by edges that got saturated are adopted by other vertices
+// of the same tree or freed. The trees are reused between augmentations, which
+// makes it much faster than push-relabel on graphs with short paths from the
+// source to the sink, such as those built from sparse, lattice like BQMs.
+//
+// Every vertex keeps a pointer to the edge in its own out edges that goes to
+// its parent, so the residual capacity towards the parent can be read from the
+// edge itself, see ImplicationEdge::getReverseEdgeResidual. The result is always
+// a flow rather than a preflow. A valid flow already in the residuals is
+// increased to a maximum flow.
+template <class EdgeType> class BoykovKolmogorovSolver {
+public:
+  using edge_iterator = typename compressed_adjacency_list<EdgeType>::iterator;
+  using capacity_t = typename EdgeType::capacity_type;
+
+  // The buffers of the solver, see PushRelabelSolver::workspace_t.
+  struct workspace_t {
+    std::vector<int> timestamps;
+    std::vector<int> distances;
+    std::vector<int> trees;
+    std::vector<EdgeType *> parents;
+    std::vector<int> is_active;
+    std::deque<int> active_vertices;
+    std::deque<int> orphans;
+  };
+
+  BoykovKolmogorovSolver(compressed_adjacency_list<EdgeType> &adjacency_list,
+                         int source, int sink, workspace_t *workspace = nullptr);
+
+  // There are no self loops in the trees, so handle_self_loops is only there to
+  // match the interface of PushRelabelSolver.
+  capacity_t computeMaximumFlow(bool handle_self_loops = false);
+
+private:
+  enum TREE { FREE, SOURCE_TREE, SINK_TREE };
+
+  // Grow the trees from the active vertices.
+  // @returns the edge, going from the source tree to the sink tree, where the
+  // trees touch or nullptr if they can't be grown any further.
+  EdgeType *grow();
+
+  // Augment the flow along the path through edge and orphan the vertices whose
+  // edges to their parents got saturated.
+  capacity_t augment(EdgeType *edge);
+
+  // Find new parents for the orphans, or free them.
+  void adopt();
+
+  void processOrphan(int vertex);
+
+  inline EdgeType &reverseEdge(EdgeType *edge) {
+    return _adjacency_list[edge->to_vertex][edge->reverse_edge_index];
+  }
+
+  // The residual capacity, in the direction of the flow from the source to the
+  // sink, of the edge from a vertex to its parent in the given tree.
+  inline capacity_t treeResidual(EdgeType *parent_edge, int tree) {
+    return (tree == SOURCE_TREE) ? parent_edge->getReverseEdgeResidual()
+                                 : parent_edge->residual;
+  }
+
+  void activate(int vertex) {
+    if (!_is_active[vertex]) {
+      _is_active[vertex] = true;
+      _active_vertices.push_back(vertex);
+    }
+  }
+
+  int _source;
+  int _sink;
+  int _num_vertices;
+
+  // The buffers below are those of the given workspace, or of _owned_workspace.
+  workspace_t _owned_workspace;
+  workspace_t &_workspace;
+
+  // Timestamps and distances from the roots, used to find the closest new
+  // parent for an orphan without walking the same paths again.
+  int _time;
+  std::vector<int> &_timestamps;
+  std::vector<int> &_distances;
+
+  std::vector<int> &_trees;
+  std::vector<EdgeType *> &_parents;
+  std::vector<int> &_is_active;
+
+  // A vertex can become active, or an orphan, many times so the queues can't
+  // be preallocated like vector_based_queue.
+  std::deque<int> &_active_vertices;
+  std::deque<int> &_orphans;
+
+  compressed_adjacency_list<EdgeType> &_adjacency_list;
+};
+
+template <class EdgeType>
+BoykovKolmogorovSolver<EdgeType>::BoykovKolmogorovSolver(
+    compressed_adjacency_list<EdgeType> &adjacency_list, int source, int sink,
+    workspace_t *workspace)
+    : _source(source), _sink(sink),
+      _workspace(workspace ? *workspace : _owned_workspace),
+      _timestamps(_workspace.timestamps), _distances(_workspace.distances),
+      _trees(_workspace.trees), _parents(_workspace.parents),
+      _is_active(_workspace.is_active),
+      _active_vertices(_workspace.active_vertices),
+      _orphans(_workspace.orphans), _adjacency_list(adjacency_list) {
+  _num_vertices = _adjacency_list.size();
+  _time = 0;
+  _timestamps.assign(_num_vertices, 0);
+  _distances.assign(_num_vertices, 0);
+  _trees.assign(_num_vertices, FREE);
+  _parents.assign(_num_vertices, nullptr);
+  _is_active.assign(_num_vertices, false);
+  _active_vertices.clear();
+  _orphans.clear();
+}
+
+template <class EdgeType> EdgeType *BoykovKolmogorovSolver<EdgeType>::grow() {
+  while (!_active_vertices.empty()) {
+    // We do not pop the vertex until all its edges have been looked at, since
+    // the next call may need to continue growing from it.
+    int vertex = _active_vertices.front();
+    int tree = _trees[vertex];
+    if (tree != FREE) {
+      auto out_edges = _adjacency_list[vertex];
+      for (auto eit = out_edges.begin(); eit != out_edges.end(); eit++) {
+        // Edges with residual capacity away from the source tree, or towards
+        // the sink tree.
+        capacity_t residual = (tree == SOURCE_TREE)
+                                  ? eit->residual
+                                  : eit->getReverseEdgeResidual();
+        if (!residual) {
+          continue;
+        }
+        int to_vertex = eit->to_vertex;
+        if (_trees[to_vertex] == FREE) {
+          _trees[to_vertex] = tree;
+          _parents[to_vertex] = &reverseEdge(&*eit);
+          _timestamps[to_vertex] = _timestamps[vertex];
+          _distances[to_vertex] = _distances[vertex] + 1;
+          activate(to_vertex);
+        } else if (_trees[to_vertex] != tree) {
+          return (tree == SOURCE_TREE) ? &*eit : &reverseEdge(&*eit);
+        }
+      }
+    }
+    _active_vertices.pop_front();
+    _is_active[vertex] = false;
+  }
+  return nullptr;
+}
+
+template <class EdgeType>
+typename EdgeType::capacity_type
+BoykovKolmogorovSolver<EdgeType>::augment(EdgeType *edge) {
+  int from_vertex = reverseEdge(edge).to_vertex;
+
+  // Find the bottleneck.
+  capacity_t flow = edge->residual;
+  for (int vertex = from_vertex; vertex != _source;
+       vertex = _parents[vertex]->to_vertex) {
+    flow = std::min(flow, _parents[vertex]->getReverseEdgeResidual());
+  }
+  for (int vertex = edge->to_vertex; vertex != _sink;
+       vertex = _parents[vertex]->to_vertex) {
+    flow = std::min(flow, _parents[vertex]->residual);
+  }
+
+  edge->residual -= flow;
+  reverseEdge(edge).residual += flow;
+
+  // In the source tree the flow goes from the parent to the vertex.
+  for (int vertex = from_vertex; vertex != _source;) {
+    EdgeType *parent_edge = _parents[vertex];
+    int parent = parent_edge->to_vertex;
+    parent_edge->residual += flow;
+    reverseEdge(parent_edge).residual -= flow;
+    if (!parent_edge->getReverseEdgeResidual()) {
+      _parents[vertex] = nullptr;
+      _orphans.push_back(vertex);
+    }
+    vertex = parent;
+  }
+
+  // In the sink tree the flow goes from the vertex to the parent.
+  for (int vertex = edge->to_vertex; vertex != _sink;) {
+    EdgeType *parent_edge = _parents[vertex];
+    int parent = parent_edge->to_vertex;
+    parent_edge->residual -= flow;
+    reverseEdge(parent_edge).residual += flow;
+    if (!parent_edge->residual) {
+      _parents[vertex] = nullptr;
+      _orphans.push_back(vertex);
+    }
+    vertex = parent;
+  }
+  return flow;
+}
+
+template <class EdgeType>
+void BoykovKolmogorovSolver<EdgeType>::processOrphan(int vertex) {
+  const int UNREACHABLE = std::numeric_limits<int>::max();
+  int tree = _trees[vertex];
+  auto out_edges = _adjacency_list[vertex];
+
+  // Look for the neighbour in the same tree, connected by an edge with residual
+  // capacity, that is closest to the root.
+  EdgeType *best_parent_edge = nullptr;
+  int best_distance = UNREACHABLE;
+  for (auto eit = out_edges.begin(); eit != out_edges.end(); eit++) {
+    int to_vertex = eit->to_vertex;
+    if (_trees[to_vertex] != tree || !treeResidual(&*eit, tree)) {
+      continue;
+    }
+
+    // Check that the neighbour is still connected to the root, the roots
+    // always have the current timestamp.
+    int distance = 0;
+    int ancestor = to_vertex;
+    while (true) {
+      if (_timestamps[ancestor] == _time) {
+        distance += _distances[ancestor];
+        break;
+      }
+      if (!_parents[ancestor]) {
+        distance = UNREACHABLE;
+        break;
+      }
+      distance++;
+      ancestor = _parents[ancestor]->to_vertex;
+    }
+    if (distance == UNREACHABLE) {
+      continue;
+    }
+
+    if (distance < best_distance) {
+      best_parent_edge = &*eit;
+      best_distance = distance;
+    }
+
+    // Mark the path so the next search can stop early.
+    for (ancestor = to_vertex; _timestamps[ancestor] != _time;
+         ancestor = _parents[ancestor]->to_vertex) {
+      _timestamps[ancestor] = _time;
+      _distances[ancestor] = distance--;
+    }
+  }
+
+  if (best_parent_edge) {
+    _parents[vertex] = best_parent_edge;
+    _timestamps[vertex] = _time;
+    _distances[vertex] = best_distance + 1;
+    return;
+  }
+
+  // No parent was found, so the vertex is freed. Its neighbours in the same tree
+  // that could have adopted it become active and its children become orphans.
+  for (auto eit = out_edges.begin(); eit != out_edges.end(); eit++) {
+    int to_vertex = eit->to_vertex;
+    if (_trees[to_vertex] != tree) {
+      continue;
+    }
+    if (treeResidual(&*eit, tree)) {
+      activate(to_vertex);
+    }
+    EdgeType *parent_edge = _parents[to_vertex];
+    if (parent_edge && parent_edge->to_vertex == vertex) {
+      _parents[to_vertex] = nullptr;
+      _orphans.push_back(to_vertex);
+    }
+  }
+  _trees[vertex] = FREE;
+}
+
+template <class EdgeType> void BoykovKolmogorovSolver<EdgeType>::adopt() {
+  while (!_orphans.empty()) {
+    int vertex = _orphans.front();
+    _orphans.pop_front();
+    processOrphan(vertex);
+  }
+}
+
+template <class EdgeType>
+typename EdgeType::capacity_type
+BoykovKolmogorovSolver<EdgeType>::computeMaximumFlow(
+    [[maybe_unused]] bool handle_self_loops) {
+  _trees[_source] = SOURCE_TREE;
+  _trees[_sink] = SINK_TREE;
+  activate(_source);
+  activate(_sink);
+
+  capacity_t maximum_flow = 0;
+  for (auto &edge : _adjacency_list[_sink]) {
+    maximum_flow -= edge.getFlow();
+  }
+
+  while (true) {
+    EdgeType *edge = grow();
+    if (!edge) {
+      break;
+    }
+
+    _time++;
+    _timestamps[_source] = _timestamps[_sink] = _time;
+    _distances[_source] = _distances[_sink] = 0;
+
+    maximum_flow += augment(edge);
+    adopt();
+  }
+  return maximum_flow;
+}
+
+#endif // BOYKOV_KOLMOGOROV_HPP_INCLUDED
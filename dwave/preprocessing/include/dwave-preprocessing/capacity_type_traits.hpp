@@ -0,0 +1,52 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CAPACITY_TYPE_TRAITS_HPP_INCLUDED
+#define CAPACITY_TYPE_TRAITS_HPP_INCLUDED
+
+#include <limits>
+#include <type_traits>
+
+// The capacities of the implication network and the coefficients of the
+// posiform must be signed integral types. __int128 is one too, where the
+// compiler supports it, but the standard type traits only say so in the GNU
+// dialects of C++.
+template <class T>
+struct is_signed_integral
+    : std::integral_constant<bool, std::is_integral<T>::value &&
+                                       std::is_signed<T>::value> {};
+
+#ifdef __SIZEOF_INT128__
+template <> struct is_signed_integral<__int128> : std::true_type {};
+
+static_assert(std::numeric_limits<__int128>::is_specialized,
+              "std::numeric_limits must support __int128.");
+#endif
+
+// The absolute value of a capacity, std::llabs would truncate wider types.
+template <class T> inline T absoluteCapacity(T value) {
+  return (value < 0) ? -value : value;
+}
+
+// There is no stream operator for __int128, so capacities wider than long long
+// are printed as doubles.
+template <class T> inline auto printableCapacity(T value) {
+  if constexpr (sizeof(T) > sizeof(long long)) {
+    return static_cast<double>(value);
+  } else {
+    return value;
+  }
+}
+
+#endif // CAPACITY_TYPE_TRAITS_HPP_INCLUDED
@@ -0,0 +1,176 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CONNECTED_COMPONENTS_HPP_INCLUDED
+#define CONNECTED_COMPONENTS_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "dimod/binary_quadratic_model.h"
+
+// A disjoint-set forest that many threads can merge sets of at the same time.
+// Each root is linked under the smaller of the two roots being merged, with a
+// compare and swap that only succeeds if it is still a root, so the root of a
+// set is always its smallest element and the result does not depend on the
+// order of the merges. Finds use path halving.
+class ConcurrentDisjointSets {
+public:
+  explicit ConcurrentDisjointSets(int size) : _parents(size) {
+    for (int i = 0; i < size; i++) {
+      _parents[i].store(i, std::memory_order_relaxed);
+    }
+  }
+
+  int find(int element) {
+    while (true) {
+      int parent = _parents[element].load(std::memory_order_relaxed);
+      if (parent == element) {
+        return element;
+      }
+      int grandparent = _parents[parent].load(std::memory_order_relaxed);
+      if (grandparent != parent) {
+        // Any ancestor is a valid parent, failing just skips the shortcut.
+        _parents[element].compare_exchange_weak(parent, grandparent,
+                                                std::memory_order_relaxed);
+      }
+      element = grandparent;
+    }
+  }
+
+  void merge(int a, int b) {
+    while (true) {
+      a = find(a);
+      b = find(b);
+      if (a == b) {
+        return;
+      }
+      if (a > b) {
+        std::swap(a, b);
+      }
+      int expected = b;
+      if (_parents[b].compare_exchange_strong(expected, a,
+                                              std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+private:
+  std::vector<std::atomic<int>> _parents;
+};
+
+// A connected component of a BQM, as a BQM of its own over the variables
+// 0, ..., variables.size() - 1. The interactions are given in coordinate
+// format, sorted, with irow[i] < icol[i].
+template <class B, class V> struct BQMComponent {
+  // The variable of the original BQM for each variable of the component.
+  // They are in increasing order.
+  std::vector<V> variables;
+  std::vector<B> linear;
+  std::vector<V> irow;
+  std::vector<V> icol;
+  std::vector<B> quadratic;
+
+  // Build the component as a BinaryQuadraticModel, e.g. to pass the components
+  // to fix_variables_::fixQuboVariablesBatch().
+  dimod::BinaryQuadraticModel<B, V> toBQM(dimod::Vartype vartype) const {
+    dimod::BinaryQuadraticModel<B, V> bqm(variables.size(), vartype);
+    for (std::size_t i = 0; i < linear.size(); i++) {
+      bqm.set_linear(i, linear[i]);
+    }
+    for (std::size_t i = 0; i < quadratic.size(); i++) {
+      bqm.add_quadratic(irow[i], icol[i], quadratic[i]);
+    }
+    return bqm;
+  }
+};
+
+// Find the connected components of a BQM and extract each one as its own BQM,
+// see BQMComponent. The interactions are merged by a union-find over the
+// variables, run in parallel, after which each component is filled in by a
+// single thread. The components are ordered by their smallest variable. The
+// offset of the BQM is not carried over to any of the components.
+// @param num_threads : the number of threads to use. Has no effect unless
+// compiled with OpenMP.
+template <class B, class V>
+std::vector<BQMComponent<B, V>>
+connectedComponents(const dimod::BinaryQuadraticModel<B, V> &bqm,
+                    int num_threads = 1) {
+  if (num_threads < 1) {
+    throw std::invalid_argument("num_threads must be positive");
+  }
+
+  std::ptrdiff_t num_variables = bqm.num_variables();
+  ConcurrentDisjointSets sets(num_variables);
+
+#pragma omp parallel for schedule(dynamic, 64) num_threads(num_threads)
+  for (std::ptrdiff_t u = 0; u < num_variables; u++) {
+    auto end = bqm.cend_neighborhood(u);
+    for (auto it = bqm.cbegin_neighborhood(u); it != end; it++) {
+      if (it->v > u) {
+        sets.merge(u, it->v);
+      }
+    }
+  }
+
+  // The roots are the smallest variable of their component, so numbering the
+  // components as their roots are found orders them by their smallest variable.
+  std::vector<int> component_of(num_variables);
+  std::vector<BQMComponent<B, V>> components;
+  for (std::ptrdiff_t u = 0; u < num_variables; u++) {
+    int root = sets.find(u);
+    if (root == u) {
+      component_of[u] = components.size();
+      components.emplace_back();
+    } else {
+      component_of[u] = component_of[root];
+    }
+    components[component_of[u]].variables.push_back(u);
+  }
+
+  // The variables of a component are in increasing order, so the position of a
+  // variable in it only needs to be looked up for the neighbours.
+  std::vector<V> local_index(num_variables);
+  for (auto &component : components) {
+    for (std::size_t i = 0; i < component.variables.size(); i++) {
+      local_index[component.variables[i]] = i;
+    }
+  }
+
+  std::ptrdiff_t num_components = components.size();
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+  for (std::ptrdiff_t c = 0; c < num_components; c++) {
+    auto &component = components[c];
+    component.linear.reserve(component.variables.size());
+    for (std::size_t i = 0; i < component.variables.size(); i++) {
+      V u = component.variables[i];
+      component.linear.push_back(bqm.linear(u));
+      auto end = bqm.cend_neighborhood(u);
+      for (auto it = bqm.cbegin_neighborhood(u); it != end; it++) {
+        if (it->v > u) {
+          component.irow.push_back(i);
+          component.icol.push_back(local_index[it->v]);
+          component.quadratic.push_back(it->bias);
+        }
+      }
+    }
+  }
+  return components;
+}
+
+#endif // CONNECTED_COMPONENTS_HPP_INCLUDED
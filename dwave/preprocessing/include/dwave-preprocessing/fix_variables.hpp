@@ -12,14 +12,72 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#ifndef FIX_VARIABLES_HPP_INCLUDED
+#define FIX_VARIABLES_HPP_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
 #include "dimod/binary_quadratic_model.h"
 #include "implication_network.hpp"
 #include "posiform_info.hpp"
+#include "streaming_posiform_info.hpp"
 
 namespace fix_variables_ {
 
+// The default capacity type of the implication network. A narrower type, e.g.
+// std::int32_t, can be passed as the capacity_t template argument of
+// fixQuboVariables() to shrink the implication network by more than a third.
+// The posiform coefficients are then scaled to the narrower range, so a bias is
+// flushed to zero if it is about 2^29 times smaller than the largest bias,
+// rather than about 2^61 times. It should only be used when the range of the
+// biases allows it.
 typedef long long int capacity_type;
 
+#ifdef __SIZEOF_INT128__
+// The capacity type used instead of capacity_type when the dynamic range of the
+// biases of a BQM is too large for it, see needsWideCapacity().
+typedef __int128 wide_capacity_type;
+#endif
+
+// The number of bits of precision the smallest non-zero bias should keep in the
+// posiform, the precision of a float.
+const int MIN_COEFFICIENT_PRECISION_BITS = 24;
+
+/**
+ * Whether the biases of the BQM a posiform was created from have too large a
+ * dynamic range for the coefficient type of the posiform, that is whether its
+ * smallest non-zero bias would keep less than MIN_COEFFICIENT_PRECISION_BITS
+ * bits of precision, or be flushed to zero.
+ */
+template <class PosiformInfo> bool needsWideCapacity(PosiformInfo &posiform_info) {
+  return posiform_info.getMinAbsoluteBias() *
+             posiform_info.getBiasConversionRatio() <
+         std::ldexp(1.0, MIN_COEFFICIENT_PRECISION_BITS);
+}
+
+/**
+ * Buffers that can be passed to many calls of fixQuboVariables(), so that the
+ * maximum flow solvers and the graph searches allocate them once rather than
+ * for every BQM, see ImplicationNetwork::workspace_t. They grow to the size of
+ * the largest BQM and are never freed. A workspace must not be used by two
+ * calls at the same time, e.g. each thread needs its own.
+ */
+template <class capacity_t = capacity_type> struct RoofDualityWorkspace {
+  typename ImplicationNetwork<capacity_t, true>::workspace_t network;
+#ifdef __SIZEOF_INT128__
+  // Used instead when the capacities are widened, see needsWideCapacity().
+  typename ImplicationNetwork<wide_capacity_type, true>::workspace_t
+      wide_network;
+#endif
+};
+
 class compClass {
 public:
   bool operator()(const std::pair<int, int> &a, const std::pair<int, int> &b) {
@@ -30,31 +88,13 @@ public:
   }
 };
 
-/**
- * Fixes the QUBO variables.
- *
- * @param posiform_info Object containing information needed to recreate a
- *      posiform corresponding to QUBO.
- * @param num_bqm_variables Number of variables in the original QUBO.
- * @param strict When true, only the variables corresponding to strong persistencies
- *      are fixed. When false, the function tries to fix all the variables
- *      corresponding to strong and weak persistencies. Also when false, variables 
- *      that do not contribute any coefficient to the posiform are set to 1. This
- *      may happen if their bias in the original QUBO was 0 or if they were flushed
- *      to zero when converted to the posiform.
- * @param fixed_variables Variables to fix.
- */
+// Convert the variables fixed in a posiform to the variables of the BQM it was
+// created from.
 template <class PosiformInfo>
-capacity_type fixQuboVariables(PosiformInfo &posiform_info, int num_bqm_variables,
-                      bool strict,
-                      std::vector<std::pair<int, int>> &fixed_variables) {
-  ImplicationNetwork<capacity_type> implication_network(posiform_info);
-  fixed_variables.reserve(num_bqm_variables);
-
-  // Fix the variables with respect to the posiform.
-  std::vector<std::pair<int, int>> fixed_variables_posiform;
-  capacity_type max_flow = implication_network.fixVariables(fixed_variables_posiform, strict);
-
+void convertFixedVariables(
+    PosiformInfo &posiform_info, int num_bqm_variables, bool strict,
+    const std::vector<std::pair<int, int>> &fixed_variables_posiform,
+    std::vector<std::pair<int, int>> &fixed_variables) {
   // There may not be 1 to 1 mapping from bqm variables to posiform variables,
   // so we convert the posiform variables back to bqm variables.
   for (std::size_t i = 0; i < fixed_variables_posiform.size(); i++) {
@@ -77,28 +117,65 @@ capacity_type fixQuboVariables(PosiformInfo &posiform_info, int num_bqm_variable
   }
 
   std::sort(fixed_variables.begin(), fixed_variables.end(), compClass());
-  return max_flow;
 }
 
 /**
- * Fixes the variables of an BinaryQuadraticModel.
+ * Fixes the QUBO variables.
  *
- * @param bqm BinaryQuadraticModel to find minimizing variable assignments for
+ * @param posiform_info Object containing information needed to recreate a
+ *      posiform corresponding to QUBO.
+ * @param num_bqm_variables Number of variables in the original QUBO.
  * @param strict When true, only the variables corresponding to strong persistencies
  *      are fixed. When false, the function tries to fix all the variables
  *      corresponding to strong and weak persistencies. Also when false, variables 
  *      that do not contribute any coefficient to the posiform are set to 1. This
  *      may happen if their bias in the original QUBO was 0 or if they were flushed
  *      to zero when converted to the posiform.
- * @param offset The bqm's offset, used to calculate the lower bound. Defaults to 0.
+ * @param fixed_variables Variables to fix.
+ * @param algorithm The maximum flow algorithm to use. The fixed variables do not
+ *      depend on it when strict, see MaxFlowAlgorithm.
+ * @param workspace Buffers to reuse, see RoofDualityWorkspace. Optional.
+ * @tparam capacity_t Capacity type of the implication network, must be able to
+ *      hold the coefficients of the posiform.
  */
-template <class V, class B>
+template <class PosiformInfo, class capacity_t = capacity_type>
+capacity_t fixQuboVariables(PosiformInfo &posiform_info, int num_bqm_variables,
+                      bool strict,
+                      std::vector<std::pair<int, int>> &fixed_variables,
+                      MaxFlowAlgorithm algorithm = MaxFlowAlgorithm::PUSH_RELABEL,
+                      typename ImplicationNetwork<capacity_t, true>::workspace_t
+                          *workspace = nullptr) {
+  // The edges do not need to know where they start from, so we use the compact
+  // layout.
+  ImplicationNetwork<capacity_t, true> implication_network(posiform_info);
+  fixed_variables.reserve(num_bqm_variables);
+
+  // Fix the variables with respect to the posiform.
+  std::vector<std::pair<int, int>> fixed_variables_posiform;
+  capacity_t max_flow = implication_network.fixVariables(
+      fixed_variables_posiform, strict, algorithm, workspace);
+
+  convertFixedVariables(posiform_info, num_bqm_variables, strict,
+                        fixed_variables_posiform, fixed_variables);
+  return max_flow;
+}
+
+/**
+ * Fixes the variables of a posiform and computes the lower bound of the BQM it
+ * was created from.
+ */
+template <class PosiformInfo>
 std::pair<double, std::vector<std::pair<int, int>>>
-fixQuboVariables(dimod::BinaryQuadraticModel<B, V> &bqm, bool strict, double offset=0.0) {
-  int num_bqm_variables = bqm.num_variables();
-  PosiformInfo<dimod::BinaryQuadraticModel<B, V>, capacity_type> posiform_info(bqm);
+fixPosiformVariables(
+    PosiformInfo &posiform_info, int num_bqm_variables, bool strict,
+    double offset, MaxFlowAlgorithm algorithm,
+    typename ImplicationNetwork<typename PosiformInfo::coefficient_type,
+                                true>::workspace_t *workspace = nullptr) {
+  using capacity_t = typename PosiformInfo::coefficient_type;
   std::vector<std::pair<int, int>> fixed_variables;
-  capacity_type max_flow = fixQuboVariables(posiform_info, num_bqm_variables, strict, fixed_variables);
+  capacity_t max_flow = fixQuboVariables<PosiformInfo, capacity_t>(
+      posiform_info, num_bqm_variables, strict, fixed_variables, algorithm,
+      workspace);
 
   // The max_flow added with the constant term of the posiform should be the lower 
   // bound of the posiform, which should be equal to the lower bound of the bqm. 
@@ -116,4 +193,404 @@ fixQuboVariables(dimod::BinaryQuadraticModel<B, V> &bqm, bool strict, double off
   return {lower_bound, fixed_variables};
 }
 
+/**
+ * Fixes the variables of an BinaryQuadraticModel.
+ *
+ * @param bqm BinaryQuadraticModel to find minimizing variable assignments for
+ * @param strict When true, only the variables corresponding to strong persistencies
+ *      are fixed. When false, the function tries to fix all the variables
+ *      corresponding to strong and weak persistencies. Also when false, variables 
+ *      that do not contribute any coefficient to the posiform are set to 1. This
+ *      may happen if their bias in the original QUBO was 0 or if they were flushed
+ *      to zero when converted to the posiform.
+ * @param offset The bqm's offset, used to calculate the lower bound. Defaults to 0.
+ * @param algorithm The maximum flow algorithm to use. Defaults to push-relabel,
+ *      MaxFlowAlgorithm::AUTOMATIC picks one based on the density of the BQM.
+ * @param workspace Buffers to reuse when fixing the variables of many BQMs, see
+ *      RoofDualityWorkspace. Optional.
+ * @tparam capacity_t Capacity type of the implication network and coefficient
+ *      type of the posiform, see capacity_type. With the default capacity_type,
+ *      wide_capacity_type is used instead when the dynamic range of the biases
+ *      needs it, see needsWideCapacity().
+ */
+template <class V, class B, class capacity_t = capacity_type>
+std::pair<double, std::vector<std::pair<int, int>>>
+fixQuboVariables(dimod::BinaryQuadraticModel<B, V> &bqm, bool strict, double offset=0.0,
+                 MaxFlowAlgorithm algorithm = MaxFlowAlgorithm::PUSH_RELABEL,
+                 RoofDualityWorkspace<capacity_t> *workspace = nullptr) {
+  using bqm_type = dimod::BinaryQuadraticModel<B, V>;
+  int num_bqm_variables = bqm.num_variables();
+  PosiformInfo<bqm_type, capacity_t> posiform_info(bqm);
+#ifdef __SIZEOF_INT128__
+  if constexpr (std::is_same<capacity_t, capacity_type>::value) {
+    if (needsWideCapacity(posiform_info)) {
+      PosiformInfo<bqm_type, wide_capacity_type> wide_posiform_info(bqm);
+      return fixPosiformVariables(wide_posiform_info, num_bqm_variables, strict,
+                                  offset, algorithm,
+                                  workspace ? &workspace->wide_network : nullptr);
+    }
+  }
+#endif
+  return fixPosiformVariables(posiform_info, num_bqm_variables, strict, offset,
+                              algorithm,
+                              workspace ? &workspace->network : nullptr);
+}
+
+/**
+ * Fixes the variables of many BinaryQuadraticModels concurrently, e.g. the
+ * connected components of a larger one.
+ *
+ * Each BQM is handled by a single thread. The largest BQMs are started first
+ * and the threads take the next BQM as soon as they are done, so the load stays
+ * balanced when the sizes vary. Each thread reuses one RoofDualityWorkspace for
+ * all of its BQMs.
+ *
+ * @param bqms The BinaryQuadraticModels, they are not copied.
+ * @param strict See fixQuboVariables().
+ * @param offsets The offsets of the BQMs, used to calculate the lower bounds.
+ *      Either empty, for no offsets, or one per BQM.
+ * @param num_threads The number of threads. Has no effect unless built with
+ *      OpenMP.
+ * @param algorithm The maximum flow algorithm to use, see fixQuboVariables().
+ * @returns The result of fixQuboVariables() for each BQM, in the same order.
+ * @tparam capacity_t See fixQuboVariables().
+ */
+template <class V, class B, class capacity_t = capacity_type>
+std::vector<std::pair<double, std::vector<std::pair<int, int>>>>
+fixQuboVariablesBatch(const std::vector<dimod::BinaryQuadraticModel<B, V> *> &bqms,
+                      bool strict, const std::vector<double> &offsets = {},
+                      int num_threads = 1,
+                      MaxFlowAlgorithm algorithm = MaxFlowAlgorithm::PUSH_RELABEL) {
+  if (!offsets.empty() && offsets.size() != bqms.size()) {
+    throw std::invalid_argument("there must be one offset per bqm");
+  }
+  if (num_threads < 1) {
+    throw std::invalid_argument("num_threads must be positive");
+  }
+
+  std::ptrdiff_t num_bqms = bqms.size();
+  std::vector<std::ptrdiff_t> order(num_bqms);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::ptrdiff_t a, std::ptrdiff_t b) {
+                     return bqms[a]->num_interactions() + bqms[a]->num_variables() >
+                            bqms[b]->num_interactions() + bqms[b]->num_variables();
+                   });
+
+  std::vector<std::pair<double, std::vector<std::pair<int, int>>>> results(num_bqms);
+
+  // Exceptions must not escape the parallel region, the first one is rethrown
+  // once all the threads are done.
+  std::exception_ptr error;
+#pragma omp parallel num_threads(num_threads)
+  {
+    RoofDualityWorkspace<capacity_t> workspace;
+#pragma omp for schedule(dynamic)
+    for (std::ptrdiff_t i = 0; i < num_bqms; i++) {
+      std::ptrdiff_t b = order[i];
+      try {
+        results[b] = fixQuboVariables<V, B, capacity_t>(
+            *bqms[b], strict, offsets.empty() ? 0.0 : offsets[b], algorithm,
+            &workspace);
+      } catch (...) {
+#pragma omp critical
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return results;
+}
+
+/**
+ * Fixes the variables of a BQM given as a stream of terms, see
+ * StreamingPosiformInfo, without holding the BQM in memory.
+ *
+ * @param stream The terms of the BQM, read three or five times.
+ * @param strict See fixQuboVariables().
+ * @param offset The bqm's offset, used to calculate the lower bound. Defaults to 0.
+ * @param algorithm The maximum flow algorithm to use, see fixQuboVariables().
+ * @tparam capacity_t Capacity type of the implication network and coefficient
+ *      type of the posiform, see fixQuboVariables().
+ */
+template <class TermStream, class capacity_t = capacity_type>
+std::pair<double, std::vector<std::pair<int, int>>>
+fixQuboVariablesFromStream(TermStream &stream, bool strict, double offset = 0.0,
+                           MaxFlowAlgorithm algorithm = MaxFlowAlgorithm::PUSH_RELABEL) {
+  int num_bqm_variables = stream.num_variables();
+  StreamingPosiformInfo<TermStream, capacity_t> posiform_info(stream);
+#ifdef __SIZEOF_INT128__
+  // The stream is read twice more in that case.
+  if constexpr (std::is_same<capacity_t, capacity_type>::value) {
+    if (needsWideCapacity(posiform_info)) {
+      StreamingPosiformInfo<TermStream, wide_capacity_type> wide_posiform_info(
+          stream);
+      return fixPosiformVariables(wide_posiform_info, num_bqm_variables, strict,
+                                  offset, algorithm);
+    }
+  }
+#endif
+  return fixPosiformVariables(posiform_info, num_bqm_variables, strict, offset,
+                              algorithm);
+}
+
+/**
+ * Fixes the variables of a sequence of BinaryQuadraticModels that differ by a
+ * few biases, e.g. in a parameter sweep.
+ *
+ * The posiform and the implication network are built once and the maximum flow
+ * is kept between calls to fixVariables(). When biases change, the capacities
+ * of the affected edges are updated, the flow above them is cancelled and the
+ * maximum flow solver continues from the repaired flow, so small changes cost
+ * much less than a new call to fixQuboVariables().
+ *
+ * The network is rebuilt instead when a change needs other edges: an
+ * interaction or a variable that was not in the posiform, a coefficient whose
+ * sign flips, or biases outside the range the posiform was scaled for, which
+ * leaves room for them to grow by a factor of HEADROOM. As long as it is not
+ * rebuilt, the biases keep the scale of the BQM the network was built from, so
+ * biases that become much smaller than the largest one then are flushed to
+ * zero.
+ *
+ * Because of the headroom, and because the scale is only chosen again on a
+ * rebuild, the capacities are rounded differently from those of
+ * fixQuboVariables(), which scales the current BQM without headroom. The lower
+ * bound agrees up to this rounding. In strict mode the fixed variables agree
+ * too unless two minimum cuts are within the rounding of each other, as they
+ * can be when there are ties, e.g. in BQMs with integer biases. The weak
+ * persistencies also depend on the maximum flow found, so in non-strict mode
+ * they may differ, but they are all valid.
+ *
+ * @tparam capacity_t Capacity type of the implication network and coefficient
+ *      type of the posiform, see capacity_type.
+ */
+template <class V, class B, class capacity_t = capacity_type>
+class IncrementalRoofDuality {
+public:
+  using bqm_type = dimod::BinaryQuadraticModel<B, V>;
+  using posiform_type = PosiformInfo<bqm_type, capacity_t>;
+  using network_type = ImplicationNetwork<capacity_t, true>;
+
+  /**
+   * Construct from a copy of a binary quadratic model.
+   *
+   * @param algorithm The maximum flow algorithm to use, see fixQuboVariables().
+   */
+  explicit IncrementalRoofDuality(
+      const bqm_type &bqm,
+      MaxFlowAlgorithm algorithm = MaxFlowAlgorithm::PUSH_RELABEL)
+      : _bqm(bqm), _algorithm(algorithm), _num_rebuilds(0) {
+    _is_changed.resize(_bqm.num_variables(), false);
+    rebuild();
+  }
+
+  // The posiform holds iterators into the BQM.
+  IncrementalRoofDuality(const IncrementalRoofDuality &) = delete;
+  IncrementalRoofDuality &operator=(const IncrementalRoofDuality &) = delete;
+
+  /**
+   * Add delta to the linear bias of variable v.
+   */
+  void addLinear(V v, B delta) {
+    _bqm.add_linear(v, delta);
+    markChanged(v);
+  }
+
+  /**
+   * Add delta to the quadratic bias of the interaction between u and v. Adding
+   * an interaction the BQM does not have rebuilds the network.
+   */
+  void addQuadratic(V u, V v, B delta) {
+    auto num_interactions = _bqm.num_interactions();
+    _bqm.add_quadratic(u, v, delta);
+    if (_bqm.num_interactions() != num_interactions) {
+      _needs_rebuild = true;
+    }
+    markChanged(u);
+    markChanged(v);
+    if (u != v) {
+      _changed_interactions.push_back({std::min(u, v), std::max(u, v)});
+    }
+  }
+
+  /**
+   * Fix the variables of the current BQM, see fixQuboVariables().
+   */
+  std::pair<double, std::vector<std::pair<int, int>>>
+  fixVariables(bool strict, double offset = 0.0) {
+    if (_needs_rebuild || !applyChanges()) {
+      rebuild();
+    }
+    clearChanges();
+
+    std::vector<std::pair<int, int>> fixed_variables_posiform;
+    capacity_t max_flow = _network->fixVariables(
+        fixed_variables_posiform, strict, _algorithm, &_workspace);
+    std::vector<std::pair<int, int>> fixed_variables;
+    fixed_variables.reserve(_bqm.num_variables());
+    convertFixedVariables(*_posiform, _bqm.num_variables(), strict,
+                          fixed_variables_posiform, fixed_variables);
+
+    // See fixQuboVariables().
+    double ratio = _posiform->getBiasConversionRatio();
+    double lower_bound =
+        (_constant / ratio) + ((double)max_flow / (ratio * 2)) + offset;
+    return {lower_bound, fixed_variables};
+  }
+
+  /**
+   * Return the current BQM.
+   */
+  const bqm_type &getBQM() const { return _bqm; }
+
+  /**
+   * Return the number of times the network was built, including when the
+   * object was constructed.
+   */
+  std::size_t getNumRebuilds() const { return _num_rebuilds; }
+
+private:
+  void markChanged(V v) {
+    if (!_is_changed[v]) {
+      _is_changed[v] = true;
+      _changed_variables.push_back(v);
+    }
+  }
+
+  void clearChanges() {
+    for (V v : _changed_variables) {
+      _is_changed[v] = false;
+    }
+    _changed_variables.clear();
+    _changed_interactions.clear();
+    _needs_rebuild = false;
+  }
+
+  void rebuild() {
+    _posiform = std::make_unique<posiform_type>(_bqm, HEADROOM);
+    _network = std::make_unique<network_type>(*_posiform, true);
+    int num_posiform_variables = _posiform->getNumVariables();
+    _linear.resize(num_posiform_variables);
+    _linear_sum = 0;
+    for (int variable = 0; variable < num_posiform_variables; variable++) {
+      _linear[variable] = _posiform->getLinear(variable);
+      _linear_sum += std::fabs(static_cast<double>(_linear[variable]));
+    }
+    _constant = _posiform->getConstant();
+    _num_rebuilds++;
+  }
+
+  // Convert a bias to a posiform coefficient if it is in the range the
+  // posiform was scaled for, see PosiformInfo.
+  bool convert(double bias, capacity_t &coefficient) {
+    double scaled = std::fabs(bias * _posiform->getBiasConversionRatio());
+    if (scaled > MAX_COEFFICIENT) {
+      return false;
+    }
+    coefficient = _posiform->convertToPosiformCoefficient(bias);
+    return true;
+  }
+
+  // Update the network for the changed biases. Returns false if it must be
+  // rebuilt instead.
+  bool applyChanges() {
+    for (auto &interaction : _changed_interactions) {
+      capacity_t coefficient;
+      if (!convert(_bqm.quadratic(interaction.first, interaction.second),
+                   coefficient)) {
+        return false;
+      }
+      int variable_1 = _posiform->mapVariableQuboToPosiform(interaction.first);
+      int variable_2 = _posiform->mapVariableQuboToPosiform(interaction.second);
+      if (variable_1 < 0 || variable_2 < 0) {
+        if (coefficient) {
+          return false;
+        }
+        continue;
+      }
+      if (!_network->setQuadraticCoefficient(variable_1, variable_2,
+                                             coefficient, &_workspace)) {
+        return false;
+      }
+    }
+
+    // The linear coefficient of the posiform also has the negative quadratic
+    // coefficients of the interactions with the variables after it.
+    for (V v : _changed_variables) {
+      capacity_t linear;
+      if (!convert(_bqm.linear(v), linear)) {
+        return false;
+      }
+      auto it = _bqm.cbegin_neighborhood(v);
+      auto it_end = _bqm.cend_neighborhood(v);
+      for (; it != it_end; it++) {
+        if (it->v > v) {
+          capacity_t coefficient;
+          if (!convert(it->bias, coefficient)) {
+            return false;
+          }
+          if (coefficient < 0) {
+            linear += coefficient;
+          }
+        }
+      }
+
+      int variable = _posiform->mapVariableQuboToPosiform(v);
+      if (variable < 0) {
+        if (linear) {
+          return false;
+        }
+        continue;
+      }
+      capacity_t previous = _linear[variable];
+      double linear_sum = _linear_sum - std::fabs(static_cast<double>(previous)) +
+                          std::fabs(static_cast<double>(linear));
+      if (linear_sum > MAX_COEFFICIENT ||
+          !_network->setLinearCoefficient(variable, linear, &_workspace)) {
+        return false;
+      }
+      _linear[variable] = linear;
+      _linear_sum = linear_sum;
+      _constant += std::min<capacity_t>(linear, 0) -
+                   std::min<capacity_t>(previous, 0);
+    }
+    return true;
+  }
+
+  // The posiform is scaled so that the biases can grow this many times before
+  // the network must be rebuilt, at the cost of two bits of precision.
+  static constexpr double HEADROOM = 4;
+
+  // The largest coefficient, or sum of the linear coefficients, the posiform
+  // allows, see PosiformInfo.
+  static constexpr double MAX_COEFFICIENT =
+      static_cast<double>(std::numeric_limits<capacity_t>::max()) / 4;
+
+  bqm_type _bqm;
+  MaxFlowAlgorithm _algorithm;
+  std::size_t _num_rebuilds;
+  std::unique_ptr<posiform_type> _posiform;
+  std::unique_ptr<network_type> _network;
+
+  // The buffers of the solvers, kept across calls and rebuilds.
+  typename network_type::workspace_t _workspace;
+
+  // The current linear coefficients of the posiform variables, their sum of
+  // absolute values and the constant of the posiform.
+  std::vector<capacity_t> _linear;
+  double _linear_sum;
+  capacity_t _constant;
+
+  bool _needs_rebuild = false;
+  std::vector<bool> _is_changed;
+  std::vector<V> _changed_variables;
+  std::vector<std::pair<V, V>> _changed_interactions;
+};
+
 } // namespace fix_variables_
+
+#endif // FIX_VARIABLES_HPP_INCLUDED
@@ -25,6 +25,10 @@
 #ifndef HELPER_DATA_STRUCTURES_HPP_INCLUDED
 #define HELPER_DATA_STRUCTURES_HPP_INCLUDED
 
+#include <algorithm>
+#include <assert.h>
+#include <cstddef>
+#include <utility>
 #include <vector>
 
 // Queue with std::vector as internal container.
@@ -50,6 +54,13 @@ public:
 
   void reset() noexcept { _front = _back = 0; }
 
+  // Make room for size elements and empty the queue. The memory is kept when
+  // the size shrinks, so a queue reused for smaller graphs is not reallocated.
+  void resize(std::size_t size) {
+    _data.resize(size);
+    reset();
+  }
+
   int size() noexcept { return _back - _front; }
 };
 
@@ -76,6 +87,13 @@ public:
 
   void reset() noexcept { _size = 0; }
 
+  // Make room for size elements and empty the stack, see
+  // vector_based_queue::resize().
+  void resize(std::size_t size) {
+    _data.resize(size);
+    reset();
+  }
+
   int size() noexcept { return _size; }
 };
 
@@ -149,4 +167,129 @@ public:
   }
 };
 
+// Adjacency list in compressed sparse row format. The out edges of all the
+// vertices are kept in one contiguous array, the out edges of a vertex v being
+// in the range [_offsets[v], _offsets[v + 1]). Compared to a vector of vectors
+// this needs a single allocation and the graph algorithms, which visit the
+// vertices mostly in order, read the edges sequentially. The out-degrees must
+// be known up front, the edges of each vertex are then added in order with
+// emplace_back(), or written in place through operator[] by the thread that
+// owns the vertex.
+template <typename T> class compressed_adjacency_list {
+public:
+  using iterator = typename std::vector<T>::iterator;
+
+  // The out edges of a single vertex.
+  class range {
+    iterator _begin, _end;
+
+  public:
+    range(iterator begin, iterator end) : _begin(begin), _end(end) {}
+
+    iterator begin() const noexcept { return _begin; }
+
+    iterator end() const noexcept { return _end; }
+
+    std::size_t size() const noexcept { return _end - _begin; }
+
+    T &operator[](std::size_t i) const noexcept { return _begin[i]; }
+  };
+
+  compressed_adjacency_list() = default;
+
+  // @param write_in_place : if true the edges will be written through
+  // operator[] instead of emplace_back(), so the fill positions needed by
+  // emplace_back() are not allocated.
+  explicit compressed_adjacency_list(const std::vector<std::size_t> &degrees,
+                                     bool write_in_place = false) {
+    computeOffsets(degrees);
+    _edges.resize(_offsets.back());
+    if (!write_in_place) {
+      _fill.assign(_offsets.begin(), _offsets.end() - 1);
+    }
+  }
+
+  // Number of vertices.
+  std::size_t size() const noexcept {
+    return _offsets.empty() ? 0 : _offsets.size() - 1;
+  }
+
+  std::size_t num_edges() const noexcept { return _edges.size(); }
+
+  range operator[](std::size_t vertex) noexcept {
+    return {_edges.begin() + _offsets[vertex],
+            _edges.begin() + _offsets[vertex + 1]};
+  }
+
+  // The index, within the out edges of vertex, that the next edge added to it
+  // will have.
+  std::size_t next_index(std::size_t vertex) const noexcept {
+    return _fill[vertex] - _offsets[vertex];
+  }
+
+  template <class... Args> void emplace_back(std::size_t vertex, Args &&...args) {
+    assert(!_fill.empty() &&
+           "Edges can not be added to a list that is written in place.");
+    assert(_fill[vertex] < _offsets[vertex + 1] &&
+           "More edges added to a vertex than its out-degree.");
+    _edges[_fill[vertex]++] = T(std::forward<Args>(args)...);
+  }
+
+  // Check that every vertex got as many edges as its out-degree and release the
+  // memory needed only while adding them.
+  void finalize() {
+    for (std::size_t vertex = 0; vertex < _fill.size(); vertex++) {
+      assert(_fill[vertex] == _offsets[vertex + 1] &&
+             "Fewer edges added to a vertex than its out-degree.");
+    }
+    std::vector<std::size_t>().swap(_fill);
+  }
+
+  // Release all the memory.
+  void clear() {
+    std::vector<T>().swap(_edges);
+    std::vector<std::size_t>().swap(_offsets);
+    std::vector<std::size_t>().swap(_fill);
+  }
+
+private:
+  // Exclusive prefix sum of the degrees. With many vertices it is done in
+  // parallel, in blocks, the sums of the blocks being added in a second pass.
+  void computeOffsets(const std::vector<std::size_t> &degrees) {
+    const std::ptrdiff_t BLOCK_SIZE = 1 << 16;
+    std::ptrdiff_t num_vertices = degrees.size();
+    std::ptrdiff_t num_blocks = (num_vertices + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    _offsets.resize(num_vertices + 1);
+    _offsets[0] = 0;
+
+    std::vector<std::size_t> block_offsets(num_blocks + 1, 0);
+#pragma omp parallel for
+    for (std::ptrdiff_t block = 0; block < num_blocks; block++) {
+      std::ptrdiff_t end = std::min(num_vertices, (block + 1) * BLOCK_SIZE);
+      std::size_t sum = 0;
+      for (std::ptrdiff_t vertex = block * BLOCK_SIZE; vertex < end; vertex++) {
+        sum += degrees[vertex];
+      }
+      block_offsets[block + 1] = sum;
+    }
+    for (std::ptrdiff_t block = 0; block < num_blocks; block++) {
+      block_offsets[block + 1] += block_offsets[block];
+    }
+
+#pragma omp parallel for
+    for (std::ptrdiff_t block = 0; block < num_blocks; block++) {
+      std::ptrdiff_t end = std::min(num_vertices, (block + 1) * BLOCK_SIZE);
+      std::size_t sum = block_offsets[block];
+      for (std::ptrdiff_t vertex = block * BLOCK_SIZE; vertex < end; vertex++) {
+        sum += degrees[vertex];
+        _offsets[vertex + 1] = sum;
+      }
+    }
+  }
+
+  std::vector<T> _edges;
+  std::vector<std::size_t> _offsets;
+  std::vector<std::size_t> _fill;
+};
+
 #endif
@@ -20,35 +20,104 @@
 #include <iostream>
 #include <vector>
 
+#include "capacity_type_traits.hpp"
 #include "helper_data_structures.hpp"
 
+// The buffers of the graph algorithms below, which can be kept between calls so
+// that running them many times, e.g. on the implication networks of many BQMs,
+// does not allocate them every time. They are resized for each graph, which
+// never frees their memory, and their contents are overwritten, so a workspace
+// must not be used by two calls at the same time.
+struct GraphWorkspace {
+  // Breadth first searches.
+  vector_based_queue<int> vertex_queue;
+  std::vector<int> is_visited;
+  std::vector<int> level;
+  std::vector<int> next_level;
+
+  // Tarjan's strongly connected components algorithm.
+  vector_based_stack<int> component_stack;
+  std::vector<bool> in_component_stack;
+  std::vector<int> low_link_id;
+  std::vector<int> vertex_visit_id;
+  std::vector<int> parent;
+  std::vector<std::size_t> next_out_edge;
+
+  // The parallel strongly connected components algorithm.
+  std::vector<std::atomic<int>> in_degrees;
+  std::vector<std::atomic<int>> out_degrees;
+  std::vector<std::atomic<int>> is_trimmed;
+  std::vector<std::atomic<int>> colors;
+  std::vector<int> trimmed;
+  std::vector<int> next_trimmed;
+  std::vector<int> remaining;
+  std::vector<int> roots;
+  std::vector<int> component_numbers;
+};
+
+// Atomics can not be moved, so unlike the other buffers of a GraphWorkspace
+// they are reallocated when they grow. Their values are unspecified.
+inline void growAtomics(std::vector<std::atomic<int>> &atomics,
+                        std::size_t size) {
+  if (atomics.size() < size) {
+    std::vector<std::atomic<int>>(size).swap(atomics);
+  }
+}
+
 // Perform breadth first search from a certain vertex, a depth equal to  the
 // number of vertices means that vertex could not be reached from the
 // start_vertex, since the maximum depth can be equal to number of vertices -1.
-int breadthFirstSearch(std::vector<std::vector<int>> &adjacency_list,
-                       int start_vertex, std::vector<int> &depth_values,
-                       bool print_result = false) {
+// The search goes one level at a time, the vertices of a level are processed
+// in parallel and each vertex of the next level is claimed by one thread.
+// @param workspace : buffers to use instead of allocating them, see
+// GraphWorkspace.
+inline int breadthFirstSearch(std::vector<std::vector<int>> &adjacency_list,
+                              int start_vertex, std::vector<int> &depth_values,
+                              GraphWorkspace *workspace = nullptr) {
+  GraphWorkspace local_workspace;
+  GraphWorkspace &buffers = workspace ? *workspace : local_workspace;
   int num_vertices = adjacency_list.size();
   int UNVISITED = num_vertices;
-  vector_based_queue<int> vertex_queue(num_vertices);
   depth_values.resize(num_vertices);
   std::fill(depth_values.begin(), depth_values.end(), UNVISITED);
+  // Better not use vector of booleans in parallel regions.
+  std::vector<int> &is_visited = buffers.is_visited;
+  is_visited.assign(num_vertices, false);
 
   depth_values[start_vertex] = 0;
-  vertex_queue.push(start_vertex);
-
-  while (!vertex_queue.empty()) {
-    int parent_vertex = vertex_queue.pop();
-    int current_depth = depth_values[parent_vertex] + 1;
-    auto eit = adjacency_list[parent_vertex].begin();
-    auto eit_end = adjacency_list[parent_vertex].end();
-    for (; eit != eit_end; eit++) {
-      int to_vertex = *eit;
-      if (depth_values[to_vertex] == UNVISITED) {
-        depth_values[to_vertex] = current_depth;
-        vertex_queue.push(to_vertex);
+  is_visited[start_vertex] = true;
+  std::vector<int> &level = buffers.level;
+  std::vector<int> &next_level = buffers.next_level;
+  level.assign(1, start_vertex);
+
+  for (int current_depth = 1; !level.empty(); current_depth++) {
+    next_level.clear();
+    int level_size = level.size();
+#pragma omp parallel
+    {
+      std::vector<int> found;
+#pragma omp for nowait
+      for (int i = 0; i < level_size; i++) {
+        auto eit = adjacency_list[level[i]].begin();
+        auto eit_end = adjacency_list[level[i]].end();
+        for (; eit != eit_end; eit++) {
+          int to_vertex = *eit;
+          int was_visited;
+#pragma omp atomic capture
+          {
+            was_visited = is_visited[to_vertex];
+            is_visited[to_vertex] = true;
+          }
+          if (!was_visited) {
+            depth_values[to_vertex] = current_depth;
+            found.push_back(to_vertex);
+          }
+        }
       }
+#pragma omp critical
+      next_level.insert(next_level.end(), found.begin(), found.end());
     }
+    level.swap(next_level);
   }
   return UNVISITED;
 }
@@ -64,16 +133,21 @@ int breadthFirstSearch(std::vector<std::vector<int>> &adjacency_list,
 // start_vertex or not, In case of a flow graph the search should consider if
 // there is residual capacity in the reverse edge of the edge that connects the
 // parent to the child.
+// @param workspace : buffers to use instead of allocating them, see
+// GraphWorkspace.
 // @returns the unreachable depth.
 template <class EdgeType>
 int breadthFirstSearchResidual(
-    std::vector<std::vector<EdgeType>> &adjacency_list, int start_vertex,
+    compressed_adjacency_list<EdgeType> &adjacency_list, int start_vertex,
     std::vector<int> &depth_values, bool reverse = false,
-    bool print_result = false) {
+    bool print_result = false, GraphWorkspace *workspace = nullptr) {
   // using capacity_t = typename EdgeType::capacity_type;
+  GraphWorkspace local_workspace;
+  GraphWorkspace &buffers = workspace ? *workspace : local_workspace;
   int num_vertices = adjacency_list.size();
   int UNVISITED = num_vertices;
-  vector_based_queue<int> vertex_queue(num_vertices);
+  vector_based_queue<int> &vertex_queue = buffers.vertex_queue;
+  vertex_queue.resize(num_vertices);
   depth_values.resize(num_vertices);
   std::fill(depth_values.begin(), depth_values.end(), UNVISITED);
 
@@ -154,7 +228,7 @@ int breadthFirstSearchResidual(
 // @returns std::pair<the value of flow, if flow is valid or not>
 template <class EdgeType>
 std::pair<typename EdgeType::capacity_type, bool>
-isFlowValid(std::vector<std::vector<EdgeType>> &adjacency_list, int source,
+isFlowValid(compressed_adjacency_list<EdgeType> &adjacency_list, int source,
             int sink) {
   using capacity_t = typename EdgeType::capacity_type;
   bool valid_flow = true;
@@ -222,19 +296,20 @@ isFlowValid(std::vector<std::vector<EdgeType>> &adjacency_list, int source,
       continue;
     }
     if (excess[vertex]) {
-      std::cout << "Excess flow of " << excess[vertex]
+      std::cout << "Excess flow of " << printableCapacity(excess[vertex])
                 << " in vertex : " << vertex << std::endl;
       valid_flow = false;
     }
   }
 
   if (excess[sink] != -excess[source]) {
-    std::cout << "Flow out of source : " << -excess[source]
-              << " is not equal to flow into sink : " << excess[sink]
-              << std::endl;
+    std::cout << "Flow out of source : " << printableCapacity(-excess[source])
+              << " is not equal to flow into sink : "
+              << printableCapacity(excess[sink]) << std::endl;
     std::cout << "Difference is : "
-              << std::llabs(std::llabs(excess[source]) -
-                            std::llabs(excess[sink]))
+              << printableCapacity(
+                     absoluteCapacity(absoluteCapacity(excess[source]) -
+                                      absoluteCapacity(excess[sink])))
               << std::endl;
     valid_flow = false;
   }
@@ -246,7 +321,7 @@ isFlowValid(std::vector<std::vector<EdgeType>> &adjacency_list, int source,
 // a valid max-flow or not and also return the flow value.
 template <class EdgeType>
 std::pair<typename EdgeType::capacity_type, bool>
-isMaximumFlow(std::vector<std::vector<EdgeType>> &adjacency_list, int source,
+isMaximumFlow(compressed_adjacency_list<EdgeType> &adjacency_list, int source,
               int sink) {
 
   // If the flow follows the constraints of network flow.
@@ -264,32 +339,43 @@ isMaximumFlow(std::vector<std::vector<EdgeType>> &adjacency_list, int source,
 
 // Tarzan's strongly connected component algoirhtm using iterative depth first
 // search. Note there will be no explicit stack used for this depth first
-// search, but instead the iterators pointing to the edges to be traversed for
-// each vertex will be updated and an array containing parents of vertices will
+// search, but instead the positions of the edges to be traversed for each
+// vertex will be updated and an array containing parents of vertices will
 // help simulate the stack. When we want to pop the stack we can basically look
 // at the parent of the current vertex being processed and when we want to push
 // a vertex into the stack, we can save it as the parent of the child vertex and
 // restart the loop with the child vertex as the current vertex.
-int stronglyConnectedComponents(std::vector<std::vector<int>> &adjacency_list,
-                                std::vector<int> &components) {
+// @param adjacency_list : a std::vector<std::vector<int>> or a
+// compressed_adjacency_list<int>.
+// @param workspace : buffers to use instead of allocating them, see
+// GraphWorkspace.
+template <class AdjacencyList>
+int stronglyConnectedComponents(AdjacencyList &adjacency_list,
+                                std::vector<int> &components,
+                                GraphWorkspace *workspace = nullptr) {
+  GraphWorkspace local_workspace;
+  GraphWorkspace &buffers = workspace ? *workspace : local_workspace;
   int num_vertices = adjacency_list.size();
-  using edge_iterator = typename std::vector<int>::iterator;
   components.resize(num_vertices);
-  vector_based_stack<int> component_stack(num_vertices);
-  std::vector<bool> in_component_stack(num_vertices, false);
+  vector_based_stack<int> &component_stack = buffers.component_stack;
+  component_stack.resize(num_vertices);
+  std::vector<bool> &in_component_stack = buffers.in_component_stack;
+  in_component_stack.assign(num_vertices, false);
   int UNVISITED = num_vertices;
-  std::vector<int> low_link_id(num_vertices, UNVISITED);
-  std::vector<int> vertex_visit_id(num_vertices, UNVISITED);
-  std::vector<int> parent(num_vertices);
+  std::vector<int> &low_link_id = buffers.low_link_id;
+  low_link_id.assign(num_vertices, UNVISITED);
+  std::vector<int> &vertex_visit_id = buffers.vertex_visit_id;
+  vertex_visit_id.assign(num_vertices, UNVISITED);
+  std::vector<int> &parent = buffers.parent;
+  parent.resize(num_vertices);
   int visit_id = 0;
   int num_strong_components = 0;
-  std::vector<std::pair<edge_iterator, edge_iterator>> pending_out_edges(
-      num_vertices);
 
-  for (int vertex = 0; vertex < num_vertices; vertex++) {
-    pending_out_edges[vertex] = {adjacency_list[vertex].begin(),
-                                 adjacency_list[vertex].end()};
-  }
+  // The position, in the out edges of each vertex, of the next edge to be
+  // traversed. Positions rather than iterators, so the buffer does not depend
+  // on the type of the adjacency list.
+  std::vector<std::size_t> &next_out_edge = buffers.next_out_edge;
+  next_out_edge.assign(num_vertices, 0);
 
   // Iterative DFS.
   for (int current_vertex = 0; current_vertex < num_vertices;
@@ -311,10 +397,10 @@ int stronglyConnectedComponents(std::vector<std::vector<int>> &adjacency_list,
         // stack frame is saved in the stack frame while the function calls
         // itself recursively so when it comes back it finds the counter with
         // the proper value.
-        for (; pending_out_edges[current_vertex].first !=
-               pending_out_edges[current_vertex].second;
-             pending_out_edges[current_vertex].first++) {
-          int child_vertex = *(pending_out_edges[current_vertex].first);
+        auto &&out_edges = adjacency_list[current_vertex];
+        std::size_t &next_edge = next_out_edge[current_vertex];
+        for (; next_edge != out_edges.size(); next_edge++) {
+          int child_vertex = out_edges[next_edge];
           if (vertex_visit_id[child_vertex] == UNVISITED) {
             vertex_visit_id[child_vertex] = visit_id;
             low_link_id[child_vertex] = visit_id;
@@ -340,8 +426,8 @@ int stronglyConnectedComponents(std::vector<std::vector<int>> &adjacency_list,
         }
 
         // Finished exploring current vertex, edges.
-        if (pending_out_edges[current_vertex].first ==
-            pending_out_edges[current_vertex].second) {
+        if (next_out_edge[current_vertex] ==
+            adjacency_list[current_vertex].size()) {
           if (low_link_id[current_vertex] == vertex_visit_id[current_vertex]) {
             int popped_vertex = -1;
             do {
@@ -374,7 +460,7 @@ int stronglyConnectedComponents(std::vector<std::vector<int>> &adjacency_list,
             // of the child node.
             low_link_id[current_vertex] = std::min(
                 low_link_id[current_vertex], low_link_id[completed_vertex]);
-            pending_out_edges[current_vertex].first++;
+            next_out_edge[current_vertex]++;
           } else {
             break;
           }
@@ -385,39 +471,253 @@ int stronglyConnectedComponents(std::vector<std::vector<int>> &adjacency_list,
   return num_strong_components;
 }
 
-// Transpose an adjacency list.
-void getTransposedAdjacencyList(std::vector<std::vector<int>> original,
-                                std::vector<std::vector<int>> &transposed) {
-  int num_vertices = original.size();
-  std::atomic<int> *transposed_sizes =
-      (std::atomic<int> *)malloc(num_vertices * sizeof(std::atomic<int>));
+// Strongly connected components found in parallel by trimming and coloring,
+// see McLendon, W., Hendrickson, B., Plimpton, S., Rauchwerger, L. Finding
+// strongly connected components in distributed graphs. Journal of Parallel and
+// Distributed Computing 65, 901-910 (2005) and Orzan, S. On Distributed
+// Verification and Verified Distribution. PhD thesis, Vrije Universiteit
+// Amsterdam (2004).
+//
+// First the vertices with no in or out edges from the remaining vertices are
+// trimmed, each is a component by itself. Then each round colors every
+// remaining vertex with the largest vertex that can reach it. A vertex whose
+// color is itself is the root of its component, which is made of the vertices
+// of the same color that can reach the root, found by a backward search for
+// each root in parallel. Unlike Tarjan's algorithm the components are numbered
+// in the order of their smallest vertex, so the numbering does not depend on
+// the number of threads.
+// @param adjacency_list_transposed : the transpose of adjacency_list.
+// @param workspace : buffers to use instead of allocating them, see
+// GraphWorkspace.
+// @returns the number of components.
+template <class AdjacencyList>
+int stronglyConnectedComponentsParallel(
+    AdjacencyList &adjacency_list, AdjacencyList &adjacency_list_transposed,
+    std::vector<int> &components, GraphWorkspace *workspace = nullptr) {
+  GraphWorkspace local_workspace;
+  GraphWorkspace &buffers = workspace ? *workspace : local_workspace;
+  int num_vertices = adjacency_list.size();
+  const int UNASSIGNED = -1;
+  components.assign(num_vertices, UNASSIGNED);
+
+  // The number of in and out edges from/to the vertices not yet in a
+  // component. A vertex is claimed for trimming by the thread that sets its
+  // flag. All three are set for every vertex below.
+  std::vector<std::atomic<int>> &in_degrees = buffers.in_degrees;
+  std::vector<std::atomic<int>> &out_degrees = buffers.out_degrees;
+  std::vector<std::atomic<int>> &is_trimmed = buffers.is_trimmed;
+  growAtomics(in_degrees, num_vertices);
+  growAtomics(out_degrees, num_vertices);
+  growAtomics(is_trimmed, num_vertices);
+  std::vector<int> &trimmed = buffers.trimmed;
+  trimmed.clear();
+#pragma omp parallel
+  {
+    std::vector<int> found;
+#pragma omp for nowait
+    for (int vertex = 0; vertex < num_vertices; vertex++) {
+      int in_degree = adjacency_list_transposed[vertex].size();
+      int out_degree = adjacency_list[vertex].size();
+      in_degrees[vertex].store(in_degree, std::memory_order_relaxed);
+      out_degrees[vertex].store(out_degree, std::memory_order_relaxed);
+      is_trimmed[vertex].store(!in_degree || !out_degree,
+                               std::memory_order_relaxed);
+      if (!in_degree || !out_degree) {
+        found.push_back(vertex);
+      }
+    }
+#pragma omp critical
+    trimmed.insert(trimmed.end(), found.begin(), found.end());
+  }
+
+  std::vector<int> &next_trimmed = buffers.next_trimmed;
+  while (!trimmed.empty()) {
+    next_trimmed.clear();
+    int num_trimmed = trimmed.size();
+#pragma omp parallel
+    {
+      std::vector<int> found;
+      auto trim = [&](int vertex, std::atomic<int> &degree) {
+        if (degree.fetch_sub(1, std::memory_order_relaxed) == 1 &&
+            !is_trimmed[vertex].exchange(true, std::memory_order_relaxed)) {
+          found.push_back(vertex);
+        }
+      };
+#pragma omp for nowait
+      for (int i = 0; i < num_trimmed; i++) {
+        int vertex = trimmed[i];
+        components[vertex] = vertex;
+        for (int to_vertex : adjacency_list[vertex]) {
+          trim(to_vertex, in_degrees[to_vertex]);
+        }
+        for (int from_vertex : adjacency_list_transposed[vertex]) {
+          trim(from_vertex, out_degrees[from_vertex]);
+        }
+      }
+#pragma omp critical
+      next_trimmed.insert(next_trimmed.end(), found.begin(), found.end());
+    }
+    trimmed.swap(next_trimmed);
+  }
+
+  std::vector<int> &remaining = buffers.remaining;
+  remaining.clear();
   for (int vertex = 0; vertex < num_vertices; vertex++) {
-    transposed_sizes[vertex] = 0;
+    if (components[vertex] == UNASSIGNED) {
+      remaining.push_back(vertex);
+    }
   }
-  transposed.resize(num_vertices);
+
+  // The colors of the remaining vertices are set at the start of each round.
+  std::vector<std::atomic<int>> &colors = buffers.colors;
+  growAtomics(colors, num_vertices);
+  std::vector<int> &roots = buffers.roots;
+  while (!remaining.empty()) {
+    int num_remaining = remaining.size();
+#pragma omp parallel for
+    for (int i = 0; i < num_remaining; i++) {
+      colors[remaining[i]].store(remaining[i], std::memory_order_relaxed);
+    }
+
+    // Propagate the largest color along the edges until nothing changes.
+    // Colors only increase, so this converges whatever the order of updates.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+#pragma omp parallel for reduction(|| : changed)
+      for (int i = 0; i < num_remaining; i++) {
+        int vertex = remaining[i];
+        int color = colors[vertex].load(std::memory_order_relaxed);
+        for (int to_vertex : adjacency_list[vertex]) {
+          if (components[to_vertex] != UNASSIGNED) {
+            continue;
+          }
+          int to_color = colors[to_vertex].load(std::memory_order_relaxed);
+          while (to_color < color &&
+                 !colors[to_vertex].compare_exchange_weak(
+                     to_color, color, std::memory_order_relaxed)) {
+          }
+          if (to_color < color) {
+            changed = true;
+          }
+        }
+      }
+    }
+
+    roots.clear();
+    for (int vertex : remaining) {
+      if (colors[vertex].load(std::memory_order_relaxed) == vertex) {
+        roots.push_back(vertex);
+      }
+    }
+
+    // The colors partition the remaining vertices, so the searches from the
+    // roots do not touch the same vertices.
+    int num_roots = roots.size();
+#pragma omp parallel
+    {
+      std::vector<int> stack;
+#pragma omp for schedule(dynamic)
+      for (int i = 0; i < num_roots; i++) {
+        int root = roots[i];
+        components[root] = root;
+        stack.push_back(root);
+        while (!stack.empty()) {
+          int vertex = stack.back();
+          stack.pop_back();
+          for (int from_vertex : adjacency_list_transposed[vertex]) {
+            if (components[from_vertex] == UNASSIGNED &&
+                colors[from_vertex].load(std::memory_order_relaxed) == root) {
+              components[from_vertex] = root;
+              stack.push_back(from_vertex);
+            }
+          }
+        }
+      }
+    }
+
+    remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                   [&](int vertex) {
+                                     return components[vertex] != UNASSIGNED;
+                                   }),
+                    remaining.end());
+  }
+
+  // Each component is labeled by one of its vertices, number them in the order
+  // of their smallest vertex.
+  std::vector<int> &component_numbers = buffers.component_numbers;
+  component_numbers.assign(num_vertices, UNASSIGNED);
+  int num_strong_components = 0;
+  for (int vertex = 0; vertex < num_vertices; vertex++) {
+    int &number = component_numbers[components[vertex]];
+    if (number == UNASSIGNED) {
+      number = num_strong_components++;
+    }
+    components[vertex] = number;
+  }
+  return num_strong_components;
+}
+
+// Allocate the out edges of every vertex of an adjacency list, to be written
+// in place.
+inline void allocateAdjacencyList(const std::vector<std::size_t> &degrees,
+                                  std::vector<std::vector<int>> &adjacency_list) {
+  int num_vertices = degrees.size();
+  adjacency_list.resize(num_vertices);
+#pragma omp parallel for
+  for (int vertex = 0; vertex < num_vertices; vertex++) {
+    adjacency_list[vertex].resize(degrees[vertex]);
+  }
+}
+
+inline void allocateAdjacencyList(const std::vector<std::size_t> &degrees,
+                                  compressed_adjacency_list<int> &adjacency_list) {
+  adjacency_list = compressed_adjacency_list<int>(degrees, true);
+}
+
+// Transpose an adjacency list. The in edges of each vertex are listed in
+// increasing order, as a serial transpose would list them, since the order in
+// which the components are fixed depends on it.
+// @param original, transposed : std::vector<std::vector<int>> or
+// compressed_adjacency_list<int>.
+template <class AdjacencyList, class TransposedAdjacencyList>
+void getTransposedAdjacencyList(AdjacencyList &original,
+                                TransposedAdjacencyList &transposed) {
+  int num_vertices = original.size();
+  std::vector<std::size_t> transposed_sizes(num_vertices, 0);
 
 #pragma omp parallel for
   for (int vertex = 0; vertex < num_vertices; vertex++) {
     auto eit = original[vertex].begin();
     auto eit_end = original[vertex].end();
     for (; eit != eit_end; eit++) {
+#pragma omp atomic
       transposed_sizes[*eit]++;
     }
   }
 
-  for (int vertex = 0; vertex < num_vertices; vertex++) {
-    transposed[vertex].reserve(transposed_sizes[vertex]);
-  }
+  allocateAdjacencyList(transposed_sizes, transposed);
+  std::fill(transposed_sizes.begin(), transposed_sizes.end(), 0);
 
+#pragma omp parallel for
   for (int vertex = 0; vertex < num_vertices; vertex++) {
     auto eit = original[vertex].begin();
     auto eit_end = original[vertex].end();
     for (; eit != eit_end; eit++) {
-      transposed[*eit].push_back(vertex);
+      std::size_t position;
+#pragma omp atomic capture
+      position = transposed_sizes[*eit]++;
+      transposed[*eit][position] = vertex;
     }
   }
 
-  free(transposed_sizes);
+#pragma omp parallel for schedule(dynamic)
+  for (int vertex = 0; vertex < num_vertices; vertex++) {
+    auto &&in_edges = transposed[vertex];
+    if (!std::is_sorted(in_edges.begin(), in_edges.end())) {
+      std::sort(in_edges.begin(), in_edges.end());
+    }
+  }
 }
 
 // We create the graph of strongly connected graphs, while processing each
@@ -430,10 +730,11 @@ void getTransposedAdjacencyList(std::vector<std::vector<int>> original,
 // matrix which may be very large if the number of strongly connected components
 // is nearly equal to the number of vertices and we would risk memory allocation
 // failure.
+template <class AdjacencyList>
 void createGraphOfStronglyConnectedComponents(
     std::vector<int> &vertex_to_component_map,
     std::vector<std::vector<int>> &components,
-    std::vector<std::vector<int>> &adjacency_list_residual,
+    AdjacencyList &adjacency_list_residual,
     std::vector<std::vector<int>> &adjacency_list_components) {
   int num_components = components.size();
   adjacency_list_components.resize(num_components);
@@ -442,7 +743,9 @@ void createGraphOfStronglyConnectedComponents(
     std::vector<int> temp_buffer(num_components);
     // Better not use vector of booleans in parallel regions.
     std::vector<int> found_edge_to_component(num_components, false);
-#pragma omp for
+    // The sizes of the components vary a lot, usually there is one large
+    // component and many small ones.
+#pragma omp for schedule(dynamic)
     for (int component = 0; component < num_components; component++) {
       int num_out_edges = 0;
       auto vit = components[component].begin();
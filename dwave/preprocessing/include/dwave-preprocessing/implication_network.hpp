@@ -16,10 +16,27 @@
 #define IMPLICATION_NETWORK_HPP_INCLUDED
 
 #include <assert.h>
+#include <chrono>
+#include <type_traits>
+#include "boykov_kolmogorov.hpp"
+#include "capacity_type_traits.hpp"
 #include "helper_graph_algorithms.hpp"
 #include "mapping_policy.hpp"
+#include "parallel_push_relabel.hpp"
 #include "push_relabel.hpp"
 
+// The algorithm used to compute the maximum flow of an implication network.
+enum class MaxFlowAlgorithm {
+  // Serial highest label push-relabel, see PushRelabelSolver.
+  PUSH_RELABEL,
+  // Synchronous parallel push-relabel, see ParallelPushRelabelSolver.
+  PARALLEL_PUSH_RELABEL,
+  // Augmenting paths on search trees, see BoykovKolmogorovSolver.
+  BOYKOV_KOLMOGOROV,
+  // Boykov-Kolmogorov for sparse networks, push-relabel for dense ones.
+  AUTOMATIC
+};
+
 // Edge type for implication network. An implication network is formed from a
 // posiform. If there is a term Coeff * X_i * X_j, we will have two edges in the
 // network one X_i to X_j' and another X_j to X_i', the directions will depend
@@ -30,37 +47,53 @@
 // For more details see : Boros, Endre & Hammer, Peter & Tavares, Gabriel.
 // (2006). Preprocessing of unconstrained quadratic binary optimization. RUTCOR
 // Research Report.
-template <typename capacity_t> class ImplicationEdge {
+//
+// The from_vertex is redundant, since it is the vertex whose out edges the edge
+// is stored with, and the algorithms do not use it. When compact is true it is
+// not stored. With 8 byte capacities this saves nothing, the compiler uses the
+// same amount of storage for padding, but with 4 byte capacities an edge shrinks
+// from 24 to 20 bytes.
+template <bool store_from_vertex> struct ImplicationEdgeFromVertex {
+  int from_vertex;
+};
+
+template <> struct ImplicationEdgeFromVertex<false> {};
+
+template <typename capacity_t, bool compact = false>
+class ImplicationEdge : public ImplicationEdgeFromVertex<!compact> {
 public:
   typedef capacity_t capacity_type;
 
+  // Needed to preallocate the edges of a compressed_adjacency_list.
+  ImplicationEdge() = default;
+
   ImplicationEdge(int from_vertex, int to_vertex, capacity_t capacity,
                   capacity_t reverse_capacity, int reverse_edge_index,
                   int symmetric_edge_index)
-      : from_vertex(from_vertex), to_vertex(to_vertex),
-        reverse_edge_index(reverse_edge_index),
+      : to_vertex(to_vertex), reverse_edge_index(reverse_edge_index),
         symmetric_edge_index(symmetric_edge_index), residual(capacity) {
     assert((!capacity || !reverse_capacity) &&
            "Either capacity or reverse edge capacity must be zero.");
+    if constexpr (!compact) {
+      this->from_vertex = from_vertex;
+    }
     _encoded_capacity = (!capacity) ? -reverse_capacity : capacity;
   }
 
   void print() {
     std::cout << std::endl;
-    std::cout << from_vertex << " --> " << to_vertex << std::endl;
-    std::cout << "Capacity : " << getCapacity() << std::endl;
-    std::cout << "Residual : " << residual << std::endl;
-    std::cout << "Reverse Edge Capacity : " << getReverseEdgeCapacity()
-              << std::endl;
-    std::cout << "Reverse Edge Residual : " << getReverseEdgeResidual()
-              << std::endl;
-  }
-
-  // The from_vertex is redundant, since we use an adjacency list, but we are
-  // not wasting any space as of now, since the compiler uses the same amount of
-  // storage for padding when residual is of a type that takes 8 bytes and in
-  // our implmementation we use long long int (8 byte type).
-  int from_vertex;
+    if constexpr (!compact) {
+      std::cout << this->from_vertex;
+    }
+    std::cout << " --> " << to_vertex << std::endl;
+    std::cout << "Capacity : " << printableCapacity(getCapacity()) << std::endl;
+    std::cout << "Residual : " << printableCapacity(residual) << std::endl;
+    std::cout << "Reverse Edge Capacity : "
+              << printableCapacity(getReverseEdgeCapacity()) << std::endl;
+    std::cout << "Reverse Edge Residual : "
+              << printableCapacity(getReverseEdgeResidual()) << std::endl;
+  }
+
   int to_vertex;
   int reverse_edge_index;
   int symmetric_edge_index;
@@ -99,13 +132,23 @@ public:
 
   // Needed for the purpose of making residual network symmetric.
   void scaleCapacity(int scale) { _encoded_capacity *= scale; }
+
+  // Needed to change the capacity of an edge, and of its reverse edge, when the
+  // posiform changes after the flow has been computed. The residual is left
+  // for the caller to update.
+  void setCapacity(capacity_t capacity) { _encoded_capacity = capacity; }
+
+  void setReverseEdgeCapacity(capacity_t capacity) {
+    _encoded_capacity = -capacity;
+  }
 };
 
 // Needed for binary search when edges are in sorted order.
 class ImplicationEdgeComparator {
 public:
-  template <class capacity_t>
-  bool operator()(const ImplicationEdge<capacity_t> &a, const int &vertex) {
+  template <class capacity_t, bool compact>
+  bool operator()(const ImplicationEdge<capacity_t, compact> &a,
+                  const int &vertex) {
     return a.to_vertex < vertex;
   }
 };
@@ -184,23 +227,102 @@ public:
 // Tavares, Gabriel. (2006). Preprocessing of unconstrained quadratic binary
 // optimization. RUTCOR Research Report. See the class mappingPolicy to
 // understand the mapping between posiform variables and implication network
-// vertices.
-template <class capacity_t> class ImplicationNetwork {
+// vertices. When compact_edges is true the edges do not store their from_vertex,
+// see ImplicationEdge.
+//
+// A reusable network keeps its maximum flow when the variables are fixed, so
+// that after the coefficients of the posiform are changed the next maximum
+// flow can start from the previous one instead of from zero.
+template <class capacity_t, bool compact_edges = false>
+class ImplicationNetwork {
 
 public:
-  template <class PosiformInfo> ImplicationNetwork(PosiformInfo &posiform);
+  using edge_type = ImplicationEdge<capacity_t, compact_edges>;
+  using edge_iterator = typename compressed_adjacency_list<edge_type>::iterator;
+
+  template <class PosiformInfo>
+  ImplicationNetwork(PosiformInfo &posiform, bool reusable = false);
 
   int getSource() { return _source; }
 
   int getSink() { return _sink; }
 
-  std::vector<std::vector<ImplicationEdge<capacity_t>>> &getAdjacencyList() {
+  compressed_adjacency_list<edge_type> &getAdjacencyList() {
     checkAdjacencyListValidity();
     return _adjacency_list;
   }
 
+  // The buffers used to fix the variables, which can be passed to fixVariables()
+  // so that fixing the variables of many networks, one after the other, only
+  // allocates them once. They grow to the size of the largest network and are
+  // never freed, see PushRelabelSolver::workspace_t and GraphWorkspace. A
+  // workspace must not be used by two networks at the same time.
+  struct workspace_t {
+    // The serial solver uses the part it shares with the parallel one.
+    typename ParallelPushRelabelSolver<edge_type>::workspace_t push_relabel;
+    typename BoykovKolmogorovSolver<edge_type>::workspace_t boykov_kolmogorov;
+    GraphWorkspace graph;
+    std::vector<int> bfs_depth_values;
+    std::vector<int> vertex_to_component_map;
+    std::vector<int> out_degrees;
+    vector_based_queue<int> component_queue;
+
+    // The searches for cycles of flow done when a capacity is lowered, see
+    // setLinearCoefficient(). Between calls every parent is unvisited, so a
+    // search only resets the vertices it visited.
+    std::vector<int> cancel_parents;
+    std::vector<edge_type *> cancel_parent_edges;
+    std::vector<int> cancel_visited;
+
+    // The time spent in each phase by the last call to fixVariables() that
+    // used the workspace, for profiling. The phases that were not run, i.e.
+    // the symmetrization and the components when only the trivially strong
+    // variables are fixed, are zero.
+    struct {
+      std::chrono::duration<double> maximum_flow;
+      std::chrono::duration<double> symmetrization;
+      std::chrono::duration<double> strongly_connected_components;
+      std::chrono::duration<double> fixing;
+    } timings = {};
+  };
+
   capacity_t fixVariables(std::vector<std::pair<int, int>> &fixed_variables,
-                    bool only_trivially_strong = false);
+                    bool only_trivially_strong = false,
+                    MaxFlowAlgorithm algorithm = MaxFlowAlgorithm::PUSH_RELABEL,
+                    workspace_t *workspace = nullptr);
+
+  // Fix the variables using the given maximum flow solver. The solver is
+  // constructed from the adjacency list, the source and the sink, and must
+  // provide computeMaximumFlow(bool handle_self_loops) leaving a flow, or a
+  // preflow whose excess cannot reach the sink, in the residuals of the edges.
+  // The solvers of this library also take their buffers from the workspace.
+  template <template <class> class MaxFlowSolver>
+  capacity_t fixVariables(std::vector<std::pair<int, int>> &fixed_variables,
+                          bool only_trivially_strong = false,
+                          workspace_t *workspace = nullptr);
+
+  // The algorithm MaxFlowAlgorithm::AUTOMATIC stands for. Boykov-Kolmogorov
+  // is used when the average out degree of the vertices is at most
+  // SPARSE_AVERAGE_DEGREE, as it is for QPU topologies like Chimera, Pegasus
+  // and Zephyr.
+  MaxFlowAlgorithm selectMaxFlowAlgorithm();
+
+  static constexpr std::size_t SPARSE_AVERAGE_DEGREE = 16;
+
+  // Change the coefficient of the linear term of a posiform variable, or of the
+  // quadratic term of two posiform variables, in the network. The flow is kept
+  // valid by cancelling the flow above the new capacities, using the buffers of
+  // the workspace if one is given. Only the terms the posiform had when the
+  // network was built can be changed, and their signs can not be flipped,
+  // since that would need other edges. In that case false is returned, nothing
+  // is changed and the network must be rebuilt. False is also returned, and
+  // the network must be rebuilt, if the flow is found not to be valid.
+  bool setLinearCoefficient(int variable, capacity_t coefficient,
+                            workspace_t *workspace = nullptr);
+
+  bool setQuadraticCoefficient(int variable_1, int variable_2,
+                               capacity_t coefficient,
+                               workspace_t *workspace = nullptr);
 
   void print();
 
@@ -218,14 +340,24 @@ private:
     }
   }
 
+  template <template <class> class MaxFlowSolver>
+  capacity_t computeMaximumFlow(workspace_t *workspace);
+
+  // Construct a maximum flow solver for the network, with its buffers from the
+  // workspace if it has some for that solver.
+  template <template <class> class MaxFlowSolver>
+  MaxFlowSolver<edge_type> createMaxFlowSolver(workspace_t *workspace);
+
   void makeResidualSymmetric();
 
   void extractResidualNetworkWithoutSourceInSinkOut(
-      std::vector<std::vector<int>> &adjacency_list_residual,
+      compressed_adjacency_list<int> &adjacency_list_residual,
       bool free_original_adjacency_list = false);
 
-  capacity_t fixTriviallyStrongVariables(
-      std::vector<std::pair<int, int>> &fixed_variables);
+  // The maximum flow must have been computed already.
+  void
+  fixTriviallyStrongVariables(std::vector<std::pair<int, int>> &fixed_variables,
+                              workspace_t &workspace);
 
   void fixStronglyConnectedComponentVariables(
       int component, stronglyConnectedComponentsInfo &scc_info,
@@ -234,26 +366,52 @@ private:
       std::vector<std::pair<int, int>> &fixed_variables,
       vector_based_queue<int> &component_queue, bool enqueue);
 
-  capacity_t
-  fixStrongAndWeakVariables(std::vector<std::pair<int, int>> &fixed_variables);
+  // The maximum flow must have been computed already. The strongly connected
+  // components are found in parallel if parallel_components is true, and with
+  // Tarjan's algorithm otherwise.
+  void
+  fixStrongAndWeakVariables(std::vector<std::pair<int, int>> &fixed_variables,
+                            workspace_t &workspace, bool parallel_components);
 
   void createImplicationNetworkEdges(int from_vertex, int to_vertex,
                                      capacity_t capacity);
 
+  // Find the edge out of from_vertex that goes to to_vertex_base or to its
+  // complement, there is at most one. Returns the end of the out edges if
+  // there is none.
+  edge_iterator findEdge(int from_vertex, int to_vertex_base);
+
+  // Set the capacity of the edges created for a term, see
+  // createImplicationNetworkEdges. Returns false if the flow could not be
+  // cancelled, see cancelFlow.
+  bool setTermCapacity(int from_vertex, edge_iterator eit, capacity_t capacity,
+                       workspace_t &workspace);
+
+  bool setEdgeCapacity(int from_vertex, edge_iterator eit, capacity_t capacity,
+                       workspace_t &workspace);
+
+  // Reduce the flow on an edge by amount, keeping the flow valid. Returns false
+  // if there is no cycle of flow through the edge, which only happens if the
+  // flow was not valid, in which case it is left partly cancelled.
+  bool cancelFlow(int from_vertex, edge_iterator eit, capacity_t amount,
+                  workspace_t &workspace);
+
   int _num_variables;
   int _num_vertices;
   int _source;
   int _sink;
   bool _adjacency_list_valid;
+  bool _reusable;
   mapper_t _mapper;
-  std::vector<std::vector<ImplicationEdge<capacity_t>>> _adjacency_list;
+  compressed_adjacency_list<edge_type> _adjacency_list;
 };
 
-template <class capacity_t>
+template <class capacity_t, bool compact_edges>
 template <class PosiformInfo>
-ImplicationNetwork<capacity_t>::ImplicationNetwork(PosiformInfo &posiform) {
-  assert(std::is_integral<capacity_t>::value &&
-         std::is_signed<capacity_t>::value &&
+ImplicationNetwork<capacity_t, compact_edges>::ImplicationNetwork(
+    PosiformInfo &posiform, bool reusable)
+    : _reusable(reusable) {
+  assert(is_signed_integral<capacity_t>::value &&
          "Implication Network must have signed, integral type coefficients");
   assert(
       (std::numeric_limits<capacity_t>::max() >=
@@ -265,12 +423,14 @@ ImplicationNetwork<capacity_t>::ImplicationNetwork(PosiformInfo &posiform) {
   _num_vertices = _mapper.num_vertices();
   _source = _mapper.source();
   _sink = _mapper.sink();
-  _adjacency_list.resize(2 * _num_variables + 2);
 
-  // For efficiency we preallocate the vectors first.
+  // The edges are stored contiguously, so we first count the out-degrees of
+  // the vertices exactly. Each linear term adds an edge out of the source and
+  // one out of the sink.
+  std::vector<std::size_t> out_degrees(_num_vertices, 0);
   int num_linear = posiform.getNumLinear();
-  _adjacency_list[_source].reserve(num_linear);
-  _adjacency_list[_sink].reserve(num_linear);
+  out_degrees[_source] = num_linear;
+  out_degrees[_sink] = num_linear;
 
   // There are reverse edges for each edge created in the implication graph.
   // Depending on the sign of the bias, an edge may start from v or v' but
@@ -285,39 +445,30 @@ ImplicationNetwork<capacity_t>::ImplicationNetwork(PosiformInfo &posiform) {
     if (linear) {
       num_out_edges++;
     }
-    _adjacency_list[from_vertex].reserve(num_out_edges);
-    _adjacency_list[from_vertex_complement].reserve(num_out_edges);
-  }
-
-  for (int variable = 0; variable < _num_variables; variable++) {
-    int from_vertex = _mapper.variable_to_vertex(variable);
-    // int from_vertex_complement = _mapper.complement(from_vertex);
-    auto quadratic_span = posiform.getQuadratic(variable);
-    auto it = quadratic_span.first;
-    auto it_end = quadratic_span.second;
-    for (; it != it_end; it++) {
-      // The quadratic iterators, in the posiform, belong  to the original
-      // bqm, thus the variables, must be mapped to the posiform variables,
-      // and the biases should be ideally converted to the same type the
-      // posiform represens them in.
-      // IMPORTANT NOTE : We skip dividing by 2 when calculating the implication
-      // netowrk edge capacities to avoid rounding errors, but when we compute
-      // the max flow and convert it back to a lower bound for the bqm, we must
-      // take this into account and divide the max flow by 2.
-      // See bottom of page 5 after equation 5 of the following paper.
-      // Boros, Endre & Hammer, Peter & Tavares, Gabriel. (2006). Preprocessing of
-      // unconstrained quadratic binary optimization. RUTCOR Research Report.
-      auto coefficient = posiform.convertToPosiformCoefficient(it->bias);
-      int variable_2 = posiform.mapVariableQuboToPosiform(it->v);
-      int to_vertex = _mapper.variable_to_vertex(variable_2);
-      if (coefficient > 0) {
-        createImplicationNetworkEdges(
-            from_vertex, _mapper.complement(to_vertex), coefficient);
-      } else if (coefficient < 0) {
-        createImplicationNetworkEdges(from_vertex, to_vertex, -coefficient);
-      }
-    }
+    out_degrees[from_vertex] = num_out_edges;
+    out_degrees[from_vertex_complement] = num_out_edges;
   }
+  _adjacency_list = compressed_adjacency_list<edge_type>(
+      out_degrees);
+
+  // IMPORTANT NOTE : We skip dividing by 2 when calculating the implication
+  // netowrk edge capacities to avoid rounding errors, but when we compute the
+  // max flow and convert it back to a lower bound for the bqm, we must take
+  // this into account and divide the max flow by 2.
+  // See bottom of page 5 after equation 5 of the following paper.
+  // Boros, Endre & Hammer, Peter & Tavares, Gabriel. (2006). Preprocessing of
+  // unconstrained quadratic binary optimization. RUTCOR Research Report.
+  posiform.forEachQuadratic(
+      [&](int variable, int variable_2, capacity_t coefficient) {
+        int from_vertex = _mapper.variable_to_vertex(variable);
+        int to_vertex = _mapper.variable_to_vertex(variable_2);
+        if (coefficient > 0) {
+          createImplicationNetworkEdges(
+              from_vertex, _mapper.complement(to_vertex), coefficient);
+        } else {
+          createImplicationNetworkEdges(from_vertex, to_vertex, -coefficient);
+        }
+      });
 
   // We separate out the creation of edges with source and sink, as if the
   // mapping of variables to vertices is ordered such that if variable x <
@@ -336,51 +487,87 @@ ImplicationNetwork<capacity_t>::ImplicationNetwork(PosiformInfo &posiform) {
       createImplicationNetworkEdges(_source, from_vertex, -linear);
     }
   }
+  _adjacency_list.finalize();
   _adjacency_list_valid = true;
 }
 
 // Each term in posiform produces four edges in implication network
 // the reverse edges and the symmetric edges.
-template <class capacity_t>
-void ImplicationNetwork<capacity_t>::createImplicationNetworkEdges(
-    int from_vertex, int to_vertex, capacity_t capacity) {
+template <class capacity_t, bool compact_edges>
+void ImplicationNetwork<capacity_t, compact_edges>::
+    createImplicationNetworkEdges(int from_vertex, int to_vertex,
+                                  capacity_t capacity) {
   int from_vertex_complement = _mapper.complement(from_vertex);
   int to_vertex_complement = _mapper.complement(to_vertex);
-  int from_vertex_edge_index = _adjacency_list[from_vertex].size();
-  int to_vertex_edge_index = _adjacency_list[to_vertex].size();
+  int from_vertex_edge_index = _adjacency_list.next_index(from_vertex);
+  int to_vertex_edge_index = _adjacency_list.next_index(to_vertex);
   int from_vertex_complement_edge_index =
-      _adjacency_list[from_vertex_complement].size();
+      _adjacency_list.next_index(from_vertex_complement);
   int to_vertex_complement_edge_index =
-      _adjacency_list[to_vertex_complement].size();
+      _adjacency_list.next_index(to_vertex_complement);
 
   // edge
-  _adjacency_list[from_vertex].emplace_back(ImplicationEdge<capacity_t>(
-      from_vertex, to_vertex, capacity, 0, to_vertex_edge_index,
-      to_vertex_complement_edge_index));
+  _adjacency_list.emplace_back(from_vertex, from_vertex, to_vertex, capacity,
+                               0, to_vertex_edge_index,
+                               to_vertex_complement_edge_index);
 
   // reverse edge
-  _adjacency_list[to_vertex].emplace_back(ImplicationEdge<capacity_t>(
-      to_vertex, from_vertex, 0, capacity, from_vertex_edge_index,
-      from_vertex_complement_edge_index));
+  _adjacency_list.emplace_back(to_vertex, to_vertex, from_vertex, 0, capacity,
+                               from_vertex_edge_index,
+                               from_vertex_complement_edge_index);
 
   // symmetric edge
-  _adjacency_list[to_vertex_complement].emplace_back(
-      ImplicationEdge<capacity_t>(
-          to_vertex_complement, from_vertex_complement, capacity, 0,
-          from_vertex_complement_edge_index, from_vertex_edge_index));
+  _adjacency_list.emplace_back(to_vertex_complement, to_vertex_complement,
+                               from_vertex_complement, capacity, 0,
+                               from_vertex_complement_edge_index,
+                               from_vertex_edge_index);
 
   // reverse symmetric edge
-  _adjacency_list[from_vertex_complement].emplace_back(
-      ImplicationEdge<capacity_t>(from_vertex_complement, to_vertex_complement,
-                                  0, capacity, to_vertex_complement_edge_index,
-                                  to_vertex_edge_index));
+  _adjacency_list.emplace_back(from_vertex_complement, from_vertex_complement,
+                               to_vertex_complement, 0, capacity,
+                               to_vertex_complement_edge_index,
+                               to_vertex_edge_index);
+}
+
+template <class capacity_t, bool compact_edges>
+template <template <class> class MaxFlowSolver>
+MaxFlowSolver<typename ImplicationNetwork<capacity_t, compact_edges>::edge_type>
+ImplicationNetwork<capacity_t, compact_edges>::createMaxFlowSolver(
+    workspace_t *workspace) {
+  using solver_type = MaxFlowSolver<edge_type>;
+  if constexpr (std::is_same<solver_type, PushRelabelSolver<edge_type>>::value ||
+                std::is_same<solver_type,
+                             ParallelPushRelabelSolver<edge_type>>::value) {
+    return solver_type(_adjacency_list, _source, _sink,
+                       workspace ? &workspace->push_relabel : nullptr);
+  } else if constexpr (std::is_same<solver_type,
+                                    BoykovKolmogorovSolver<edge_type>>::value) {
+    return solver_type(_adjacency_list, _source, _sink,
+                       workspace ? &workspace->boykov_kolmogorov : nullptr);
+  } else {
+    return solver_type(_adjacency_list, _source, _sink);
+  }
+}
+
+// Compute the maximum flow, leaving the flow in the residuals of the edges.
+template <class capacity_t, bool compact_edges>
+template <template <class> class MaxFlowSolver>
+capacity_t ImplicationNetwork<capacity_t, compact_edges>::computeMaximumFlow(
+    workspace_t *workspace) {
+  checkAdjacencyListValidity();
+  MaxFlowSolver<edge_type> solver =
+      createMaxFlowSolver<MaxFlowSolver>(workspace);
+  capacity_t max_flow = solver.computeMaximumFlow(false);
+  assert(isMaximumFlow(_adjacency_list, _source, _sink).second &&
+         "Maximum flow is not valid.");
+  return max_flow;
 }
 
 // Make the residual network symmetric, by summing the residual capacities and
 // original capacities of the implicaiton network. Here we multiply the
 // capacities by 2, since the symmetric edges have same capacity.
-template <class capacity_t>
-void ImplicationNetwork<capacity_t>::makeResidualSymmetric() {
+template <class capacity_t, bool compact_edges>
+void ImplicationNetwork<capacity_t, compact_edges>::makeResidualSymmetric() {
   checkAdjacencyListValidity();
   // If the edges are sorted even if we create edges to/from vertices
   // corresponding to variables and their complements.
@@ -432,54 +619,63 @@ void ImplicationNetwork<capacity_t>::makeResidualSymmetric() {
 // more vertices/edges will fit into the cache due to smaller memory footprint
 // of the extracted graph and also due to the fact that we can reduce the cost
 // of extraction using multiple threads.
-template <class capacity_t>
-void ImplicationNetwork<capacity_t>::
+template <class capacity_t, bool compact_edges>
+void ImplicationNetwork<capacity_t, compact_edges>::
     extractResidualNetworkWithoutSourceInSinkOut(
-        std::vector<std::vector<int>> &adjacency_list_residual,
+        compressed_adjacency_list<int> &adjacency_list_residual,
         bool free_original_adjacency_list) {
   checkAdjacencyListValidity();
-  adjacency_list_residual.resize(_num_vertices);
-#pragma omp parallel
-  {
-    std::vector<int> temp_buffer(_num_vertices);
-#pragma omp for
-    for (int vertex = 0; vertex < _num_vertices; vertex++) {
-      if (vertex != _sink) {
-        int num_residual_out_edges = 0;
-        auto eit = _adjacency_list[vertex].begin();
-        auto eit_end = _adjacency_list[vertex].end();
-        for (; eit != eit_end; eit++) {
-          if (eit->residual > 0) {
-            if (eit->to_vertex != _source) {
-              temp_buffer[num_residual_out_edges++] = eit->to_vertex;
-            }
-          }
+
+  // The residual edges are counted first, so they can be written in place in
+  // one contiguous array.
+  std::vector<std::size_t> num_residual_out_edges(_num_vertices, 0);
+#pragma omp parallel for
+  for (int vertex = 0; vertex < _num_vertices; vertex++) {
+    if (vertex != _sink) {
+      auto eit = _adjacency_list[vertex].begin();
+      auto eit_end = _adjacency_list[vertex].end();
+      for (; eit != eit_end; eit++) {
+        if ((eit->residual > 0) && (eit->to_vertex != _source)) {
+          num_residual_out_edges[vertex]++;
         }
-        adjacency_list_residual[vertex].assign(
-            temp_buffer.begin(), temp_buffer.begin() + num_residual_out_edges);
       }
-      if (free_original_adjacency_list) {
-        std::vector<ImplicationEdge<capacity_t>>().swap(
-            _adjacency_list[vertex]);
+    }
+  }
+
+  adjacency_list_residual =
+      compressed_adjacency_list<int>(num_residual_out_edges, true);
+  std::vector<std::size_t>().swap(num_residual_out_edges);
+
+#pragma omp parallel for
+  for (int vertex = 0; vertex < _num_vertices; vertex++) {
+    if (vertex != _sink) {
+      auto residual_out_edges = adjacency_list_residual[vertex];
+      std::size_t num_out_edges = 0;
+      auto eit = _adjacency_list[vertex].begin();
+      auto eit_end = _adjacency_list[vertex].end();
+      for (; eit != eit_end; eit++) {
+        if ((eit->residual > 0) && (eit->to_vertex != _source)) {
+          residual_out_edges[num_out_edges++] = eit->to_vertex;
+        }
       }
     }
   }
 
   if (free_original_adjacency_list) {
-    std::vector<std::vector<ImplicationEdge<capacity_t>>>().swap(
-        _adjacency_list);
+    _adjacency_list.clear();
     _adjacency_list_valid = false;
   }
 }
 
 // Fix only variables relevant to a strongly connected component.
-template <class capacity_t>
-void ImplicationNetwork<capacity_t>::fixStronglyConnectedComponentVariables(
-    int component, stronglyConnectedComponentsInfo &scc_info,
-    std::vector<std::vector<int>> &adjacency_list_components_transposed,
-    std::vector<int> &out_degrees,
-    std::vector<std::pair<int, int>> &fixed_variables,
-    vector_based_queue<int> &component_queue, bool enqueue) {
+template <class capacity_t, bool compact_edges>
+void ImplicationNetwork<capacity_t, compact_edges>::
+    fixStronglyConnectedComponentVariables(
+        int component, stronglyConnectedComponentsInfo &scc_info,
+        std::vector<std::vector<int>> &adjacency_list_components_transposed,
+        std::vector<int> &out_degrees,
+        std::vector<std::pair<int, int>> &fixed_variables,
+        vector_based_queue<int> &component_queue, bool enqueue) {
 
   auto &components = scc_info.components;
   auto &complement_map = scc_info.complement_map;
@@ -542,28 +738,44 @@ void ImplicationNetwork<capacity_t>::fixStronglyConnectedComponentVariables(
 // outdegree and is of not self complementing type, that is vertices and their
 // complements both do not exist in the same component, it becomes a candidate
 // for the fixing process.
-template <class capacity_t>
-capacity_t ImplicationNetwork<capacity_t>::fixStrongAndWeakVariables(
-    std::vector<std::pair<int, int>> &fixed_variables) {
-
-  PushRelabelSolver<ImplicationEdge<capacity_t>> push_relabel_solver(
-      _adjacency_list, _source, _sink);
-  capacity_t max_flow = push_relabel_solver.computeMaximumFlow(false);
-  assert(isMaximumFlow(_adjacency_list, _source, _sink).second &&
-         "Maximum flow is not valid.");
-
+template <class capacity_t, bool compact_edges>
+void ImplicationNetwork<capacity_t, compact_edges>::fixStrongAndWeakVariables(
+    std::vector<std::pair<int, int>> &fixed_variables, workspace_t &workspace,
+    bool parallel_components) {
+  auto start = std::chrono::steady_clock::now();
   makeResidualSymmetric();
   assert(isMaximumFlow(_adjacency_list, _source, _sink).second &&
          "Maximum flow is not valid.");
+  auto symmetrized = std::chrono::steady_clock::now();
+  workspace.timings.symmetrization = symmetrized - start;
 
   // The removal of certain edges will create a component with the source only
   // and another component with the sink only.
-  std::vector<std::vector<int>> adjacency_list_residual;
+  compressed_adjacency_list<int> adjacency_list_residual;
   extractResidualNetworkWithoutSourceInSinkOut(adjacency_list_residual, true);
 
-  std::vector<int> vertex_to_component_map;
-  int num_components = stronglyConnectedComponents(adjacency_list_residual,
-                                                   vertex_to_component_map);
+  // Tarjan's algorithm is inherently serial, so the components are found in
+  // parallel instead when the maximum flow was. The components are the same but
+  // numbered differently, which may change the weakly persistent variables that
+  // get fixed, though not the strong ones. Choosing by the solver rather than by
+  // whether OpenMP is available keeps the results the same for every build.
+  std::vector<int> &vertex_to_component_map = workspace.vertex_to_component_map;
+  int num_components;
+  if (parallel_components) {
+    compressed_adjacency_list<int> adjacency_list_residual_transposed;
+    getTransposedAdjacencyList(adjacency_list_residual,
+                               adjacency_list_residual_transposed);
+    num_components = stronglyConnectedComponentsParallel(
+        adjacency_list_residual, adjacency_list_residual_transposed,
+        vertex_to_component_map, &workspace.graph);
+  } else {
+    num_components = stronglyConnectedComponents(
+        adjacency_list_residual, vertex_to_component_map, &workspace.graph);
+  }
+
+  auto components_found = std::chrono::steady_clock::now();
+  workspace.timings.strongly_connected_components =
+      components_found - symmetrized;
 
   stronglyConnectedComponentsInfo scc_info(num_components,
                                            vertex_to_component_map, _mapper);
@@ -577,14 +789,17 @@ capacity_t ImplicationNetwork<capacity_t>::fixStrongAndWeakVariables(
   getTransposedAdjacencyList(adjacency_list_components,
                              adjacency_list_components_transposed);
 
-  std::vector<int> bfs_depth_values;
-  int UNVISITED = breadthFirstSearch(
-      adjacency_list_components, scc_info.source_component, bfs_depth_values);
+  std::vector<int> &bfs_depth_values = workspace.bfs_depth_values;
+  int UNVISITED = breadthFirstSearch(adjacency_list_components,
+                                     scc_info.source_component,
+                                     bfs_depth_values, &workspace.graph);
 
   auto &complement_map = scc_info.complement_map;
   fixed_variables.reserve(_num_variables);
-  vector_based_queue<int> component_queue(num_components);
-  std::vector<int> out_degrees(num_components, -1);
+  vector_based_queue<int> &component_queue = workspace.component_queue;
+  component_queue.resize(num_components);
+  std::vector<int> &out_degrees = workspace.out_degrees;
+  out_degrees.assign(num_components, -1);
 
   for (int component = 0; component < num_components; component++) {
     if (complement_map[component] != component) {
@@ -617,7 +832,8 @@ capacity_t ImplicationNetwork<capacity_t>::fixStrongAndWeakVariables(
         component, scc_info, adjacency_list_components_transposed, out_degrees,
         fixed_variables, component_queue, true);
   }
-  return max_flow;
+  workspace.timings.fixing =
+      std::chrono::steady_clock::now() - components_found;
 }
 
 // Fix only the strong variables which can be trivially found. That is fix the
@@ -625,19 +841,13 @@ capacity_t ImplicationNetwork<capacity_t>::fixStrongAndWeakVariables(
 // a subset or say the initial part of the algorithm mentioned in the paper :
 // Boros, Endre & Hammer, Peter & Tavares, Gabriel. (2006). Preprocessing of
 // unconstrained quadratic binary optimization. RUTCOR Research Report.
-template <class capacity_t>
-capacity_t ImplicationNetwork<capacity_t>::fixTriviallyStrongVariables(
-    std::vector<std::pair<int, int>> &fixed_variables) {
-
-  PushRelabelSolver<ImplicationEdge<capacity_t>> push_relabel_solver(
-      _adjacency_list, _source, _sink);
-  capacity_t max_flow = push_relabel_solver.computeMaximumFlow(false);
-  assert(isMaximumFlow(_adjacency_list, _source, _sink).second &&
-         "Maximum flow is not valid.");
-
-  std::vector<int> bfs_depth_values;
-  int UNVISITED = breadthFirstSearchResidual(_adjacency_list, _source,
-                                             bfs_depth_values, false, false);
+template <class capacity_t, bool compact_edges>
+void ImplicationNetwork<capacity_t, compact_edges>::fixTriviallyStrongVariables(
+    std::vector<std::pair<int, int>> &fixed_variables, workspace_t &workspace) {
+  std::vector<int> &bfs_depth_values = workspace.bfs_depth_values;
+  int UNVISITED =
+      breadthFirstSearchResidual(_adjacency_list, _source, bfs_depth_values,
+                                 false, false, &workspace.graph);
 
   fixed_variables.reserve(_num_variables);
   std::vector<bool> variable_fixed(_num_variables, false);
@@ -652,23 +862,256 @@ capacity_t ImplicationNetwork<capacity_t>::fixTriviallyStrongVariables(
       fixed_variables.push_back({variable, (vertex == base_vertex) ? 1 : 0});
     }
   }
-  return max_flow;
 }
 
 // Parent function for fixing posiform based variables.
-template <class capacity_t>
-capacity_t ImplicationNetwork<capacity_t>::fixVariables(
+template <class capacity_t, bool compact_edges>
+template <template <class> class MaxFlowSolver>
+capacity_t ImplicationNetwork<capacity_t, compact_edges>::fixVariables(
     std::vector<std::pair<int, int>> &fixed_variables,
-    bool only_trivially_strong) {
+    bool only_trivially_strong, workspace_t *workspace) {
+  // The buffers are allocated for this call only when no workspace is given.
+  workspace_t local_workspace;
+  workspace_t &buffers = workspace ? *workspace : local_workspace;
+  buffers.timings = {};
+  constexpr bool parallel =
+      std::is_same<MaxFlowSolver<edge_type>,
+                   ParallelPushRelabelSolver<edge_type>>::value;
+  auto start = std::chrono::steady_clock::now();
+  capacity_t max_flow = computeMaximumFlow<MaxFlowSolver>(&buffers);
+  buffers.timings.maximum_flow = std::chrono::steady_clock::now() - start;
   if (only_trivially_strong) {
-    return fixTriviallyStrongVariables(fixed_variables);
+    start = std::chrono::steady_clock::now();
+    fixTriviallyStrongVariables(fixed_variables, buffers);
+    buffers.timings.fixing = std::chrono::steady_clock::now() - start;
+  } else if (_reusable) {
+    // Fixing the weak persistencies changes the residuals and frees the edges,
+    // so we keep a copy of the edges holding the maximum flow.
+    compressed_adjacency_list<edge_type> adjacency_list = _adjacency_list;
+    fixStrongAndWeakVariables(fixed_variables, buffers, parallel);
+    _adjacency_list = std::move(adjacency_list);
+    _adjacency_list_valid = true;
   } else {
-    return fixStrongAndWeakVariables(fixed_variables);
+    fixStrongAndWeakVariables(fixed_variables, buffers, parallel);
+  }
+  return max_flow;
+}
+
+template <class capacity_t, bool compact_edges>
+capacity_t ImplicationNetwork<capacity_t, compact_edges>::fixVariables(
+    std::vector<std::pair<int, int>> &fixed_variables,
+    bool only_trivially_strong, MaxFlowAlgorithm algorithm,
+    workspace_t *workspace) {
+  if (algorithm == MaxFlowAlgorithm::AUTOMATIC) {
+    algorithm = selectMaxFlowAlgorithm();
+  }
+  switch (algorithm) {
+  case MaxFlowAlgorithm::PARALLEL_PUSH_RELABEL:
+    return fixVariables<ParallelPushRelabelSolver>(
+        fixed_variables, only_trivially_strong, workspace);
+  case MaxFlowAlgorithm::BOYKOV_KOLMOGOROV:
+    return fixVariables<BoykovKolmogorovSolver>(
+        fixed_variables, only_trivially_strong, workspace);
+  default:
+    return fixVariables<PushRelabelSolver>(fixed_variables,
+                                           only_trivially_strong, workspace);
+  }
+}
+
+template <class capacity_t, bool compact_edges>
+MaxFlowAlgorithm
+ImplicationNetwork<capacity_t, compact_edges>::selectMaxFlowAlgorithm() {
+  checkAdjacencyListValidity();
+  std::size_t num_vertices = _adjacency_list.size();
+  if (_adjacency_list.num_edges() <= SPARSE_AVERAGE_DEGREE * num_vertices) {
+    return MaxFlowAlgorithm::BOYKOV_KOLMOGOROV;
+  }
+  return MaxFlowAlgorithm::PUSH_RELABEL;
+}
+
+template <class capacity_t, bool compact_edges>
+typename ImplicationNetwork<capacity_t, compact_edges>::edge_iterator
+ImplicationNetwork<capacity_t, compact_edges>::findEdge(int from_vertex,
+                                                        int to_vertex_base) {
+  auto eit = _adjacency_list[from_vertex].begin();
+  auto eit_end = _adjacency_list[from_vertex].end();
+  if (_mapper.complement_maintains_order()) {
+    // The edges are sorted, see makeResidualSymmetric.
+    eit = std::lower_bound(eit, eit_end, to_vertex_base,
+                           ImplicationEdgeComparator());
+    if (eit != eit_end &&
+        _mapper.non_complemented_vertex(eit->to_vertex) == to_vertex_base) {
+      return eit;
+    }
+    return eit_end;
+  }
+  for (; eit != eit_end; eit++) {
+    if (_mapper.non_complemented_vertex(eit->to_vertex) == to_vertex_base) {
+      return eit;
+    }
+  }
+  return eit_end;
+}
+
+template <class capacity_t, bool compact_edges>
+bool ImplicationNetwork<capacity_t, compact_edges>::setLinearCoefficient(
+    int variable, capacity_t coefficient, workspace_t *workspace) {
+  checkAdjacencyListValidity();
+  int vertex = _mapper.variable_to_vertex(variable);
+  auto eit = findEdge(_source, vertex);
+  if (eit == _adjacency_list[_source].end()) {
+    return !coefficient;
+  }
+  // See the constructor for the direction of the edges.
+  if ((coefficient > 0 && eit->to_vertex == vertex) ||
+      (coefficient < 0 && eit->to_vertex != vertex)) {
+    return false;
+  }
+  // The buffers are allocated for this call only when no workspace is given.
+  workspace_t local_workspace;
+  return setTermCapacity(_source, eit,
+                         (coefficient > 0) ? coefficient : -coefficient,
+                         workspace ? *workspace : local_workspace);
+}
+
+template <class capacity_t, bool compact_edges>
+bool ImplicationNetwork<capacity_t, compact_edges>::setQuadraticCoefficient(
+    int variable_1, int variable_2, capacity_t coefficient,
+    workspace_t *workspace) {
+  checkAdjacencyListValidity();
+  // The posiform's quadratic terms go from the smaller variable.
+  if (variable_1 > variable_2) {
+    std::swap(variable_1, variable_2);
+  }
+  int from_vertex = _mapper.variable_to_vertex(variable_1);
+  int to_vertex = _mapper.variable_to_vertex(variable_2);
+  auto eit = findEdge(from_vertex, to_vertex);
+  if (eit == _adjacency_list[from_vertex].end()) {
+    return !coefficient;
+  }
+  if ((coefficient > 0 && eit->to_vertex == to_vertex) ||
+      (coefficient < 0 && eit->to_vertex != to_vertex)) {
+    return false;
+  }
+  workspace_t local_workspace;
+  return setTermCapacity(from_vertex, eit,
+                         (coefficient > 0) ? coefficient : -coefficient,
+                         workspace ? *workspace : local_workspace);
+}
+
+template <class capacity_t, bool compact_edges>
+bool ImplicationNetwork<capacity_t, compact_edges>::setTermCapacity(
+    int from_vertex, edge_iterator eit, capacity_t capacity,
+    workspace_t &workspace) {
+  int symmetric_from_vertex = _mapper.complement(eit->to_vertex);
+  auto symmetric_eit =
+      _adjacency_list[symmetric_from_vertex].begin() + eit->symmetric_edge_index;
+  return setEdgeCapacity(from_vertex, eit, capacity, workspace) &&
+         setEdgeCapacity(symmetric_from_vertex, symmetric_eit, capacity,
+                         workspace);
+}
+
+template <class capacity_t, bool compact_edges>
+bool ImplicationNetwork<capacity_t, compact_edges>::setEdgeCapacity(
+    int from_vertex, edge_iterator eit, capacity_t capacity,
+    workspace_t &workspace) {
+  auto reverse_eit =
+      _adjacency_list[eit->to_vertex].begin() + eit->reverse_edge_index;
+  // The reverse edge has no capacity of its own, so its residual is the flow.
+  if (reverse_eit->residual > capacity &&
+      !cancelFlow(from_vertex, eit, reverse_eit->residual - capacity,
+                  workspace)) {
+    return false;
+  }
+  eit->setCapacity(capacity);
+  eit->residual = capacity - reverse_eit->residual;
+  reverse_eit->setReverseEdgeCapacity(capacity);
+  return true;
+}
+
+// A flow decomposes into flows along paths from the source to the sink and
+// around cycles, so if we add an edge from the sink to the source, every edge
+// with flow is on a cycle of edges with flow. We find such cycles through
+// the edge by breadth first search from the vertex it goes to and reduce the
+// flow around them until enough has been cancelled. Each cycle either cancels
+// what is left or removes the flow of an edge on it, so the number of searches
+// is bounded by the number of edges, but it is usually one or two.
+template <class capacity_t, bool compact_edges>
+bool ImplicationNetwork<capacity_t, compact_edges>::cancelFlow(
+    int from_vertex, edge_iterator eit, capacity_t amount,
+    workspace_t &workspace) {
+  const int UNVISITED = -1;
+  std::vector<int> &parents = workspace.cancel_parents;
+  std::vector<edge_type *> &parent_edges = workspace.cancel_parent_edges;
+  std::vector<int> &visited = workspace.cancel_visited;
+  if (parents.size() < static_cast<std::size_t>(_num_vertices)) {
+    parents.resize(_num_vertices, UNVISITED);
+    parent_edges.resize(_num_vertices, nullptr);
+  }
+
+  auto visit = [&](int vertex, int parent, edge_type *edge) {
+    parents[vertex] = parent;
+    parent_edges[vertex] = edge;
+    visited.push_back(vertex);
+  };
+
+  bool found = true;
+  while (amount > 0) {
+    // The visited vertices double as the queue of the search.
+    visited.clear();
+    visit(eit->to_vertex, eit->to_vertex, nullptr);
+    for (std::size_t next = 0;
+         next < visited.size() && parents[from_vertex] == UNVISITED; next++) {
+      int vertex = visited[next];
+      if (vertex == _sink && parents[_source] == UNVISITED) {
+        // The edge from the sink to the source, which has no edge_type.
+        visit(_source, _sink, nullptr);
+      }
+      for (auto &edge : _adjacency_list[vertex]) {
+        if (edge.getFlow() > 0 && parents[edge.to_vertex] == UNVISITED) {
+          visit(edge.to_vertex, vertex, &edge);
+        }
+      }
+    }
+
+    // An edge with flow is on a cycle of edges with flow, unless the flow is
+    // not valid.
+    found = parents[from_vertex] != UNVISITED;
+    if (found) {
+      capacity_t flow = amount;
+      for (int vertex = from_vertex; vertex != eit->to_vertex;
+           vertex = parents[vertex]) {
+        if (parent_edges[vertex]) {
+          flow = std::min(flow, parent_edges[vertex]->getFlow());
+        }
+      }
+
+      for (int vertex = from_vertex; vertex != eit->to_vertex;
+           vertex = parents[vertex]) {
+        edge_type *edge = parent_edges[vertex];
+        if (edge) {
+          edge->residual += flow;
+          _adjacency_list[vertex][edge->reverse_edge_index].residual -= flow;
+        }
+      }
+      eit->residual += flow;
+      _adjacency_list[eit->to_vertex][eit->reverse_edge_index].residual -= flow;
+      amount -= flow;
+    }
+
+    for (int vertex : visited) {
+      parents[vertex] = UNVISITED;
+    }
+    if (!found) {
+      break;
+    }
   }
+  return found;
 }
 
 // For debugging.
-template <class capacity_t> void ImplicationNetwork<capacity_t>::print() {
+template <class capacity_t, bool compact_edges>
+void ImplicationNetwork<capacity_t, compact_edges>::print() {
   checkAdjacencyListValidity();
   std::cout << std::endl;
   std::cout << "Implication Graph Information : " << std::endl;
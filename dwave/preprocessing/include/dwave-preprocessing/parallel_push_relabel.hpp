@@ -0,0 +1,410 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PARALLEL_PUSH_RELABEL_HPP_INCLUDED
+#define PARALLEL_PUSH_RELABEL_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include "push_relabel.hpp"
+
+// Maximum flow solver based on the synchronous parallel Push-Relabel algorithm
+// of Baumstark, N., Blelloch, G., Shun, J. Efficient Implementation of a
+// Synchronous Parallel Push-Relabel Algorithm. ESA 2015, 106-117.
+// https://doi.org/10.1007/978-3-662-48350-3_10.
+//
+// In each round all the active vertices are discharged in parallel against the
+// heights of the previous round. A vertex only ever decreases the residual of
+// its own out edges and the excess it receives is buffered until the end of
+// the round, so the residuals and excesses stay consistent whatever the order
+// in which the threads run. When two active vertices could push to each other
+// only the one that wins the tie break below does. Global relabeling is done
+// with a parallel breadth first search.
+//
+// The preflow is converted to a flow the same way as in PushRelabelSolver.
+// Without OpenMP the rounds are run serially, which is slower than
+// PushRelabelSolver but gives the same maximum flow value. The flow found may
+// differ from run to run when multiple threads are used.
+template <class EdgeType>
+class ParallelPushRelabelSolver : public PushRelabelSolver<EdgeType> {
+public:
+  using base_type = PushRelabelSolver<EdgeType>;
+  using edge_iterator = typename base_type::edge_iterator;
+  using capacity_t = typename EdgeType::capacity_type;
+
+  // The buffers of the base class and those used by the rounds, see
+  // PushRelabelSolver::workspace_t.
+  struct workspace_t : base_type::workspace_t {
+    std::vector<int> active_vertices;
+    std::vector<int> next_active_vertices;
+    std::vector<int> discovered_vertices;
+    std::vector<int> is_active;
+    std::vector<int> is_discovered;
+    std::vector<int> new_heights;
+    std::vector<capacity_t> new_excess;
+    std::vector<capacity_t> added_excess;
+  };
+
+  ParallelPushRelabelSolver(compressed_adjacency_list<EdgeType> &adjacency_list,
+                            int source, int sink,
+                            workspace_t *workspace = nullptr);
+
+  capacity_t computeMaximumPreflow();
+
+  capacity_t computeMaximumFlow(bool handle_self_loops = false);
+
+private:
+  // Discharge a vertex against the heights of the previous round, saving its
+  // new height and excess so they can be applied at the end of the round.
+  // Vertices that received flow are appended to discovered.
+  // @returns the work done, in the same units as PushRelabelSolver.
+  std::size_t discharge(int vertex, std::vector<int> &discovered);
+
+  // Run one round over the active vertices and find those of the next round.
+  // @returns the work done.
+  std::size_t dischargeActiveVertices();
+
+  // Relabel the vertices with the current distance from the sink, found by
+  // using a parallel reverse breadth first search.
+  void globalRelabel();
+
+  // Collect all the vertices with excess that are not disconnected from the
+  // sink.
+  void findActiveVertices();
+
+  // When vertex and to_vertex are both active and vertex could push to
+  // to_vertex, whether it may. Only one of two vertices wins against the
+  // other, so they never push to each other in the same round.
+  static bool wins(int vertex, int height, int to_vertex, int to_height) {
+    return (height == to_height + 1) || (height < to_height - 1) ||
+           ((height == to_height) && (vertex < to_vertex));
+  }
+
+  // Used when no workspace was given, the base class then has its own.
+  workspace_t _owned_parallel_workspace;
+  workspace_t &_parallel_workspace;
+
+  std::vector<int> &_active_vertices;
+  std::vector<int> &_next_active_vertices;
+  std::vector<int> &_discovered_vertices;
+
+  // Better not use vector of booleans in parallel regions.
+  std::vector<int> &_is_active;
+  std::vector<int> &_is_discovered;
+
+  std::vector<int> &_new_heights;
+  std::vector<capacity_t> &_new_excess;
+  std::vector<capacity_t> &_added_excess;
+};
+
+// The base class saturates the edges out of the source and does the first
+// global relabeling.
+template <class EdgeType>
+ParallelPushRelabelSolver<EdgeType>::ParallelPushRelabelSolver(
+    compressed_adjacency_list<EdgeType> &adjacency_list, int source, int sink,
+    workspace_t *workspace)
+    : base_type(adjacency_list, source, sink, workspace),
+      _parallel_workspace(workspace ? *workspace : _owned_parallel_workspace),
+      _active_vertices(_parallel_workspace.active_vertices),
+      _next_active_vertices(_parallel_workspace.next_active_vertices),
+      _discovered_vertices(_parallel_workspace.discovered_vertices),
+      _is_active(_parallel_workspace.is_active),
+      _is_discovered(_parallel_workspace.is_discovered),
+      _new_heights(_parallel_workspace.new_heights),
+      _new_excess(_parallel_workspace.new_excess),
+      _added_excess(_parallel_workspace.added_excess) {
+  int num_vertices = this->_num_vertices;
+  _active_vertices.clear();
+  _is_active.assign(num_vertices, false);
+  _is_discovered.assign(num_vertices, false);
+  _new_heights.assign(num_vertices, 0);
+  _new_excess.assign(num_vertices, 0);
+  _added_excess.assign(num_vertices, 0);
+}
+
+template <class EdgeType>
+std::size_t
+ParallelPushRelabelSolver<EdgeType>::discharge(int vertex,
+                                               std::vector<int> &discovered) {
+  auto &vertices = this->_vertices;
+  auto &adjacency_list = this->_adjacency_list;
+  const int num_vertices = this->_num_vertices;
+  const int old_height = vertices[vertex].height;
+  int height = old_height;
+  capacity_t excess = vertices[vertex].excess;
+  std::size_t work = 0;
+
+  edge_iterator eit_begin, eit_end;
+  std::tie(eit_begin, eit_end) = this->outEdges(vertex);
+  while (excess > 0) {
+    int min_relabel_height = num_vertices;
+    bool skipped = false;
+    work += base_type::BETA + std::distance(eit_begin, eit_end);
+    for (auto eit = eit_begin; eit != eit_end; eit++) {
+      if (!excess) {
+        break;
+      }
+
+      // Only this vertex decreases the residual of its out edges, but the
+      // vertex at the other end may be increasing it.
+      capacity_t residual;
+#pragma omp atomic read
+      residual = eit->residual;
+      if (!residual) {
+        continue;
+      }
+
+      int to_vertex = eit->to_vertex;
+      int to_height = vertices[to_vertex].height;
+      if (height == to_height + 1) {
+        if (_is_active[to_vertex] &&
+            !wins(vertex, old_height, to_vertex, to_height)) {
+          skipped = true;
+          continue;
+        }
+
+        DEBUG_INCREMENT(this->_num_pushes);
+        capacity_t flow = std::min(residual, excess);
+#pragma omp atomic
+        eit->residual -= flow;
+#pragma omp atomic
+        adjacency_list[to_vertex][eit->reverse_edge_index].residual += flow;
+        excess -= flow;
+        residual -= flow;
+
+        int was_discovered;
+#pragma omp atomic capture
+        {
+          was_discovered = _is_discovered[to_vertex];
+          _is_discovered[to_vertex] = true;
+        }
+        if (!was_discovered) {
+          discovered.push_back(to_vertex);
+        }
+#pragma omp atomic
+        _added_excess[to_vertex] += flow;
+      }
+
+      if (residual) {
+        min_relabel_height = std::min(min_relabel_height, to_height + 1);
+      }
+    }
+
+    // The vertex lost against a neighbour, it will try again next round.
+    if (!excess || skipped) {
+      break;
+    }
+
+    // The heights of the neighbours are those of the previous round so the
+    // labeling may not be valid, but a height never decreases outside of the
+    // global relabeling.
+    DEBUG_INCREMENT(this->_num_relabels);
+    height = std::max(height + 1, min_relabel_height);
+    if (height >= num_vertices) {
+      height = num_vertices;
+      break;
+    }
+  }
+
+  _new_heights[vertex] = height;
+  _new_excess[vertex] = excess;
+  return work;
+}
+
+template <class EdgeType>
+std::size_t ParallelPushRelabelSolver<EdgeType>::dischargeActiveVertices() {
+  auto &vertices = this->_vertices;
+  const int num_vertices = this->_num_vertices;
+  const int sink = this->_sink;
+  const std::ptrdiff_t num_active = _active_vertices.size();
+  std::size_t work = 0;
+
+  _discovered_vertices.clear();
+#pragma omp parallel reduction(+ : work)
+  {
+    std::vector<int> discovered;
+#pragma omp for schedule(dynamic, 64)
+    for (std::ptrdiff_t i = 0; i < num_active; i++) {
+      work += discharge(_active_vertices[i], discovered);
+    }
+#pragma omp critical
+    _discovered_vertices.insert(_discovered_vertices.end(), discovered.begin(),
+                                discovered.end());
+  }
+
+  const std::ptrdiff_t num_discovered = _discovered_vertices.size();
+  _next_active_vertices.clear();
+#pragma omp parallel
+  {
+    std::vector<int> next_active;
+
+    // Vertices that were also discovered are handled in the next loop.
+#pragma omp for
+    for (std::ptrdiff_t i = 0; i < num_active; i++) {
+      int vertex = _active_vertices[i];
+      vertices[vertex].height = _new_heights[vertex];
+      vertices[vertex].excess = _new_excess[vertex];
+      _is_active[vertex] = false;
+      if (!_is_discovered[vertex] && vertices[vertex].excess > 0 &&
+          vertices[vertex].height < num_vertices) {
+        next_active.push_back(vertex);
+      }
+    }
+
+#pragma omp for
+    for (std::ptrdiff_t i = 0; i < num_discovered; i++) {
+      int vertex = _discovered_vertices[i];
+      vertices[vertex].excess += _added_excess[vertex];
+      _added_excess[vertex] = 0;
+      _is_discovered[vertex] = false;
+      if (vertex != sink && vertices[vertex].height < num_vertices) {
+        next_active.push_back(vertex);
+      }
+    }
+
+#pragma omp critical
+    _next_active_vertices.insert(_next_active_vertices.end(),
+                                 next_active.begin(), next_active.end());
+  }
+
+  _active_vertices.swap(_next_active_vertices);
+  for (int vertex : _active_vertices) {
+    _is_active[vertex] = true;
+  }
+  return work;
+}
+
+// Level synchronous reverse breadth first search from the sink. The vertices
+// are claimed with an atomic test and set so each is labeled by one thread.
+template <class EdgeType>
+void ParallelPushRelabelSolver<EdgeType>::globalRelabel() {
+  DEBUG_INCREMENT(this->_num_global_relabels);
+  auto &vertices = this->_vertices;
+  const int num_vertices = this->_num_vertices;
+  auto &visited = _is_discovered;
+
+#pragma omp parallel for
+  for (int vertex = 0; vertex < num_vertices; vertex++) {
+    vertices[vertex].height = num_vertices;
+    visited[vertex] = false;
+  }
+  vertices[this->_sink].height = 0;
+  visited[this->_sink] = true;
+  visited[this->_source] = true;
+
+  std::vector<int> frontier = {this->_sink};
+  std::vector<int> next_frontier;
+  int height = 0;
+  while (!frontier.empty()) {
+    height++;
+    next_frontier.clear();
+    const std::ptrdiff_t frontier_size = frontier.size();
+#pragma omp parallel
+    {
+      std::vector<int> found;
+#pragma omp for schedule(dynamic, 64)
+      for (std::ptrdiff_t i = 0; i < frontier_size; i++) {
+        edge_iterator eit, eit_end;
+        for (std::tie(eit, eit_end) = this->outEdges(frontier[i]);
+             eit != eit_end; eit++) {
+          if (!eit->getReverseEdgeResidual()) {
+            continue;
+          }
+          int to_vertex = eit->to_vertex;
+          int was_visited;
+#pragma omp atomic capture
+          {
+            was_visited = visited[to_vertex];
+            visited[to_vertex] = true;
+          }
+          if (!was_visited) {
+            vertices[to_vertex].height = height;
+            found.push_back(to_vertex);
+          }
+        }
+      }
+#pragma omp critical
+      next_frontier.insert(next_frontier.end(), found.begin(), found.end());
+    }
+    frontier.swap(next_frontier);
+  }
+
+#pragma omp parallel for
+  for (int vertex = 0; vertex < num_vertices; vertex++) {
+    visited[vertex] = false;
+  }
+}
+
+template <class EdgeType>
+void ParallelPushRelabelSolver<EdgeType>::findActiveVertices() {
+  auto &vertices = this->_vertices;
+  const int num_vertices = this->_num_vertices;
+  std::fill(_is_active.begin(), _is_active.end(), false);
+  _active_vertices.clear();
+  for (int vertex = 0; vertex < num_vertices; vertex++) {
+    if (vertex != this->_source && vertex != this->_sink &&
+        vertices[vertex].excess > 0 && vertices[vertex].height < num_vertices) {
+      _active_vertices.push_back(vertex);
+      _is_active[vertex] = true;
+    }
+  }
+}
+
+// Compute the maximum preflow. Since the heights used in a round are those of
+// the previous round, the labeling may not be valid when there are no active
+// vertices left. So we only stop after a global relabeling, which computes the
+// exact distances from the sink, finds no vertex with excess that can still
+// reach the sink.
+template <class EdgeType>
+typename EdgeType::capacity_type
+ParallelPushRelabelSolver<EdgeType>::computeMaximumPreflow() {
+  findActiveVertices();
+  std::size_t relabel_work = 0;
+  while (true) {
+    if (_active_vertices.empty()) {
+      globalRelabel();
+      findActiveVertices();
+      relabel_work = 0;
+      if (_active_vertices.empty()) {
+        break;
+      }
+    }
+
+    relabel_work += dischargeActiveVertices();
+
+    if (relabel_work * base_type::GLOBAL_RELABEL_FREQUENCY >
+        this->GLOBAL_RELABEL_THRESHOLD) {
+      globalRelabel();
+      findActiveVertices();
+      relabel_work = 0;
+    }
+  }
+  return this->_vertices[this->_sink].excess;
+}
+
+// The top level function to compute max-flow and also convert the preflow to
+// flow so that the resulting graph is a valid flow network.
+template <class EdgeType>
+typename EdgeType::capacity_type
+ParallelPushRelabelSolver<EdgeType>::computeMaximumFlow(
+    bool handle_self_loops) {
+  capacity_t maximum_flow = computeMaximumPreflow();
+  this->convertPreflowToFlow(handle_self_loops);
+  return maximum_flow;
+}
+
+#endif // PARALLEL_PUSH_RELABEL_HPP_INCLUDED
@@ -23,6 +23,9 @@
 #include <utility>
 #include <vector>
 
+#include "bias_statistics.hpp"
+#include "capacity_type_traits.hpp"
+
 /**
  * Contains all the information needed to recreate a posiform corresponding to 
  * a BQM. The intention is to reduce the memory footprint as much as possible, 
@@ -66,9 +69,14 @@ public:
   using variable_type = typename BQM::index_type;
 
   /**
-   * Construct a PosiformInfo from a binary quadratic model.
+   * Construct a PosiformInfo from a binary quadratic model. The coefficients
+   * are scaled so that biases up to headroom times larger than the largest
+   * ones would still fit, which leaves room to change them later. If the
+   * BiasStatistics of the bqm are given, their largest and smallest absolute
+   * values are used rather than tracked while reading the biases.
    */
-  PosiformInfo(const BQM &bqm);
+  PosiformInfo(const BQM &bqm, double headroom = 1,
+               const BiasStatistics<bias_type> *stats = nullptr);
 
   /**
    * Get number of posiform variables.
@@ -97,6 +105,26 @@ public:
         [_posiform_to_bqm_variable_map[posiform_variable]];
   }
 
+  /**
+   * Call callback(posiform_variable_1, posiform_variable_2, coefficient) for
+   * each quadratic term of the posiform with a non-zero coefficient, in order
+   * of the first and then the second variable, posiform_variable_1 being the
+   * smaller one.
+   */
+  template <class Callback> void forEachQuadratic(Callback callback) {
+    for (int variable = 0; variable < _num_posiform_variables; variable++) {
+      auto it = _quadratic_iterators[_posiform_to_bqm_variable_map[variable]].first;
+      auto it_end =
+          _quadratic_iterators[_posiform_to_bqm_variable_map[variable]].second;
+      for (; it != it_end; it++) {
+        auto coefficient = convertToPosiformCoefficient(it->bias);
+        if (coefficient) {
+          callback(variable, mapVariableQuboToPosiform(it->v), coefficient);
+        }
+      }
+    }
+  }
+
   // For iterating over the quadratic biases, we need the
   // convertToPosiformCoefficient and mapVariableQuboToPosiform functions, since
   // the iterators belong to the bqm.
@@ -150,6 +178,13 @@ public:
 	return _bias_conversion_ratio;
   }
 
+  /**
+   * Return the smallest absolute value of the non-zero biases of the bqm, 0 if
+   * they are all zero. With the conversion ratio it tells how much precision
+   * the coefficients of the posiform keep, see needsWideCapacity().
+   */
+  inline double getMinAbsoluteBias() { return _min_absolute_value; }
+
   /**
    * Return the value of the constant term of the posiform.
    */
@@ -164,6 +199,7 @@ public:
 
 private:
   double _max_absolute_value;
+  double _min_absolute_value;
   double _bias_conversion_ratio;
   coefficient_type _constant_posiform;
   double _posiform_linear_sum_non_integral;
@@ -181,12 +217,13 @@ private:
 };
 
 template <class BQM, class coefficient_t>
-PosiformInfo<BQM, coefficient_t>::PosiformInfo(const BQM &bqm) {
-  assert(std::is_integral<coefficient_type>::value &&
-         std::is_signed<coefficient_type>::value &&
+PosiformInfo<BQM, coefficient_t>::PosiformInfo(
+    const BQM &bqm, double headroom, const BiasStatistics<bias_type> *stats) {
+  assert(is_signed_integral<coefficient_type>::value &&
          "Posiform must have signed, integral type coefficients");
   _constant_posiform = 0;
   _max_absolute_value = 0;
+  _min_absolute_value = 0;
   _num_linear_integral_biases = 0;
   _num_bqm_variables = bqm.num_variables();
   _quadratic_iterators.resize(_num_bqm_variables);
@@ -208,8 +245,14 @@ PosiformInfo<BQM, coefficient_t>::PosiformInfo(const BQM &bqm) {
     auto bqm_linear = bqm.linear(bqm_variable);
     auto bqm_linear_abs = std::fabs(bqm_linear);
     _linear_double_biases[bqm_variable] = bqm_linear;
-    if (_max_absolute_value < bqm_linear_abs) {
-      _max_absolute_value = bqm_linear_abs;
+    if (!stats) {
+      if (_max_absolute_value < bqm_linear_abs) {
+        _max_absolute_value = bqm_linear_abs;
+      }
+      if (bqm_linear_abs &&
+          (!_min_absolute_value || bqm_linear_abs < _min_absolute_value)) {
+        _min_absolute_value = bqm_linear_abs;
+      }
     }
     auto span =
             std::make_pair(std::lower_bound(bqm.cbegin_neighborhood(bqm_variable),
@@ -219,16 +262,27 @@ PosiformInfo<BQM, coefficient_t>::PosiformInfo(const BQM &bqm) {
     if (span.first != span.second) {
       for (auto it_end = span.second; span.first != it_end; span.first++) {
         auto bqm_quadratic = span.first->bias;
-        auto bqm_quadratic_abs = std::fabs(bqm_quadratic);
         if (bqm_quadratic < 0) {
           _linear_double_biases[bqm_variable] += bqm_quadratic;
         }
+        if (stats) {
+          continue;
+        }
+        auto bqm_quadratic_abs = std::fabs(bqm_quadratic);
         if (_max_absolute_value < bqm_quadratic_abs) {
           _max_absolute_value = bqm_quadratic_abs;
         }
+        if (bqm_quadratic_abs &&
+            (!_min_absolute_value || bqm_quadratic_abs < _min_absolute_value)) {
+          _min_absolute_value = bqm_quadratic_abs;
+        }
       }
     }
   }
+  if (stats) {
+    _max_absolute_value = stats->maxAbsBias();
+    _min_absolute_value = stats->minAbsBias();
+  }
 
   // See comment above regarding calculating conversion ratio. We do not know
   // the conversion ratio yet so we consider all the linear values, including
@@ -259,7 +313,7 @@ PosiformInfo<BQM, coefficient_t>::PosiformInfo(const BQM &bqm) {
     // by 2 introduced overflow, thus we divide by a number larger than 2.
     // TODO : Find the theoretical optimal number for division, for now we divide
     // by 4 to be safe.
-    _bias_conversion_ratio /= 4;
+    _bias_conversion_ratio /= 4 * headroom;
 
     for (int bqm_variable = 0; bqm_variable < _num_bqm_variables;
         bqm_variable++) {
@@ -295,7 +349,7 @@ PosiformInfo<BQM, coefficient_t>::PosiformInfo(const BQM &bqm) {
       if (_linear_integral_biases[bqm_variable]) {
         _num_linear_integral_biases++;
         _posiform_linear_sum_integral +=
-            std::llabs(_linear_integral_biases[bqm_variable]);
+            absoluteCapacity(_linear_integral_biases[bqm_variable]);
       }
       if (_linear_integral_biases[bqm_variable] < 0) {
         _constant_posiform += _linear_integral_biases[bqm_variable];
@@ -330,17 +384,19 @@ void PosiformInfo<BQM, coefficient_t>::print() {
   std::cout << std::endl;
   std::cout << "Posiform Information : " << std::endl << std::endl;
   std::cout << "Number of BQM Variables : " << _num_bqm_variables << std::endl;
-  std::cout << "Constant : " << _constant_posiform << std::endl;
+  std::cout << "Constant : " << printableCapacity(_constant_posiform) << std::endl;
   std::cout << "Maximum Absolute Value : " << _max_absolute_value << std::endl;
   std::cout << "Numeric Limit of Coefficient Type "
-            << std::numeric_limits<coefficient_type>::max() << std::endl;
+            << printableCapacity(std::numeric_limits<coefficient_type>::max())
+            << std::endl;
   std::cout << "Linear Sum in double Format : "
             << _posiform_linear_sum_non_integral << std::endl;
   std::cout << "Linear Sum Converted to Integral Type : "
-            << convertToPosiformCoefficient(_posiform_linear_sum_non_integral)
+            << printableCapacity(
+                   convertToPosiformCoefficient(_posiform_linear_sum_non_integral))
             << std::endl;
   std::cout << "Linear Sum After Summing in Integral Type : "
-            << _posiform_linear_sum_integral << std::endl;
+            << printableCapacity(_posiform_linear_sum_integral) << std::endl;
   std::cout << "Ratio Chosen : " << _bias_conversion_ratio << std::endl;
   std::cout << std::endl;
 
@@ -360,7 +416,8 @@ void PosiformInfo<BQM, coefficient_t>::print() {
        bqm_variable++) {
     if (_linear_integral_biases[bqm_variable]) {
       std::cout << _bqm_to_posiform_variable_map[bqm_variable] << ", "
-                << bqm_variable << ", " << _linear_integral_biases[bqm_variable]
+                << bqm_variable << ", "
+                << printableCapacity(_linear_integral_biases[bqm_variable])
                 << std::endl;
     }
   }
@@ -375,7 +432,8 @@ void PosiformInfo<BQM, coefficient_t>::print() {
       std::cout << _bqm_to_posiform_variable_map[bqm_variable] << " "
                 << _bqm_to_posiform_variable_map[it->v] << ", ";
       std::cout << bqm_variable << " " << it->v << ",  "
-                << convertToPosiformCoefficient(it->bias) << std::endl;
+                << printableCapacity(convertToPosiformCoefficient(it->bias))
+                << std::endl;
     }
   }
   std::cout << std::endl;
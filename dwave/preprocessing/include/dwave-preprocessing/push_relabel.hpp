@@ -76,11 +76,15 @@
 // https://doi.org/10.1007/PL00009180.
 template <class EdgeType> class PushRelabelSolver {
 public:
-  using edge_iterator = typename std::vector<EdgeType>::iterator;
+  using edge_iterator = typename compressed_adjacency_list<EdgeType>::iterator;
   using capacity_t = typename EdgeType::capacity_type;
 
-  PushRelabelSolver(std::vector<std::vector<EdgeType>> &adjacency_list,
-                    int source, int sink);
+  struct workspace_t;
+
+  // When a workspace is given, the buffers of the solver are taken from it
+  // instead of being allocated, see workspace_t.
+  PushRelabelSolver(compressed_adjacency_list<EdgeType> &adjacency_list,
+                    int source, int sink, workspace_t *workspace = nullptr);
 
   capacity_t computeMaximumPreflow();
 
@@ -90,7 +94,7 @@ public:
 
   void printStatistics();
 
-private:
+protected:
   // We use preallocated vertex nodes for maintaining the linked list since we
   // know the total number of vertices. Vertex number is redundant but when
   // capacity_t is of a type consuming 8 bytes, structural padding will waste
@@ -110,6 +114,26 @@ private:
     preallocated_linked_list<vertex_node_t> inactive_vertices;
   };
 
+public:
+  // The buffers of the solver, which can outlive it so that solving many
+  // networks one after the other does not allocate them every time. They are
+  // resized for each network, which never frees their memory, so a workspace
+  // holds enough for the largest network solved with it. A workspace must not
+  // be used by two solvers at the same time.
+  struct workspace_t {
+    std::vector<level_t> levels;
+    std::vector<vertex_node_t> vertices;
+    vector_based_queue<int> vertex_queue;
+    std::vector<std::pair<edge_iterator, edge_iterator>> pending_out_edges;
+
+    // Used by convertPreflowToFlow().
+    std::vector<int> parents;
+    std::vector<int> topology_next;
+    std::vector<int> dfs_colors;
+  };
+
+protected:
+
   // This will always be manually inlined, without relying on the compiler to do
   // so since this function is very small and the algorithm calls this the
   // highest number of times.
@@ -151,7 +175,6 @@ private:
 
   void printLevels();
 
-private:
   int _sink;
   int _source;
   int _num_vertices;
@@ -166,10 +189,15 @@ private:
   static const int ALPHA = 6, BETA = 12;
   static constexpr double GLOBAL_RELABEL_FREQUENCY = 0.5;
 
-  std::vector<level_t> _levels;
-  std::vector<vertex_node_t> _vertices;
-  vector_based_queue<int> _vertex_queue;
-  std::vector<std::vector<EdgeType>> &_adjacency_list;
+  // The buffers below are those of _workspace, which is _owned_workspace when
+  // no workspace was given.
+  workspace_t _owned_workspace;
+  workspace_t &_workspace;
+
+  std::vector<level_t> &_levels;
+  std::vector<vertex_node_t> &_vertices;
+  vector_based_queue<int> &_vertex_queue;
+  compressed_adjacency_list<EdgeType> &_adjacency_list;
 
   // In different phases of the algorithm, we might know that we do not need to
   // traverse all the outgoing edges from a vertex, and may need to start from a
@@ -177,17 +205,22 @@ private:
   // which we may be able to push flow out of the vertex when we return to the
   // discharge routine, thus we save the iterator of that edge in this
   // _pending_out_edges vector.
-  std::vector<std::pair<edge_iterator, edge_iterator>> _pending_out_edges;
+  std::vector<std::pair<edge_iterator, edge_iterator>> &_pending_out_edges;
 };
 
 // We assume that the flow graph has the correct residuals assigned to the
 // edges. Or namely initial value of residual of an edge is equal to its
-// capacity.
+// capacity, or that the residuals hold a valid flow which is then increased to
+// a maximum flow.
 template <class EdgeType>
 PushRelabelSolver<EdgeType>::PushRelabelSolver(
-    std::vector<std::vector<EdgeType>> &adjacency_list, int source, int sink)
-    : _sink(sink),_source(source), 
-      _vertex_queue(vector_based_queue<int>(adjacency_list.size())), _adjacency_list(adjacency_list) {
+    compressed_adjacency_list<EdgeType> &adjacency_list, int source, int sink,
+    workspace_t *workspace)
+    : _sink(sink), _source(source),
+      _workspace(workspace ? *workspace : _owned_workspace),
+      _levels(_workspace.levels), _vertices(_workspace.vertices),
+      _vertex_queue(_workspace.vertex_queue), _adjacency_list(adjacency_list),
+      _pending_out_edges(_workspace.pending_out_edges) {
   _num_global_relabels = 0;
   _num_gap_relabels = 0;
   _num_gap_vertices = 0;
@@ -195,26 +228,39 @@ PushRelabelSolver<EdgeType>::PushRelabelSolver(
   _num_pushes = 0;
   _num_vertices = _adjacency_list.size();
   _vertices.resize(_num_vertices);
-  _levels.resize(_num_vertices);
   _pending_out_edges.resize(_num_vertices);
+  _vertex_queue.resize(_num_vertices);
 
-  _num_edges = 0;
+  // The lists of a reused workspace may still hold the vertices of the previous
+  // network, and growing the levels copies their sentinels.
+  _levels.resize(_num_vertices);
+  for (auto &level : _levels) {
+    level.active_vertices.clear();
+    level.inactive_vertices.clear();
+  }
+
+  _num_edges = _adjacency_list.num_edges();
   for (int vertex = 0; vertex < _num_vertices; vertex++) {
     _pending_out_edges[vertex] = outEdges(vertex);
     _vertices[vertex].vertex_number = vertex;
     _vertices[vertex].height = 1;
     _vertices[vertex].excess = 0;
-    _num_edges += _adjacency_list[vertex].size();
   }
   _vertices[_source].height = _num_vertices;
   _vertices[_sink].height = 0;
 
   GLOBAL_RELABEL_THRESHOLD = (ALPHA * _num_vertices) + (_num_edges / 2);
 
-  // Saturate the edges coming out of the source. We assume initially there is
-  // no flow and residual of edges are equal to their capacities.
-  double overflow_detector = 0;
+  // A flow that is already in the network reaches the sink, the other vertices
+  // have no excess.
   edge_iterator eit, eit_end;
+  for (std::tie(eit, eit_end) = outEdges(_sink); eit != eit_end; eit++) {
+    _vertices[_sink].excess -= eit->getFlow();
+  }
+
+  // Saturate the edges coming out of the source, the residuals are equal to
+  // their capacities unless there was a flow already.
+  double overflow_detector = 0;
   for (std::tie(eit, eit_end) = outEdges(_source); eit != eit_end; eit++) {
     overflow_detector += eit->residual;
     DEBUG_INCREMENT(_num_pushes);
@@ -508,17 +554,20 @@ void PushRelabelSolver<EdgeType>::convertPreflowToFlow(bool handle_self_loops) {
   // Vertex at the start of the topological sort.
   int topology_start_vertex = -1;
   bool topology_initialized = false;
-  std::vector<int> parent(_num_vertices, -1);
+  std::vector<int> &parent = _workspace.parents;
+  parent.assign(_num_vertices, -1);
 
   // An entry of -1 for a vertex would mean there is no successor to that vertex
   // in the topological ordering.
-  std::vector<int> topology_next(_num_vertices, -1);
+  std::vector<int> &topology_next = _workspace.topology_next;
+  topology_next.assign(_num_vertices, -1);
 
   // White - not processed yet.
   // Grey - under process.
   // Black - finished processing.
   enum DFS_COLOR { WHITE, GREY, BLACK };
-  std::vector<int> dfs_color(_num_vertices, DFS_COLOR::WHITE);
+  std::vector<int> &dfs_color = _workspace.dfs_colors;
+  dfs_color.assign(_num_vertices, DFS_COLOR::WHITE);
 
   for (int vertex = 0; vertex < _num_vertices; vertex++) {
     _pending_out_edges[vertex] = outEdges(vertex);
@@ -0,0 +1,174 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPIN_REVERSAL_TRANSFORM_HPP_INCLUDED
+#define SPIN_REVERSAL_TRANSFORM_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "dimod/binary_quadratic_model.h"
+
+// Apply a batch of spin-reversal transforms to a BQM. Row t of flips, which has
+// one entry per variable, says which variables are flipped by transform t, a
+// non-zero entry meaning that the variable is flipped. Flipping a SPIN variable
+// s means replacing it by -s, and a BINARY variable x by 1 - x, so a sample of
+// a transformed BQM has the same energy as the sample of the BQM with the same
+// variables flipped.
+//
+// The transformed BQMs all have the interactions of the BQM, in the same
+// order, so they are written as arrays of biases:
+//   linear    : num_transforms rows of num_variables linear biases,
+//   quadratic : num_transforms rows of num_interactions quadratic biases,
+//   offsets   : num_transforms offsets,
+//   irow/icol : the num_interactions interactions, with irow[i] < icol[i],
+// all of which must be allocated by the caller and are given row-major. irow
+// and icol can be null if they are not needed.
+//
+// The interactions are read once from the BQM into contiguous arrays, then each
+// transform is done in a few passes over them, spread over the transforms.
+// @param num_threads : the number of threads to use. Has no effect unless
+// compiled with OpenMP.
+template <class B, class V>
+void spinReversalTransformBatch(const dimod::BinaryQuadraticModel<B, V> &bqm,
+                                const std::int8_t *flips,
+                                std::ptrdiff_t num_transforms, B *linear,
+                                B *quadratic, B *offsets, V *irow = nullptr,
+                                V *icol = nullptr, int num_threads = 1) {
+  if (num_threads < 1) {
+    throw std::invalid_argument("num_threads must be positive");
+  }
+  if (bqm.vartype() != dimod::Vartype::SPIN &&
+      bqm.vartype() != dimod::Vartype::BINARY) {
+    throw std::invalid_argument("bqm must be SPIN or BINARY");
+  }
+
+  std::ptrdiff_t num_variables = bqm.num_variables();
+  std::ptrdiff_t num_interactions = bqm.num_interactions();
+
+  std::vector<B> base_linear(num_variables);
+  std::vector<V> rows;
+  std::vector<V> cols;
+  std::vector<B> biases;
+  rows.reserve(num_interactions);
+  cols.reserve(num_interactions);
+  biases.reserve(num_interactions);
+  for (std::ptrdiff_t u = 0; u < num_variables; u++) {
+    base_linear[u] = bqm.linear(u);
+    auto end = bqm.cend_neighborhood(u);
+    for (auto it = bqm.cbegin_neighborhood(u); it != end; it++) {
+      if (it->v > u) {
+        rows.push_back(u);
+        cols.push_back(it->v);
+        biases.push_back(it->bias);
+      }
+    }
+  }
+  if (irow) {
+    std::copy(rows.begin(), rows.end(), irow);
+  }
+  if (icol) {
+    std::copy(cols.begin(), cols.end(), icol);
+  }
+
+  // Writing a flipped variable as c + s * y, with (c, s) = (0, -1) for SPIN
+  // and (1, -1) for BINARY and (0, 1) when it is not flipped, the linear bias
+  // of y is s * (a + sum of b * c over the neighbours), the quadratic biases
+  // are s_u * s_v * b and the constant terms go to the offset.
+  bool binary = bqm.vartype() == dimod::Vartype::BINARY;
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+  for (std::ptrdiff_t t = 0; t < num_transforms; t++) {
+    const std::int8_t *flip = flips + t * num_variables;
+    B *lin = linear + t * num_variables;
+    B *quad = quadratic + t * num_interactions;
+    B offset = bqm.offset();
+
+    for (std::ptrdiff_t v = 0; v < num_variables; v++) {
+      lin[v] = base_linear[v];
+    }
+    for (std::ptrdiff_t i = 0; i < num_interactions; i++) {
+      bool flip_u = flip[rows[i]];
+      bool flip_v = flip[cols[i]];
+      B bias = biases[i];
+      quad[i] = (flip_u != flip_v) ? -bias : bias;
+      if (binary) {
+        if (flip_v) {
+          lin[rows[i]] += bias;
+        }
+        if (flip_u) {
+          lin[cols[i]] += bias;
+          if (flip_v) {
+            offset += bias;
+          }
+        }
+      }
+    }
+    for (std::ptrdiff_t v = 0; v < num_variables; v++) {
+      if (flip[v]) {
+        if (binary) {
+          offset += base_linear[v];
+        }
+        lin[v] = -lin[v];
+      }
+    }
+    offsets[t] = offset;
+  }
+}
+
+// Undo spin-reversal transforms on samples, in place. samples holds the
+// samples of all the transforms stacked row-major, num_samples[t] rows of
+// num_variables values for transform t, and flips is as given to
+// spinReversalTransformBatch().
+template <class T>
+void spinReversalUnflipBatch(T *samples, const std::ptrdiff_t *num_samples,
+                             std::ptrdiff_t num_variables,
+                             const std::int8_t *flips,
+                             std::ptrdiff_t num_transforms,
+                             dimod::Vartype vartype, int num_threads = 1) {
+  if (num_threads < 1) {
+    throw std::invalid_argument("num_threads must be positive");
+  }
+  if (vartype != dimod::Vartype::SPIN && vartype != dimod::Vartype::BINARY) {
+    throw std::invalid_argument("vartype must be SPIN or BINARY");
+  }
+
+  // The first row of each transform, so the transforms can be done in any order.
+  std::vector<std::ptrdiff_t> first_row(num_transforms + 1, 0);
+  for (std::ptrdiff_t t = 0; t < num_transforms; t++) {
+    first_row[t + 1] = first_row[t] + num_samples[t];
+  }
+
+  // A flipped SPIN value s becomes -s and a BINARY value x becomes 1 - x, both
+  // are the value times s plus c, which keeps the inner loop free of branches
+  // so that it can be vectorized.
+  T c = (vartype == dimod::Vartype::BINARY) ? 1 : 0;
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+  for (std::ptrdiff_t t = 0; t < num_transforms; t++) {
+    const std::int8_t *flip = flips + t * num_variables;
+    for (std::ptrdiff_t r = first_row[t]; r < first_row[t + 1]; r++) {
+      T *sample = samples + r * num_variables;
+      for (std::ptrdiff_t v = 0; v < num_variables; v++) {
+        T f = (flip[v] != 0);
+        sample[v] = f * c + (1 - 2 * f) * sample[v];
+      }
+    }
+  }
+}
+
+#endif // SPIN_REVERSAL_TRANSFORM_HPP_INCLUDED
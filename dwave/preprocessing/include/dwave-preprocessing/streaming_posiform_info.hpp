@@ -0,0 +1,265 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STREAMING_POSIFORM_INFORMATION_HPP_INCLUDED
+#define STREAMING_POSIFORM_INFORMATION_HPP_INCLUDED
+
+#include <assert.h>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "capacity_type_traits.hpp"
+
+/**
+ * Same as PosiformInfo, but the quadratic biases are read from a stream of
+ * terms each time they are needed instead of being kept as iterators into a
+ * BQM. The BQM does not need to be held in memory, the terms can for instance
+ * be read in chunks from an edge list on disk, so the BQM and the implication
+ * network built from the posiform never need to fit in memory at the same
+ * time. Only a few arrays of the size of the number of variables are kept.
+ *
+ * The stream is read three times: once to find the conversion ratio, once to
+ * find the integral linear coefficients and the number of quadratic terms of
+ * each variable, which depend on the ratio, and once by the implication
+ * network to create its edges.
+ *
+ * The TermStream must provide
+ *
+ *   using bias_type = ...;
+ *   int num_variables();
+ *   bias_type linear(int variable);
+ *   template <class Callback> void forEachQuadratic(Callback callback);
+ *
+ * where forEachQuadratic() calls callback(u, v, bias) for each quadratic term
+ * of the BQM exactly once, with u < v, sorted by u and then by v. The
+ * implication network relies on that order to keep the edges of each vertex
+ * sorted.
+ *
+ * For details on the algorithm, see : Boros, Endre & Hammer, Peter & Tavares, Gabriel.
+ * (2006). Preprocessing of unconstrained quadratic binary optimization. RUTCOR
+ * Research Report.
+ */
+template <class TermStream, class coefficient_t> class StreamingPosiformInfo {
+public:
+  using coefficient_type = coefficient_t; // Must be a signed integral type.
+  using bias_type = typename TermStream::bias_type;
+
+  /**
+   * Construct a StreamingPosiformInfo from a stream of terms. The stream must
+   * outlive the StreamingPosiformInfo. See PosiformInfo for headroom.
+   */
+  StreamingPosiformInfo(TermStream &stream, double headroom = 1);
+
+  /**
+   * Get number of posiform variables.
+   */
+  inline int getNumVariables() { return _num_posiform_variables; }
+
+  /**
+   * Get number of posiform variables with a non-zero linear bias.
+   */
+  inline int getNumLinear() { return _num_linear_integral_biases; }
+
+  /**
+   * Get the linear bias of a posiform variable.
+   */
+  inline coefficient_type getLinear(int posiform_variable) {
+    return _linear_integral_biases
+        [_posiform_to_bqm_variable_map[posiform_variable]];
+  }
+
+  /**
+   * Get number of quadratic terms a posiform variable contributes in.
+   */
+  inline int getNumQuadratic(int posiform_variable) {
+    return _num_quadratic_integral_biases
+        [_posiform_to_bqm_variable_map[posiform_variable]];
+  }
+
+  /**
+   * Read the stream and call callback(posiform_variable_1,
+   * posiform_variable_2, coefficient) for each quadratic term of the posiform
+   * with a non-zero coefficient, see PosiformInfo::forEachQuadratic().
+   */
+  template <class Callback> void forEachQuadratic(Callback callback) {
+    _stream.forEachQuadratic([&](int u, int v, bias_type bias) {
+      auto coefficient = convertToPosiformCoefficient(bias);
+      if (coefficient) {
+        callback(_bqm_to_posiform_variable_map[u],
+                 _bqm_to_posiform_variable_map[v], coefficient);
+      }
+    });
+  }
+
+  /**
+   * Map a QUBO variable to a posiform variable, -1 if it is not in the
+   * posiform, see PosiformInfo::mapVariableQuboToPosiform().
+   */
+  inline int mapVariableQuboToPosiform(int bqm_variable) {
+    return _bqm_to_posiform_variable_map[bqm_variable];
+  }
+
+  /**
+   * Map a posiform variable to a QUBO variable.
+   */
+  inline int mapVariablePosiformToQubo(int posiform_variable) {
+    return _posiform_to_bqm_variable_map[posiform_variable];
+  }
+
+  /**
+   * Convert a QUBO coefficient to a posiform coefficient.
+   */
+  inline coefficient_type convertToPosiformCoefficient(bias_type bqm_bias) {
+    return static_cast<coefficient_type>(bqm_bias * _bias_conversion_ratio);
+  }
+
+  /**
+   * Return the value by which bqm biases are multiplied to get posiform coefficients.
+   */
+  inline double getBiasConversionRatio() { return _bias_conversion_ratio; }
+
+  /**
+   * Return the smallest absolute value of the non-zero biases of the bqm, see
+   * PosiformInfo::getMinAbsoluteBias().
+   */
+  inline double getMinAbsoluteBias() { return _min_absolute_value; }
+
+  /**
+   * Return the value of the constant term of the posiform.
+   */
+  inline double getConstant() { return _constant_posiform; }
+
+private:
+  TermStream &_stream;
+  double _bias_conversion_ratio;
+  double _min_absolute_value;
+  coefficient_type _constant_posiform;
+  int _num_bqm_variables;
+  int _num_posiform_variables;
+  int _num_linear_integral_biases;
+  std::vector<int> _num_quadratic_integral_biases;
+  std::vector<int> _posiform_to_bqm_variable_map;
+  std::vector<int> _bqm_to_posiform_variable_map;
+  std::vector<coefficient_type> _linear_integral_biases;
+};
+
+template <class TermStream, class coefficient_t>
+StreamingPosiformInfo<TermStream, coefficient_t>::StreamingPosiformInfo(
+    TermStream &stream, double headroom)
+    : _stream(stream) {
+  assert(is_signed_integral<coefficient_type>::value &&
+         "Posiform must have signed, integral type coefficients");
+  _constant_posiform = 0;
+  _num_linear_integral_biases = 0;
+  _num_posiform_variables = 0;
+  _min_absolute_value = 0;
+  _num_bqm_variables = _stream.num_variables();
+
+  // First pass, the conversion ratio is computed the same way as in
+  // PosiformInfo, considering the largest bias and the sum of the absolute
+  // values of the linear coefficients of the posiform in double format.
+  double max_absolute_value = 0;
+  std::vector<double> linear_double_biases(_num_bqm_variables);
+  for (int bqm_variable = 0; bqm_variable < _num_bqm_variables;
+       bqm_variable++) {
+    linear_double_biases[bqm_variable] = _stream.linear(bqm_variable);
+    double bias_abs = std::fabs(linear_double_biases[bqm_variable]);
+    max_absolute_value = std::max(max_absolute_value, bias_abs);
+    if (bias_abs &&
+        (!_min_absolute_value || bias_abs < _min_absolute_value)) {
+      _min_absolute_value = bias_abs;
+    }
+  }
+
+  int previous_u = -1;
+  int previous_v = -1;
+  _stream.forEachQuadratic([&](int u, int v, bias_type bias) {
+    assert(u < v && "Quadratic terms must be given with u < v.");
+    assert((u > previous_u || (u == previous_u && v > previous_v)) &&
+           "Quadratic terms must be sorted and given once.");
+    previous_u = u;
+    previous_v = v;
+    if (bias < 0) {
+      linear_double_biases[u] += bias;
+    }
+    double bias_abs = std::fabs(bias);
+    max_absolute_value = std::max(max_absolute_value, bias_abs);
+    if (bias_abs &&
+        (!_min_absolute_value || bias_abs < _min_absolute_value)) {
+      _min_absolute_value = bias_abs;
+    }
+  });
+
+  double posiform_linear_sum_non_integral = 0;
+  for (int bqm_variable = 0; bqm_variable < _num_bqm_variables;
+       bqm_variable++) {
+    posiform_linear_sum_non_integral +=
+        std::fabs(linear_double_biases[bqm_variable]);
+  }
+  std::vector<double>().swap(linear_double_biases);
+  max_absolute_value =
+      std::max(max_absolute_value, posiform_linear_sum_non_integral);
+
+  _bqm_to_posiform_variable_map.resize(_num_bqm_variables, -1);
+  if (max_absolute_value == 0) {
+    // All biases are 0, so the resulting posiform won't have any term in it.
+    _bias_conversion_ratio = 1;
+    return;
+  }
+
+  // See PosiformInfo for the division by 4.
+  _bias_conversion_ratio =
+      static_cast<double>(std::numeric_limits<coefficient_type>::max()) /
+      max_absolute_value;
+  _bias_conversion_ratio /= 4 * headroom;
+
+  // Second pass, the checks for zero must be done after the conversion, see
+  // PosiformInfo.
+  _linear_integral_biases.resize(_num_bqm_variables);
+  _num_quadratic_integral_biases.resize(_num_bqm_variables, 0);
+  for (int bqm_variable = 0; bqm_variable < _num_bqm_variables;
+       bqm_variable++) {
+    _linear_integral_biases[bqm_variable] =
+        convertToPosiformCoefficient(_stream.linear(bqm_variable));
+  }
+  _stream.forEachQuadratic([&](int u, int v, bias_type bias) {
+    auto bias_quadratic_integral = convertToPosiformCoefficient(bias);
+    if (bias_quadratic_integral) {
+      _num_quadratic_integral_biases[u]++;
+      _num_quadratic_integral_biases[v]++;
+      if (bias_quadratic_integral < 0) {
+        _linear_integral_biases[u] += bias_quadratic_integral;
+      }
+    }
+  });
+
+  for (int bqm_variable = 0; bqm_variable < _num_bqm_variables;
+       bqm_variable++) {
+    if (_linear_integral_biases[bqm_variable]) {
+      _num_linear_integral_biases++;
+    }
+    if (_linear_integral_biases[bqm_variable] < 0) {
+      _constant_posiform += _linear_integral_biases[bqm_variable];
+    }
+    if (_linear_integral_biases[bqm_variable] ||
+        _num_quadratic_integral_biases[bqm_variable]) {
+      _posiform_to_bqm_variable_map.push_back(bqm_variable);
+      _bqm_to_posiform_variable_map[bqm_variable] = _num_posiform_variables++;
+    }
+  }
+}
+
+#endif // STREAMING_POSIFORM_INFORMATION_HPP_INCLUDED
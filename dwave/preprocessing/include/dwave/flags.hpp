@@ -39,11 +39,38 @@ enum TechniqueFlags : std::uint64_t {
     /// See Achterberg et al., section 3.2.
     DomainPropagation = 1 << 2,
 
+    /// Fix the binary variables of the objective that are in no constraint to
+    /// their strong persistencies, found by roof duality.
+    /// See Boros et al., Preprocessing of unconstrained quadratic binary optimization.
+    RoofDuality = 1 << 3,
+
+    /// Remove constraints that are duplicates or scalar multiples of another.
+    /// See the parallel rows reduction of Achterberg et al.
+    RemoveParallelConstraints = 1 << 4,
+
+    /// Tentatively fix each binary variable to 0 and to 1 and propagate the
+    /// constraints, to find the variables that can be fixed, the bounds implied
+    /// either way and the implications of each value. See Achterberg et al.,
+    /// section 3.7, and Savelsbergh, Preprocessing and probing techniques for
+    /// mixed integer programming problems.
+    Probing = 1 << 5,
+
     /// All techniques.
     All = 0xffffffffffffffffu,
 
-    /// Currently equivalent to All, though this may change in the future.
-    Default = All,
+    /// All techniques except RoofDuality, which has to solve a maximum flow problem
+    /// over the objective, and Probing, which propagates the constraints twice for
+    /// every binary variable. This may change in the future.
+    Default = RemoveRedundantConstraints | RemoveSmallBiases | DomainPropagation |
+              RemoveParallelConstraints,
+};
+
+/// The order in which TechniqueFlags::Probing probes the binary variables. The
+/// variables probed first are the most likely to be probed before the budget
+/// runs out.
+enum ProbingOrder {
+    MostConstrainedFirst,  //< The variables in the most constraints first
+    IndexOrder,            //< The variables in the order of their indices
 };
 
 // Developer note: There are other ways to make Flag classes using bitsets etc.
@@ -0,0 +1,111 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace dwave::presolve {
+
+/// The bounds implied by each value of the binary variables of a model, as found
+/// by TechniqueFlags::Probing. If binary variable x is set to `value`, then every
+/// implication in `implications(x, value)` holds in every feasible solution.
+template <class Bias, class Index = int>
+class ImplicationTable {
+ public:
+    using bias_type = Bias;
+    using index_type = Index;
+    using size_type = std::size_t;
+
+    /// An upper or lower bound on variable v.
+    struct Implication {
+        index_type v;
+        bool upper;  // whether it is an upper or a lower bound
+        bias_type bound;
+    };
+
+    /// Remove all of the implications.
+    void clear() {
+        literals_.clear();
+        size_ = 0;
+    }
+
+    /// Whether there are no implications.
+    bool empty() const { return !size_; }
+
+    /// The bounds implied by setting binary variable v to value.
+    const std::vector<Implication>& implications(index_type v, bool value) const {
+        return literals_[2 * v + value];
+    }
+
+    /// The number of variables the table has room for.
+    size_type num_variables() const { return literals_.size() / 2; }
+
+    /// Drop the variables v for which mapping[v] is negative, along with their
+    /// implications and the implications on them, and relabel the others as
+    /// mapping[v]. The mapping must keep the variables in order.
+    void relabel(const std::vector<index_type>& mapping) {
+        // Because the order is kept, mapping[v] <= v, so the table can be
+        // rewritten front to back in place
+        size_type num_kept = 0;
+        size_ = 0;
+        for (size_type v = 0; v < num_variables() && v < mapping.size(); ++v) {
+            if (mapping[v] < 0) continue;
+            for (bool value : {false, true}) {
+                std::vector<Implication> kept;
+                for (const Implication& implication : literals_[2 * v + value]) {
+                    if (static_cast<size_type>(implication.v) >= mapping.size()) continue;
+                    const index_type u = mapping[implication.v];
+                    if (u < 0) continue;
+                    kept.push_back({u, implication.upper, implication.bound});
+                }
+                size_ += kept.size();
+                literals_[2 * mapping[v] + value] = std::move(kept);
+            }
+            ++num_kept;
+        }
+        literals_.resize(2 * num_kept);
+    }
+
+    /// Make room for num_variables variables. The implications of the variables
+    /// that remain are kept.
+    void resize(size_type num_variables) {
+        if (num_variables < this->num_variables()) {
+            for (size_type i = 2 * num_variables; i < literals_.size(); ++i) {
+                size_ -= literals_[i].size();
+            }
+        }
+        literals_.resize(2 * num_variables);
+    }
+
+    /// Replace the bounds implied by setting binary variable v to value.
+    void set(index_type v, bool value, std::vector<Implication> implications) {
+        auto& literal = literals_[2 * v + value];
+        size_ += implications.size();
+        size_ -= literal.size();
+        literal = std::move(implications);
+    }
+
+    /// The total number of implications.
+    size_type size() const { return size_; }
+
+ private:
+    // The implications of v == 0 and of v == 1 are at 2 * v and 2 * v + 1
+    std::vector<std::vector<Implication>> literals_;
+    size_type size_ = 0;
+};
+
+}  // namespace dwave::presolve
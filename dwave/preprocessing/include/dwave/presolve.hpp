@@ -21,11 +21,14 @@
 
 #include <chrono>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "dimod/constrained_quadratic_model.h"
 #include "dwave/flags.hpp"
+#include "dwave/implications.hpp"
+#include "dwave/statistics.hpp"
 
 namespace dwave::presolve {
 
@@ -58,19 +61,74 @@ class Presolver {
 
     const Feasibility& feasibility() const;
 
+    /// Return the bounds implied by each value of the binary variables, found by
+    /// TechniqueFlags::Probing. They are labelled by the variables of model().
+    const ImplicationTable<Bias, Index>& implications() const;
+
     /// Return a const reference to the held constrained quadratic model.
     const model_type& model() const;
 
     /// Normalize the model.
     bool normalize();
 
+    /// Return the number of threads used by presolve().
+    int num_threads() const;
+
     /// Presolve a normalized model.
     bool presolve();
     bool presolve(std::chrono::duration<double> time_limit);
 
+    /// Presolve a normalized model, stopping once `time_limit` has passed or once
+    /// `work_limit` work units have been spent. A work unit is one variable of a
+    /// constraint visited, and each visit costs one more. Unlike the time limit,
+    /// the work limit gives the same result on every machine.
+    bool presolve(std::chrono::duration<double> time_limit, size_type work_limit);
+
+    /// Return the order in which TechniqueFlags::Probing probes the binary variables.
+    ProbingOrder probing_order() const;
+
+    /// Return the time limit of TechniqueFlags::Probing.
+    std::chrono::duration<double> probing_time_limit() const;
+
+    /// Return the work limit of TechniqueFlags::Probing, in the work units of presolve().
+    size_type probing_work_limit() const;
+
     /// Return a sample of the original CQM from a sample of the reduced CQM.
     std::vector<assignment_type> restore(std::vector<assignment_type> reduced) const;
 
+    /// Restore many samples of the reduced CQM at once, using num_threads() threads.
+    /// `reduced` is a row-major array with `num_samples` rows, each a sample of the
+    /// reduced CQM. `original` must have room for `num_samples` rows, each a sample of
+    /// the original CQM.
+    /// The reduced samples can be any of `float`, `double`, `signed char`, `short`,
+    /// `int`, `long` or `long long`, so they do not need to be converted first.
+    template <class T>
+    void restore_batch(const T* reduced, size_type num_samples, assignment_type* original) const;
+
+    /// Serialize the information needed to restore samples of the reduced CQM.
+    /// The returned bytes can be loaded by a Restorer, e.g. in another process,
+    /// without the presolver or the model.
+    std::string serialize_restore() const;
+
+    /// Set the number of threads used by presolve(). The results are the same for
+    /// any number of threads greater than 1, but can differ from the results with
+    /// a single thread, see PresolverImpl::num_threads. Has no effect unless
+    /// compiled with OpenMP.
+    /// Throws std::invalid_argument if num_threads is not positive.
+    int set_num_threads(int num_threads);
+
+    /// Set the order in which TechniqueFlags::Probing probes the binary variables.
+    ProbingOrder set_probing_order(ProbingOrder order);
+
+    /// Set the budget of TechniqueFlags::Probing. Probing stops once it has run for
+    /// `time_limit` or spent `work_limit` work units, or once the limits given to
+    /// presolve() are reached.
+    void set_probing_limits(std::chrono::duration<double> time_limit, size_type work_limit);
+
+    /// Return the statistics of the most recent call to presolve(), with counters
+    /// and timings for each round and technique.
+    const PresolveStatistics& statistics() const;
+
     /// Set the presolve techniques to be run.
     TechniqueFlags set_techniques(TechniqueFlags techniques);
 
@@ -0,0 +1,113 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dwave::presolve {
+
+/// Restore samples of a presolved model without the presolver or the model.
+///
+/// A restorer is loaded from the bytes returned by Presolver::serialize_restore().
+/// The bytes are laid out so that they can be used in-place, e.g. from a memory-mapped
+/// file, see Restorer::view(). All values are stored in native byte order.
+///
+///     char          magic[8]         "DWRSTORE"
+///     uint32        version
+///     uint32        byte order marker, 0x01020304
+///     uint64        num_original     number of variables in the original model
+///     uint64        num_reduced      number of variables in the reduced model
+///     uint64        num_gather
+///     double        fill[num_original]
+///     int64         gather_original[num_gather]
+///     int64         gather_reduced[num_gather]
+///     double        multiplier[num_gather]
+///
+/// A sample is restored by setting `original[i] = fill[i]` and then
+/// `original[gather_original[k]] += multiplier[k] * reduced[gather_reduced[k]]`.
+class Restorer {
+ public:
+    using size_type = std::size_t;
+
+    static constexpr std::uint32_t VERSION = 1;
+
+    /// Construct an empty restorer for a model with no variables.
+    Restorer();
+
+    /// Load a restorer from serialized bytes, taking ownership of them.
+    /// Throws std::invalid_argument if the bytes are not a valid serialization.
+    explicit Restorer(std::string data);
+
+    /// Load a restorer from serialized bytes without copying them. The bytes must
+    /// be 8-byte aligned and must outlive the restorer and any copies of it.
+    /// Throws std::invalid_argument if the bytes are not a valid serialization.
+    static Restorer view(const void* data, size_type size);
+
+    /// Serialize a restore plan. See the class description for the meaning of the
+    /// arguments. Throws std::invalid_argument if they are not consistent.
+    static std::string serialize(size_type num_reduced, const std::vector<double>& fill,
+                                 const std::vector<std::int64_t>& gather_original,
+                                 const std::vector<std::int64_t>& gather_reduced,
+                                 const std::vector<double>& multiplier);
+
+    /// Return a copy of the serialized bytes.
+    std::string serialize() const;
+
+    /// The number of variables in the original model.
+    size_type num_original_variables() const;
+
+    /// The number of variables in the reduced model.
+    size_type num_reduced_variables() const;
+
+    /// Return a sample of the original model from a sample of the reduced model.
+    std::vector<double> restore(const std::vector<double>& reduced) const;
+
+    /// Restore many samples of the reduced model at once.
+    /// `reduced` is a row-major array with `num_samples` rows, each a sample of the
+    /// reduced model. `original` must have room for `num_samples` rows, each a sample
+    /// of the original model.
+    /// The reduced samples can be any of `float`, `double`, `signed char`, `short`,
+    /// `int`, `long` or `long long`, so they do not need to be converted first.
+    template <class T>
+    void restore_batch(const T* reduced, size_type num_samples, double* original) const;
+
+ private:
+    // Used by view(), does not take ownership of the data
+    Restorer(const char* data, size_type size);
+
+    // Point the arrays into data_, checking that the contents are valid
+    void load(const char* data, size_type size);
+
+    // Only set when the restorer owns its bytes. Shared so copies are cheap.
+    std::shared_ptr<const std::string> owned_;
+
+    const char* data_ = nullptr;
+    size_type size_ = 0;
+
+    size_type num_original_ = 0;
+    size_type num_reduced_ = 0;
+    size_type num_gather_ = 0;
+
+    const double* fill_ = nullptr;
+    const std::int64_t* gather_original_ = nullptr;
+    const std::int64_t* gather_reduced_ = nullptr;
+    const double* multiplier_ = nullptr;
+};
+
+}  // namespace dwave::presolve
@@ -0,0 +1,121 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace dwave::presolve {
+
+/// Counters and timing for one presolve technique.
+struct TechniqueStatistics {
+    /// The number of times the technique was applied, e.g. to a constraint.
+    std::size_t num_calls = 0;
+
+    /// The number of those calls that changed the model.
+    std::size_t num_changes = 0;
+
+    /// The time spent in the technique. When the techniques are applied one
+    /// constraint at a time only some of the calls are timed, so this is an estimate.
+    std::chrono::duration<double> time = std::chrono::duration<double>::zero();
+
+    TechniqueStatistics& operator+=(const TechniqueStatistics& other) {
+        num_calls += other.num_calls;
+        num_changes += other.num_changes;
+        time += other.time;
+        return *this;
+    }
+};
+
+/// Statistics for one round of presolve.
+struct RoundStatistics {
+    /// The number of constraints visited.
+    std::size_t num_constraints = 0;
+
+    /// The number of variable bounds that were tightened.
+    std::size_t num_bounds_tightened = 0;
+
+    /// The number of linear and quadratic biases that were removed.
+    std::size_t num_biases_removed = 0;
+
+    /// The work units spent, see Presolver::presolve().
+    std::size_t work_units = 0;
+
+    /// TechniqueFlags::RemoveSmallBiases
+    TechniqueStatistics remove_small_biases;
+
+    /// TechniqueFlags::DomainPropagation. Each change is a constraint that
+    /// tightened at least one bound.
+    TechniqueStatistics domain_propagation;
+
+    /// TechniqueFlags::RemoveRedundantConstraints. Each change is a constraint
+    /// that was found to be redundant and cleared.
+    TechniqueStatistics remove_redundant_constraints;
+
+    /// The time spent in the round, not counting probing. See
+    /// PresolveStatistics::probing.
+    std::chrono::duration<double> time = std::chrono::duration<double>::zero();
+};
+
+/// Statistics for the most recent call to Presolver::presolve().
+struct PresolveStatistics {
+    /// The statistics of each round, in the order they were run.
+    std::vector<RoundStatistics> rounds;
+
+    /// The number of variables fixed and removed from the model.
+    std::size_t num_variables_fixed = 0;
+
+    /// The number of constraints removed from the model.
+    std::size_t num_constraints_removed = 0;
+
+    /// TechniqueFlags::RemoveParallelConstraints. It runs once, before the first
+    /// round, and changes the model if it clears any constraints.
+    TechniqueStatistics remove_parallel_constraints;
+
+    /// TechniqueFlags::Probing. It runs at most once, when the rounds stop making
+    /// changes, after which the rounds carry on from what it found. Each call is
+    /// a variable probed and each change is a variable that was fixed or that
+    /// implied a bound whichever value it took.
+    TechniqueStatistics probing;
+
+    /// The number of implications found by probing, see Presolver::implications().
+    std::size_t num_implications = 0;
+
+    /// TechniqueFlags::RoofDuality. It runs at most once, after the last round,
+    /// and changes the model if it fixes any variables.
+    TechniqueStatistics roof_duality;
+
+    /// The total time spent in presolve().
+    std::chrono::duration<double> time = std::chrono::duration<double>::zero();
+
+    /// Return the statistics of all of the rounds combined.
+    RoundStatistics total() const {
+        RoundStatistics total;
+        for (const RoundStatistics& round : rounds) {
+            total.num_constraints += round.num_constraints;
+            total.num_bounds_tightened += round.num_bounds_tightened;
+            total.num_biases_removed += round.num_biases_removed;
+            total.work_units += round.work_units;
+            total.remove_small_biases += round.remove_small_biases;
+            total.domain_propagation += round.domain_propagation;
+            total.remove_redundant_constraints += round.remove_redundant_constraints;
+            total.time += round.time;
+        }
+        return total;
+    }
+};
+
+}  // namespace dwave::presolve
@@ -14,6 +14,7 @@
 #    See the License for the specific language governing permissions and
 #    limitations under the License.
 
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 
 from dimod.libcpp cimport ConstrainedQuadraticModel
@@ -22,6 +23,7 @@ from dimod.libcpp cimport ConstrainedQuadraticModel
 cdef extern from "<chrono>" namespace "std::chrono" nogil:
     cdef cppclass duration[Rep]:
         duration(Rep)
+        Rep count() const
 
 cdef extern from "dwave/exceptions.hpp" namespace "dwave::presolve" nogil:
     pass
@@ -37,9 +39,43 @@ cdef extern from "dwave/flags.hpp" namespace "dwave::presolve" nogil:
         RemoveRedundantConstraints
         RemoveSmallBiases
         DomainPropagation
+        RoofDuality
+        RemoveParallelConstraints
+        Probing
         All
         Default
 
+    enum ProbingOrder:
+        MostConstrainedFirst
+        IndexOrder
+
+cdef extern from "dwave/statistics.hpp" namespace "dwave::presolve" nogil:
+    cdef cppclass TechniqueStatistics:
+        size_t num_calls
+        size_t num_changes
+        duration[double] time
+
+    cdef cppclass RoundStatistics:
+        size_t num_constraints
+        size_t num_bounds_tightened
+        size_t num_biases_removed
+        size_t work_units
+        TechniqueStatistics remove_small_biases
+        TechniqueStatistics domain_propagation
+        TechniqueStatistics remove_redundant_constraints
+        duration[double] time
+
+    cdef cppclass PresolveStatistics:
+        vector[RoundStatistics] rounds
+        size_t num_variables_fixed
+        size_t num_constraints_removed
+        TechniqueStatistics remove_parallel_constraints
+        TechniqueStatistics probing
+        size_t num_implications
+        TechniqueStatistics roof_duality
+        duration[double] time
+        RoundStatistics total() const
+
 cdef extern from "dwave/presolve.hpp" namespace "dwave::presolve" nogil:
     cdef cppclass Presolver[bias_type, index_type, assignment_type]:
         ctypedef ConstrainedQuadraticModel[bias_type, index_type] model_type
@@ -52,8 +88,30 @@ cdef extern from "dwave/presolve.hpp" namespace "dwave::presolve" nogil:
         const Feasibility& feasibility() const
         model_type& model()
         bint normalize() except+
+        int num_threads()
         bint presolve() except+
         bint presolve(duration[double]) except+
+        bint presolve(duration[double], size_t) except+
+        ProbingOrder probing_order()
+        duration[double] probing_time_limit()
+        size_t probing_work_limit()
         vector[assignment_type] restore(vector[assignment_type])
+        void restore_batch[T](const T*, size_t, assignment_type*)
+        string serialize_restore() except+
+        int set_num_threads(int) except+
+        ProbingOrder set_probing_order(ProbingOrder)
+        void set_probing_limits(duration[double], size_t)
+        const PresolveStatistics& statistics()
         TechniqueFlags set_techniques(TechniqueFlags)
-        TechniqueFlags techniques()
\ No newline at end of file
+        TechniqueFlags techniques()
+
+cdef extern from "dwave/restorer.hpp" namespace "dwave::presolve" nogil:
+    cdef cppclass Restorer:
+        Restorer()
+        Restorer(string) except+
+        @staticmethod
+        Restorer view(const void*, size_t) except+
+        size_t num_original_variables()
+        size_t num_reduced_variables()
+        void restore_batch[T](const T*, size_t, double*)
+        string serialize()
@@ -20,8 +20,9 @@ from dimod.typing cimport Numeric
 from dimod.cyvariables cimport cyVariables
 
 from dwave.preprocessing.libcpp cimport Presolver as cppPresolver
+from dwave.preprocessing.libcpp cimport Restorer as cppRestorer
 
-__all__ = ['cyPresolver']
+__all__ = ['cyPresolver', 'cyRestorer']
 
 
 cdef extern from "<mutex>" namespace "std" nogil:
@@ -40,6 +41,13 @@ cdef class cyPresolver:
 
     cpdef bint apply(self) except*
     cpdef bint normalize(self) except*
-    cpdef bint presolve(self, double time_limit_s=*) except*
+    cpdef bint presolve(self, double time_limit_s=*, object work_limit=*) except*
 
     cdef Py_ssize_t restore_sample(self, const Numeric[::1] reduced_sample, double[::1] original_sample) except -1 nogil
+
+
+cdef class cyRestorer:
+    cdef cppRestorer cpprestorer
+
+    cdef object _data  # keeps the buffer alive when cpprestorer is a view
+    cdef cyVariables _original_variables
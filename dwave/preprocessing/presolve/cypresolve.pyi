@@ -13,6 +13,7 @@
 #    limitations under the License.
 
 import enum
+import typing
 
 import dimod
 import numpy as np
@@ -29,8 +30,17 @@ class TechniqueFlags(enum.IntFlag):
     RemoveRedundantConstraints = 1 << 0
     RemoveSmallBiases = 1 << 1
     DomainPropagation = 1 << 2
+    RoofDuality = 1 << 3
+    RemoveParallelConstraints = 1 << 4
+    Probing = 1 << 5
     All = 0xffffffffffffffff
-    Default = All
+    Default = (RemoveRedundantConstraints | RemoveSmallBiases | DomainPropagation
+               | RemoveParallelConstraints)
+
+
+class ProbingOrder(enum.Enum):
+    MostConstrainedFirst = 0
+    IndexOrder = 1
 
 
 class cyPresolver:
@@ -44,7 +54,26 @@ class cyPresolver:
     def detach_model(self) -> dimod.ConstrainedQuadraticModel: ...
     def feasibility(self) -> Feasibility: ...
     def normalize(self) -> bool: ...
-    def presolve(self, *, time_limit_s: float = float("inf")) -> bool: ...
+    def num_threads(self) -> int: ...
+    def presolve(self, *, time_limit_s: float = float("inf"),
+                 work_limit: typing.Optional[int] = None) -> bool: ...
+    def probing_limits(self) -> typing.Tuple[float, int]: ...
+    def probing_order(self) -> ProbingOrder: ...
     def restore_samples(self, samples_like: dimod.typing.SamplesLike) -> np.ndarray: ...
+    def serialize_restore(self) -> bytes: ...
+    def set_num_threads(self, num_threads: int) -> int: ...
+    def set_probing_limits(self, *, time_limit_s: float = float("inf"),
+                           work_limit: typing.Optional[int] = None) -> typing.Tuple[float, int]: ...
+    def set_probing_order(self, order: ProbingOrder) -> ProbingOrder: ...
     def set_techniques(self, techniques: TechniqueFlags) -> TechniqueFlags: ...
+    def statistics(self) -> typing.Dict[str, typing.Any]: ...
     def techniques(self) -> TechniqueFlags: ...
+
+
+class cyRestorer:
+    variables: dimod.variables.Variables
+
+    def __init__(self, data: bytes, variables: typing.Optional[dimod.typing.VariablesLike] = ...): ...
+    def num_reduced_variables(self) -> int: ...
+    def restore_samples(self, samples_like: dimod.typing.SamplesLike) -> np.ndarray: ...
+    def serialize(self) -> bytes: ...
@@ -1,4 +1,4 @@
-# distutils: sources = dwave/preprocessing/src/presolve.cpp dwave/preprocessing/src/exceptions.cpp
+# distutils: sources = dwave/preprocessing/src/presolve.cpp dwave/preprocessing/src/exceptions.cpp dwave/preprocessing/src/restorer.cpp
 
 # Copyright 2022 D-Wave Systems Inc.
 #
@@ -18,6 +18,9 @@ import enum as pyenum
 
 cimport cython
 
+from libc.stdint cimport uintptr_t
+from libcpp.limits cimport numeric_limits
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 from libcpp.utility cimport move as cppmove
 
@@ -29,8 +32,12 @@ from dimod.libcpp cimport ConstrainedQuadraticModel as cppConstrainedQuadraticMo
 from dimod.constrained.cyconstrained cimport cyConstrainedQuadraticModel, make_cqm
 
 from dwave.preprocessing.libcpp cimport Feasibility as cppFeasibility
+from dwave.preprocessing.libcpp cimport ProbingOrder as cppProbingOrder
 from dwave.preprocessing.libcpp cimport TechniqueFlags as cppTechniqueFlags
 from dwave.preprocessing.libcpp cimport duration
+from dwave.preprocessing.libcpp cimport PresolveStatistics as cppPresolveStatistics
+from dwave.preprocessing.libcpp cimport RoundStatistics as cppRoundStatistics
+from dwave.preprocessing.libcpp cimport TechniqueStatistics as cppTechniqueStatistics
 from dwave.preprocessing.presolve.exceptions import InvalidModelError
 
 # We want to establish a relationship between presolveimpl.hpp and this file, so that
@@ -76,11 +83,30 @@ class TechniqueFlags(pyenum.IntFlag):
             Use constraints to tighten the bounds on variables.
             See Achterberg et al., section 3.2.
 
+        RoofDuality:
+            Fix the binary variables of the objective that are in no constraint
+            to their strong persistencies, found by roof duality.
+            See Boros et al., Preprocessing of unconstrained quadratic binary
+            optimization.
+
+        RemoveParallelConstraints:
+            Remove constraints that are duplicates or scalar multiples of
+            another. See the parallel rows reduction of Achterberg et al.
+
+        Probing:
+            Tentatively fix each binary variable to 0 and to 1 and propagate
+            the constraints, to find the variables that can be fixed, the
+            bounds implied either way and the implications of each value.
+            See Achterberg et al., section 3.7. The budget and the order of
+            the variables are set with :meth:`Presolver.set_probing_limits`
+            and :meth:`Presolver.set_probing_order`.
+
         All:
             All techniques.
 
         Default:
-            Currently equivalent to ``All``, though this may change in the future.
+            All techniques except ``RoofDuality`` and ``Probing``, though this
+            may change in the future.
 
     """
     None_ = 0
@@ -91,9 +117,55 @@ class TechniqueFlags(pyenum.IntFlag):
 
     DomainPropagation = 1 << 2
 
+    RoofDuality = 1 << 3
+
+    RemoveParallelConstraints = 1 << 4
+
+    Probing = 1 << 5
+
     All = 0xffffffffffffffff
 
-    Default = All
+    Default = (RemoveRedundantConstraints | RemoveSmallBiases | DomainPropagation
+               | RemoveParallelConstraints)
+
+
+# In Cython3 we'll be able to import this from C++ directly, but for now we duplicate
+# Dev note: must be kept synced with cypresolve.pyi and with the C++ version
+class ProbingOrder(pyenum.Enum):
+    """An :py:class:`~enum.Enum` to define the order in which
+    :attr:`TechniqueFlags.Probing` probes the binary variables. The variables
+    probed first are the most likely to be probed before the budget runs out.
+
+    Attributes:
+        MostConstrainedFirst: The variables in the most constraints first.
+        IndexOrder: The variables in the order of their indices.
+
+    """
+    MostConstrainedFirst = 0
+    IndexOrder = 1
+
+
+cdef dict _technique_statistics(cppTechniqueStatistics stats):
+    return dict(
+        num_calls=stats.num_calls,
+        num_changes=stats.num_changes,
+        time=stats.time.count(),
+        )
+
+
+cdef dict _round_statistics(cppRoundStatistics stats):
+    return dict(
+        num_constraints=stats.num_constraints,
+        num_bounds_tightened=stats.num_bounds_tightened,
+        num_biases_removed=stats.num_biases_removed,
+        work_units=stats.work_units,
+        techniques={
+            TechniqueFlags.RemoveSmallBiases: _technique_statistics(stats.remove_small_biases),
+            TechniqueFlags.DomainPropagation: _technique_statistics(stats.domain_propagation),
+            TechniqueFlags.RemoveRedundantConstraints: _technique_statistics(stats.remove_redundant_constraints),
+            },
+        time=stats.time.count(),
+        )
 
 
 cdef class cyPresolver:
@@ -196,7 +268,37 @@ cdef class cyPresolver:
 
         return changes
 
-    cpdef bint presolve(self, double time_limit_s = float("inf")) except*:
+    def num_threads(self):
+        """Report the number of threads used by :meth:`presolve`.
+
+        Returns:
+            int: The number of threads.
+
+        """
+        return self.cpppresolver.num_threads()
+
+    def probing_limits(self):
+        """Report the budget of :attr:`TechniqueFlags.Probing`.
+
+        Returns:
+            tuple: A 2-tuple of the time limit in seconds and the work limit,
+            see :meth:`set_probing_limits`.
+
+        """
+        return (self.cpppresolver.probing_time_limit().count(),
+                self.cpppresolver.probing_work_limit())
+
+    def probing_order(self):
+        """Report the order in which :attr:`TechniqueFlags.Probing` probes the
+        binary variables.
+
+        Returns:
+            :class:`ProbingOrder`: The order.
+
+        """
+        return ProbingOrder(<int>self.cpppresolver.probing_order())
+
+    cpdef bint presolve(self, double time_limit_s = float("inf"), object work_limit = None) except*:
         """Apply any loaded presolve techniques to the held constrained quadratic model.
 
         Must be called after :meth:`normalize`.
@@ -207,18 +309,30 @@ cdef class cyPresolver:
                 The presolve rounds will terminate after the time limit is exceeded.
                 Defaults to ``float("inf")``.
 
+            work_limit:
+                A limit on the work done by presolve. A work unit is one variable of
+                a constraint visited, and each visit costs one more. Unlike
+                ``time_limit_s``, the presolved model is the same on every machine.
+                Defaults to no limit.
+
         Returns:
             A boolean indicating whether the model was modified by presolve.
 
         Raises:
             TypeError: If called before :class:`normalize()`.
         """
+        cdef size_t work = numeric_limits[size_t].max()
+        if work_limit is not None:
+            if work_limit < 0:
+                raise ValueError("work_limit must be non-negative")
+            work = min(work_limit, work)
+
         cdef bint changes = False
 
         try:
             with nogil:
                 self.mutex.lock()  # do this once the gil has been released to avoid deadlocks
-                changes = self.cpppresolver.presolve(duration[double](time_limit_s))
+                changes = self.cpppresolver.presolve(duration[double](time_limit_s), work)
         except RuntimeError as err:
             # The C++ logic_error is interpreted by Cython as a RuntimeError.
             # The only errors here should be for a model that's not normalized.
@@ -265,15 +379,21 @@ cdef class cyPresolver:
     @cython.wraparound(False)
     def _restore_samples(self, const Numeric[:, ::1] samples):
         cdef Py_ssize_t num_samples = samples.shape[0]
-        cdef Py_ssize_t num_variables = samples.shape[1]
 
         cdef double[:, ::1] original_samples = np.empty((num_samples, self._original_variables.size()), dtype=np.double)
 
+        if num_samples == 0 or original_samples.shape[1] == 0:
+            return original_samples  # nothing to restore
+
+        # If every variable was removed by presolve then the reduced samples are empty
+        cdef const Numeric* reduced = NULL
+        if samples.shape[1]:
+            reduced = &samples[0, 0]
+
         try:
             with nogil:
                 self.mutex.lock()  # do this once the gil has been released to avoid deadlocks
-                for i in range(num_samples):
-                    self.restore_sample(samples[i, :], original_samples[i, :])
+                self.cpppresolver.restore_batch[Numeric](reduced, num_samples, &original_samples[0, 0])
         finally:
             self.mutex.unlock()  # it's ok to do this inside the GIL
 
@@ -301,7 +421,7 @@ cdef class cyPresolver:
             raise ValueError(f"sample(s) must have {self._model_num_variables} variables, "
                              f"given sample(s) have {samples.shape[1]}")
 
-        # we need contiguous and unsigned. as_samples actually enforces contiguous
+        # we need contiguous and signed. as_samples actually enforces contiguous
         # but no harm in double checking for some future-proofness
         samples = np.ascontiguousarray(
                 samples,
@@ -312,6 +432,141 @@ cdef class cyPresolver:
 
         return np.asarray(restored), self._original_variables
 
+    def serialize_restore(self):
+        """Serialize the information needed to restore the original samples.
+
+        The returned bytes can be loaded by a :class:`Restorer` in another
+        process, without the presolver or the model. This lets you presolve,
+        solve and restore the samples on different machines.
+
+        Returns:
+            bytes: The serialized restore information.
+
+        """
+        cdef string data
+        try:
+            with nogil:
+                self.mutex.lock()
+                data = self.cpppresolver.serialize_restore()
+        finally:
+            self.mutex.unlock()
+        return data
+
+    def set_num_threads(self, int num_threads):
+        """Set the number of threads used by :meth:`presolve`.
+
+        The presolved model is the same for any number of threads greater than
+        one. With a single thread the constraints are visited one after the
+        other rather than in parallel passes, which can lead to different
+        reductions. Multiple threads are only used if the package was compiled
+        with OpenMP.
+
+        Args:
+            num_threads: The number of threads. Must be positive.
+
+        Returns:
+            int: The number of threads.
+
+        """
+        if num_threads < 1:
+            raise ValueError("num_threads must be positive")
+
+        self.cpppresolver.set_num_threads(num_threads)
+        return self.num_threads()
+
+    def set_probing_limits(self, *, double time_limit_s = float("inf"), object work_limit = None):
+        """Set the budget of :attr:`TechniqueFlags.Probing`.
+
+        Probing stops once it has run for ``time_limit_s`` or spent
+        ``work_limit`` work units, or once the limits given to :meth:`presolve`
+        are reached. The limits are checked between variables. The work units
+        are those of :meth:`presolve`, and unlike ``time_limit_s``, the work
+        limit gives the same presolved model on every machine. Until this is
+        called, probing is limited to 10,000,000 work units.
+
+        Args:
+            time_limit_s:
+                A time limit in seconds. Defaults to ``float("inf")``.
+
+            work_limit:
+                A limit on the work done by probing. Defaults to no limit.
+
+        Returns:
+            tuple: A 2-tuple of the time limit in seconds and the work limit.
+
+        """
+        cdef size_t work = numeric_limits[size_t].max()
+        if work_limit is not None:
+            if work_limit < 0:
+                raise ValueError("work_limit must be non-negative")
+            work = min(work_limit, work)
+
+        self.cpppresolver.set_probing_limits(duration[double](time_limit_s), work)
+        return self.probing_limits()
+
+    def set_probing_order(self, order):
+        """Set the order in which :attr:`TechniqueFlags.Probing` probes the
+        binary variables.
+
+        Args:
+            order (:class:`ProbingOrder`): The order.
+
+        Returns:
+            :class:`ProbingOrder`: The order.
+
+        """
+        self.cpppresolver.set_probing_order(<cppProbingOrder>(<int>ProbingOrder(order).value))
+        return self.probing_order()
+
+    def statistics(self):
+        """Report statistics of the most recent call to :meth:`presolve`.
+
+        Returns:
+            dict: A dictionary with the following keys:
+
+            * ``rounds``: A list with the statistics for each round of presolve.
+            * ``total``: The statistics of all of the rounds combined.
+            * ``num_variables_fixed``: The number of variables fixed and removed
+              from the model.
+            * ``num_constraints_removed``: The number of constraints removed from
+              the model.
+            * ``remove_parallel_constraints``: The statistics of
+              :attr:`TechniqueFlags.RemoveParallelConstraints`, which runs once,
+              before the first round.
+            * ``probing``: The statistics of :attr:`TechniqueFlags.Probing`,
+              which runs at most once, when the rounds stop making changes.
+              Each call is a variable probed.
+            * ``num_implications``: The number of bounds implied by the values
+              of the binary variables found by probing.
+            * ``roof_duality``: The statistics of :attr:`TechniqueFlags.RoofDuality`,
+              which runs at most once, after the last round.
+            * ``time``: The total time spent in presolve, in seconds.
+
+            The statistics of a round are a dictionary with the number of
+            constraints visited (``num_constraints``), the number of variable
+            bounds that were tightened (``num_bounds_tightened``), the number of
+            biases removed (``num_biases_removed``), the work units spent
+            (``work_units``, see :meth:`presolve`), the time spent in the round
+            (``time``) and, under ``techniques``, a dictionary keyed by
+            :class:`TechniqueFlags` with the number of times each technique was
+            applied (``num_calls``), the number of times it changed the model
+            (``num_changes``) and the time spent in it (``time``). The time spent
+            in each technique is estimated from a sample of the calls.
+
+        """
+        cdef cppPresolveStatistics stats = self.cpppresolver.statistics()
+        return dict(
+            rounds=[_round_statistics(stats.rounds[i]) for i in range(stats.rounds.size())],
+            total=_round_statistics(stats.total()),
+            num_variables_fixed=stats.num_variables_fixed,
+            num_constraints_removed=stats.num_constraints_removed,
+            remove_parallel_constraints=_technique_statistics(stats.remove_parallel_constraints),
+            probing=_technique_statistics(stats.probing),
+            num_implications=stats.num_implications,
+            roof_duality=_technique_statistics(stats.roof_duality),
+            time=stats.time.count(),
+            )
+
     def set_techniques(self, techniques):
         """Set the presolve techniques to be used by the presolver.
 
@@ -338,3 +593,92 @@ cdef class cyPresolver:
         """
         # Convert from C++ to Python
         return TechniqueFlags(self.cpppresolver.techniques())
+
+
+cdef class cyRestorer:
+    def __cinit__(self, data, variables=None):
+        cdef const unsigned char[::1] buff = data
+        cdef Py_ssize_t size = buff.shape[0]
+
+        cdef const void* ptr = NULL
+        if size:
+            ptr = &buff[0]
+
+        if <uintptr_t>ptr % 8:
+            # we can only use the bytes in-place if they are aligned
+            self.cpprestorer = cppRestorer(string(<const char*>ptr, size))
+        else:
+            self.cpprestorer = cppRestorer.view(ptr, size)
+            self._data = memoryview(data)  # holds the buffer so it cannot be released
+
+        if variables is None:
+            variables = range(self.cpprestorer.num_original_variables())
+        self._original_variables = dimod.variables.Variables(variables)
+
+        if <size_t>self._original_variables.size() != self.cpprestorer.num_original_variables():
+            raise ValueError(f"expected {self.cpprestorer.num_original_variables()} variables, "
+                             f"received {self._original_variables.size()}")
+
+    @property
+    def variables(self):
+        """The variables of the original model."""
+        return self._original_variables
+
+    def num_reduced_variables(self):
+        """Return the number of variables in the reduced model."""
+        return self.cpprestorer.num_reduced_variables()
+
+    @cython.boundscheck(False)
+    @cython.wraparound(False)
+    def _restore_samples(self, const Numeric[:, ::1] samples):
+        cdef Py_ssize_t num_samples = samples.shape[0]
+
+        cdef double[:, ::1] original_samples = np.empty((num_samples, self._original_variables.size()), dtype=np.double)
+
+        if num_samples == 0 or original_samples.shape[1] == 0:
+            return original_samples  # nothing to restore
+
+        cdef const Numeric* reduced = NULL
+        if samples.shape[1]:
+            reduced = &samples[0, 0]
+
+        with nogil:
+            self.cpprestorer.restore_batch[Numeric](reduced, num_samples, &original_samples[0, 0])
+
+        return original_samples
+
+    def restore_samples(self, samples_like):
+        """Restore the original variable labels to a set of reduced samples.
+
+        Args:
+            samples_like: A :class:`dimod.types.SamplesLike`. The samples must
+                be index-labeled.
+
+        Returns:
+            Tuple:
+                A 2-tuple where the first entry is the restored samples and the second
+                is the original labels.
+
+        """
+        samples, labels = dimod.as_samples(samples_like, labels_type=dimod.variables.Variables)
+
+        if not labels.is_range:
+            raise ValueError("expected samples to be integer labelled")
+
+        cdef Py_ssize_t num_reduced = self.cpprestorer.num_reduced_variables()
+        if samples.shape[1] != num_reduced:
+            raise ValueError(f"sample(s) must have {num_reduced} variables, "
+                             f"given sample(s) have {samples.shape[1]}")
+
+        samples = np.ascontiguousarray(
+                samples,
+                dtype=f'i{samples.dtype.itemsize}' if np.issubdtype(samples.dtype, np.unsignedinteger) else None,
+                )
+
+        restored = self._restore_samples(samples)
+
+        return np.asarray(restored), self._original_variables
+
+    def serialize(self):
+        """Return the serialized restore information as bytes."""
+        return self.cpprestorer.serialize()
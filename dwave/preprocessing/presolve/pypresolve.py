@@ -85,13 +85,15 @@ You can also create the sample set for the original CQM:
 ['INTEGER', 6 rows, 6 samples, 1 variables]
 
 """
+import typing
 import warnings
 
 import dimod
 
-from dwave.preprocessing.presolve.cypresolve import cyPresolver, Feasibility, TechniqueFlags
+from dwave.preprocessing.presolve.cypresolve import cyPresolver, cyRestorer
+from dwave.preprocessing.presolve.cypresolve import Feasibility, ProbingOrder, TechniqueFlags
 
-__all__ = ["Feasibility", "Presolver", "TechniqueFlags"]
+__all__ = ["Feasibility", "Presolver", "ProbingOrder", "Restorer", "TechniqueFlags"]
 
 
 class Presolver(cyPresolver):
@@ -171,3 +173,44 @@ class Presolver(cyPresolver):
                       DeprecationWarning, stacklevel=2)
 
         self.set_techniques(TechniqueFlags.Default)
+
+
+class Restorer(cyRestorer):
+    """Restore samples of a presolved model without the presolver.
+
+    Args:
+        data: The bytes returned by :meth:`Presolver.serialize_restore`, or any
+            object supporting the buffer protocol with those contents, such as
+            a :class:`mmap.mmap`. Aligned buffers are used in-place, without
+            being copied.
+        variables: The labels of the variables in the original model. Defaults
+            to index labels.
+
+    Example:
+
+        This example restores samples in a different process than the one that
+        ran presolve.
+
+        >>> import dimod
+        >>> from dwave.preprocessing import Presolver, Restorer
+
+        >>> cqm = dimod.ConstrainedQuadraticModel()
+        >>> i = dimod.Integer('i', lower_bound=-5, upper_bound=5)
+        >>> j = dimod.Integer('j', lower_bound=5, upper_bound=10)
+        >>> cqm.set_objective(i + j)
+        >>> c0 = cqm.add_constraint(j <= 5)  # implicitly fixes 'j'
+
+        >>> presolver = Presolver(cqm)
+        >>> presolver.apply()
+        True
+        >>> data = presolver.serialize_restore()  # save or send these bytes
+
+        >>> restorer = Restorer(data, cqm.variables)
+        >>> samples, labels = restorer.restore_samples([[-5]])
+        >>> samples
+        array([[-5.,  5.]])
+
+    """
+    # include this for the function signature
+    def __init__(self, data: bytes, variables: typing.Optional[dimod.typing.VariablesLike] = None):
+        super().__init__(data, variables)
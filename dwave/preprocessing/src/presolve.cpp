@@ -14,6 +14,8 @@
 
 #include "dwave/presolve.hpp"
 
+#include <stdexcept>
+
 #include "dwave/flags.hpp"
 #include "presolveimpl.hpp"
 
@@ -55,6 +57,11 @@ const Feasibility& Presolver<Bias, Index, Assignment>::feasibility() const {
     return impl_->feasibility();
 }
 
+template <class Bias, class Index, class Assignment>
+const ImplicationTable<Bias, Index>& Presolver<Bias, Index, Assignment>::implications() const {
+    return impl_->implications();
+}
+
 template <class Bias, class Index, class Assignment>
 const dimod::ConstrainedQuadraticModel<Bias, Index>& Presolver<Bias, Index, Assignment>::model()
         const {
@@ -66,6 +73,11 @@ bool Presolver<Bias, Index, Assignment>::normalize() {
     return impl_->normalize();
 }
 
+template <class Bias, class Index, class Assignment>
+int Presolver<Bias, Index, Assignment>::num_threads() const {
+    return impl_->num_threads;
+}
+
 template <class Bias, class Index, class Assignment>
 bool Presolver<Bias, Index, Assignment>::presolve() {
     return impl_->presolve();
@@ -76,12 +88,71 @@ bool Presolver<Bias, Index, Assignment>::presolve(std::chrono::duration<double>
     return impl_->presolve(time_limit);
 }
 
+template <class Bias, class Index, class Assignment>
+bool Presolver<Bias, Index, Assignment>::presolve(std::chrono::duration<double> time_limit,
+                                                  size_type work_limit) {
+    return impl_->presolve(time_limit, work_limit);
+}
+
+template <class Bias, class Index, class Assignment>
+ProbingOrder Presolver<Bias, Index, Assignment>::probing_order() const {
+    return impl_->probing_order;
+}
+
+template <class Bias, class Index, class Assignment>
+std::chrono::duration<double> Presolver<Bias, Index, Assignment>::probing_time_limit() const {
+    return impl_->probing_time_limit;
+}
+
+template <class Bias, class Index, class Assignment>
+typename Presolver<Bias, Index, Assignment>::size_type
+Presolver<Bias, Index, Assignment>::probing_work_limit() const {
+    return impl_->probing_work_limit;
+}
+
 template <class Bias, class Index, class Assignment>
 std::vector<Assignment> Presolver<Bias, Index, Assignment>::restore(
         std::vector<Assignment> reduced) const {
     return impl_->restore(reduced);
 }
 
+template <class Bias, class Index, class Assignment>
+template <class T>
+void Presolver<Bias, Index, Assignment>::restore_batch(const T* reduced, size_type num_samples,
+                                                       Assignment* original) const {
+    impl_->restore_batch(reduced, num_samples, original);
+}
+
+template <class Bias, class Index, class Assignment>
+std::string Presolver<Bias, Index, Assignment>::serialize_restore() const {
+    return impl_->serialize_restore();
+}
+
+template <class Bias, class Index, class Assignment>
+int Presolver<Bias, Index, Assignment>::set_num_threads(int num_threads) {
+    if (num_threads < 1) throw std::invalid_argument("num_threads must be positive");
+    impl_->num_threads = num_threads;
+    return impl_->num_threads;
+}
+
+template <class Bias, class Index, class Assignment>
+ProbingOrder Presolver<Bias, Index, Assignment>::set_probing_order(ProbingOrder order) {
+    impl_->probing_order = order;
+    return impl_->probing_order;
+}
+
+template <class Bias, class Index, class Assignment>
+void Presolver<Bias, Index, Assignment>::set_probing_limits(
+        std::chrono::duration<double> time_limit, size_type work_limit) {
+    impl_->probing_time_limit = time_limit;
+    impl_->probing_work_limit = work_limit;
+}
+
+template <class Bias, class Index, class Assignment>
+const PresolveStatistics& Presolver<Bias, Index, Assignment>::statistics() const {
+    return impl_->statistics();
+}
+
 template <class Bias, class Index, class Assignment>
 TechniqueFlags Presolver<Bias, Index, Assignment>::set_techniques(TechniqueFlags techniques) {
     impl_->techniques = techniques;
@@ -102,4 +173,35 @@ TechniqueFlags Presolver<Bias, Index, Assignment>::techniques() const {
 template class Presolver<double, int, double>;
 template class Presolver<double, long, double>;
 
+// restore_batch() accepts the sample types that dimod uses. We use the fundamental
+// types rather than the fixed width ones for the same reason as above.
+template void Presolver<double, int, double>::restore_batch(const float*, size_type,
+                                                            double*) const;
+template void Presolver<double, int, double>::restore_batch(const double*, size_type,
+                                                            double*) const;
+template void Presolver<double, int, double>::restore_batch(const signed char*, size_type,
+                                                            double*) const;
+template void Presolver<double, int, double>::restore_batch(const short*, size_type,
+                                                            double*) const;
+template void Presolver<double, int, double>::restore_batch(const int*, size_type,
+                                                            double*) const;
+template void Presolver<double, int, double>::restore_batch(const long*, size_type,
+                                                            double*) const;
+template void Presolver<double, int, double>::restore_batch(const long long*, size_type,
+                                                            double*) const;
+template void Presolver<double, long, double>::restore_batch(const float*, size_type,
+                                                             double*) const;
+template void Presolver<double, long, double>::restore_batch(const double*, size_type,
+                                                             double*) const;
+template void Presolver<double, long, double>::restore_batch(const signed char*, size_type,
+                                                             double*) const;
+template void Presolver<double, long, double>::restore_batch(const short*, size_type,
+                                                             double*) const;
+template void Presolver<double, long, double>::restore_batch(const int*, size_type,
+                                                             double*) const;
+template void Presolver<double, long, double>::restore_batch(const long*, size_type,
+                                                             double*) const;
+template void Presolver<double, long, double>::restore_batch(const long long*, size_type,
+                                                             double*) const;
+
 }  // namespace dwave::presolve
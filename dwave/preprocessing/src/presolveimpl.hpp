@@ -17,15 +17,23 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <limits>
 #include <numeric>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "dimod/constrained_quadratic_model.h"
+#include "dwave-preprocessing/fix_variables.hpp"
 #include "dwave/exceptions.hpp"
 #include "dwave/flags.hpp"
+#include "dwave/implications.hpp"
+#include "dwave/restorer.hpp"
+#include "dwave/statistics.hpp"
 
 namespace dwave {
 namespace presolve {
@@ -44,6 +52,9 @@ class PresolverImpl {
 
     using assignment_type = Assignment;
 
+    using implication_table_type = ImplicationTable<bias_type, index_type>;
+    using implication_type = typename implication_table_type::Implication;
+
     static constexpr double FEASIBILITY_TOLERANCE = 1.0e-6;
     static constexpr double INF = 1.0e30;
 
@@ -66,14 +77,16 @@ class PresolverImpl {
     /// This clears the model from the presolver.
     model_type detach_model() {
         detached_ = true;
+        implications_.clear();
         return model_.detach_model();
     }
 
     const Feasibility& feasibility() const { return model_.feasibility; }
 
-    // Get the maximal activity constributed by variable v
+    // Get the maximal activity constributed by variable v, which must not have any
+    // interactions
     static bias_type maximal_activity(const constraint_type& constraint, index_type v) {
-        assert(constraint.is_linear());  // O(n) check; todo: support quadratic
+        assert(!constraint.num_interactions(v));
 
         bias_type a = constraint.linear(v);
         if (a > 0) {
@@ -83,20 +96,16 @@ class PresolverImpl {
         }
     }
 
-    // Get the maximal activity of a constraint
+    // Get the maximal activity of a constraint. For quadratic constraints it is an
+    // upper bound, see quadratic_activity().
     static bias_type maximal_activity(const constraint_type& constraint) {
-        assert(constraint.is_linear());  // O(n) check; todo: support quadratic
-
-        bias_type activity = constraint.offset();  // should be 0, but just in case
-        for (const auto& v : constraint.variables()) {
-            activity += maximal_activity(constraint, v);
-        }
-        return activity;
+        return Activity(constraint).total_maximal();
     }
 
-    // Get the minimal activity constributed by variable v
+    // Get the minimal activity constributed by variable v, which must not have any
+    // interactions
     static bias_type minimal_activity(const constraint_type& constraint, index_type v) {
-        assert(constraint.is_linear());  // O(n) check; todo: support quadratic
+        assert(!constraint.num_interactions(v));
 
         bias_type a = constraint.linear(v);
         if (a > 0) {
@@ -106,15 +115,10 @@ class PresolverImpl {
         }
     }
 
-    // Get the minimal activity of a constraint
+    // Get the minimal activity of a constraint. For quadratic constraints it is a
+    // lower bound, see quadratic_activity().
     static bias_type minimal_activity(const constraint_type& constraint) {
-        assert(constraint.is_linear());  // O(n) check; todo: support quadratic
-
-        bias_type activity = constraint.offset();  // should be 0, but just in case
-        for (const auto& v : constraint.variables()) {
-            activity += minimal_activity(constraint, v);
-        }
-        return activity;
+        return Activity(constraint).total_minimal();
     }
 
     /// Return a const reference to the held constrained quadratic model.
@@ -128,17 +132,35 @@ class PresolverImpl {
 
         bool changes = false;
 
-        changes |= normalization_check_nan();
-        changes |= normalization_replace_inf();
-        changes |= normalization_spin_to_binary();
-        changes |= normalization_remove_offsets();
-        changes |= normalization_remove_self_loops();
-        changes |= normalization_flip_constraints();
+        // The steps that only touch one constraint at a time are fused into a single
+        // pass over the constraints, run in parallel. Changing the SPIN variables to
+        // BINARY touches every expression, and the later steps rely on it, so if
+        // there are any the pass is split in two around it.
+        normalization_check_nan_bounds();
+        changes |= normalization_replace_inf_bounds();
+
+        std::vector<char> self_loops;
+        bool spin = false;
+        for (size_type v = 0; v < model_.num_variables(); ++v) {
+            spin |= model_.vartype(v) == dimod::Vartype::SPIN;
+        }
+        if (spin) {
+            changes |= normalization_fused(true, false, self_loops);
+            changes |= normalization_spin_to_binary();
+            changes |= normalization_fused(false, true, self_loops);
+        } else {
+            changes |= normalization_fused(true, true, self_loops);
+        }
+
+        // These add variables and constraints, or look across constraints
+        changes |= normalization_remove_self_loops(self_loops);
         changes |= normalization_remove_invalid_markers();
         changes |= normalization_fix_bounds();
 
         normalized_ = true;
 
+        model_.compile_restore_plan();
+
         return changes;
     }
 
@@ -190,14 +212,18 @@ class PresolverImpl {
             changes |= normalization_check_nan(constraint);
         }
 
-        // test the bounds
+        normalization_check_nan_bounds();
+
+        return changes;
+    }
+
+    /// Check that none of the variable bounds are NAN
+    void normalization_check_nan_bounds() const {
         for (size_type v = 0, last = model_.num_variables(); v < last; ++v) {
             if (std::isnan(model_.lower_bound(v)) || std::isnan(model_.upper_bound(v))) {
                 throw InvalidModelError("bounds cannot be NAN");
             }
         }
-
-        return changes;
     }
 
     static bool normalization_check_nan(const constraint_type& constraint) {
@@ -326,6 +352,14 @@ class PresolverImpl {
 
     /// Remove any self-loops (e.g. x^2) by adding a new variable and an equality constraint.
     bool normalization_remove_self_loops() {
+        return normalization_remove_self_loops(std::vector<char>(model_.num_constraints(), true));
+    }
+
+    /// Remove the self-loops of the objective and of the constraints c for which
+    /// `self_loops[c]` is true. The others are assumed not to have any.
+    bool normalization_remove_self_loops(const std::vector<char>& self_loops) {
+        assert(self_loops.size() == model_.num_constraints());
+
         std::unordered_map<index_type, index_type> mapping;
 
         // Function to go through the objective/constraints and for each variable in a self-loop,
@@ -365,8 +399,8 @@ class PresolverImpl {
 
         // Actually apply the method
         substitute(model_.objective());
-        for (auto& constraint : model_.constraints()) {
-            substitute(constraint);
+        for (size_type c = 0, last = model_.num_constraints(); c < last; ++c) {
+            if (self_loops[c]) substitute(model_.constraint_ref(c));
         }
 
         // We add the new constraints last, because otherwise we would cause reallocation
@@ -384,6 +418,15 @@ class PresolverImpl {
             changes |= normalization_replace_inf(constraint);
         }
 
+        changes |= normalization_replace_inf_bounds();
+
+        return changes;
+    }
+
+    /// Replace any infinite variable bounds with 1e30
+    bool normalization_replace_inf_bounds() {
+        bool changes = false;
+
         // Bounds will all be tightened by fix_bounds later, but for
         // maintainability and symmetry, let's go ahead and replace those too
         for (size_type v = 0, last = model_.num_variables(); v < last; ++v) {
@@ -447,6 +490,62 @@ class PresolverImpl {
         return changes;
     }
 
+    /// Apply the normalization steps that only touch one expression to the objective
+    /// and, in parallel, to each of the constraints, reading each of them once.
+    /// With `before_spin`, check for NAN and replace inf. With `after_spin`, remove the
+    /// offsets of the constraints, flip the >= constraints to <= and record in
+    /// `self_loops` which constraints have self-loops. See normalize().
+    bool normalization_fused(bool before_spin, bool after_spin, std::vector<char>& self_loops) {
+        bool changes = false;
+
+        if (before_spin) {
+            normalization_check_nan(model_.objective());
+            changes |= normalization_replace_inf(model_.objective());
+        }
+
+        const std::ptrdiff_t num_constraints = model_.num_constraints();
+        if (after_spin) self_loops.assign(num_constraints, false);
+
+        // Exceptions must not escape the parallel region, the first one is rethrown
+        // once all the threads are done.
+        std::exception_ptr error;
+        std::vector<char> changed(num_constraints, false);
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+        for (std::ptrdiff_t c = 0; c < num_constraints; ++c) {
+            auto& constraint = model_.constraint_ref(c);
+            try {
+                if (before_spin) {
+                    normalization_check_nan(constraint);
+                    changed[c] |= normalization_replace_inf(constraint);
+                }
+                if (after_spin) {
+                    changed[c] |= normalization_remove_offset(constraint);
+                    changed[c] |= normalization_flip_constraint(constraint);
+
+                    const expression_base_type& base = constraint;
+                    for (auto it = base.cbegin_quadratic(), end = base.cend_quadratic();
+                         it != end; ++it) {
+                        if (it->u == it->v) {
+                            self_loops[c] = true;
+                            break;
+                        }
+                    }
+                }
+            } catch (...) {
+#pragma omp critical
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        return changes || std::find(changed.begin(), changed.end(), true) != changed.end();
+    }
+
     /// Convert any SPIN variables to BINARY variables
     bool normalization_spin_to_binary() {
         bool changes = false;
@@ -459,8 +558,16 @@ class PresolverImpl {
         return changes;
     }
 
+    /// Presolve a normalized model.
+    ///
+    /// Presolve stops once `time_limit` has passed or once `work_limit` work units
+    /// have been spent. A work unit is one variable of a constraint visited, and
+    /// each visit costs one more. Unlike the time limit, the work limit gives the
+    /// same result on every machine. In parallel mode the work limit is only
+    /// checked between rounds.
     bool presolve(std::chrono::duration<double> time_limit =
-                          std::chrono::duration<double>(std::numeric_limits<double>::infinity())) {
+                          std::chrono::duration<double>(std::numeric_limits<double>::infinity()),
+                  size_type work_limit = std::numeric_limits<size_type>::max()) {
         if (detached_) {
             throw std::logic_error(
                     "model has been detached, so there is no model to apply presolve() to");
@@ -469,6 +576,9 @@ class PresolverImpl {
             throw std::logic_error("model must be normalized before presolve() is applied");
         }
 
+        const auto presolve_start_time = std::chrono::steady_clock::now();
+        statistics_ = PresolveStatistics();
+
         // If no techniques have been loaded, return early.
         if (!techniques) {
             return false;
@@ -476,54 +586,272 @@ class PresolverImpl {
 
         bool changes = false;
 
+        // Parallel constraints are found once, up front, so the rounds never visit the
+        // duplicates. They are cleared and so they don't make it into the incidence.
+        if (techniques & TechniqueFlags::RemoveParallelConstraints) {
+            auto now = std::chrono::steady_clock::now();
+            const bool technique_changes = technique_remove_parallel_constraints();
+            record(statistics_.remove_parallel_constraints, 1, technique_changes, now);
+            changes |= technique_changes;
+        }
+
+        // Rather than sweeping every constraint each round, we keep a worklist of the
+        // constraints that need to be (re)visited. Initially that's all of them, after
+        // that only the constraints that were changed, or that contain a variable whose
+        // bounds were tightened, get queued for the next round.
+        build_incidence();
+        model_.clear_bound_changes();
+        worklist_.resize(model_.num_constraints());
+        std::iota(worklist_.begin(), worklist_.end(), 0);
+        queued_.assign(model_.num_constraints(), true);
+        cleared_.resize(model_.num_constraints());
+        for (size_type c = 0; c < model_.num_constraints(); ++c) {
+            cleared_[c] = is_cleared(model_.constraint_ref(c));
+        }
+        num_cleared_in_incidence_ = 0;
+        activities_.assign(model_.num_constraints(), Activity());
+
         // We have many exit criteria. We could put them all in the for-loop
         // declaration but that makes it heard to read so we put them into
         // separate if/break statements.
         const auto start_time = std::chrono::steady_clock::now();
+        std::vector<index_type> round;
+        std::vector<std::chrono::steady_clock::time_point> round_start_times;
+        size_type work_units = 0;
+
+        // Probing costs much more than the other techniques, so it only runs once, when
+        // they have nothing left to do. The rounds then pick up from whatever it found.
+        // Returns whether it changed the model.
+        // Probing has its own statistics, so its time is taken out of the round it
+        // ran in.
+        bool probed = false;
+        size_type probing_round = 0;
+        std::chrono::duration<double> probing_time = std::chrono::duration<double>::zero();
+        auto probe = [&]() {
+            if (probed || !(techniques & TechniqueFlags::Probing)) return false;
+            if (feasibility() == Feasibility::Infeasible || work_units >= work_limit) return false;
+            probed = true;
+
+            auto now = std::chrono::steady_clock::now();
+            size_type probing_work_units = 0;
+            const bool technique_changes = technique_probing(
+                    now, std::min<std::chrono::duration<double>>(probing_time_limit,
+                                                                 time_limit - (now - start_time)),
+                    std::min(probing_work_limit, work_limit - work_units), probing_work_units);
+            work_units += probing_work_units;
+            const auto probing_start_time = now;
+            record(statistics_.probing, 0, 0, now);
+            probing_round = round_start_times.size() - 1;
+            probing_time = now - probing_start_time;
+            changes |= technique_changes;
+            return technique_changes;
+        };
+
+        // Move the queued constraints into round, in index order. Constraints can be
+        // cleared after they were queued, in which case there is nothing left to do
+        // for them.
+        auto take_worklist = [&]() {
+            round.clear();
+            std::swap(round, worklist_);
+            std::sort(round.begin(), round.end());
+            round.erase(std::remove_if(round.begin(), round.end(),
+                                       [this](const index_type& c) {
+                                           if (!cleared_[c]) return false;
+                                           queued_[c] = false;
+                                           return true;
+                                       }),
+                        round.end());
+        };
+
         for (index_type num_rounds = 0; num_rounds < max_num_rounds; ++num_rounds) {
             // No point doing presolve if we're infeasible
             if (feasibility() == Feasibility::Infeasible) break;
 
-            // If we've exceeded the time_limit then don't proceed
-            if (std::chrono::steady_clock::now() - start_time >= time_limit) break;
+            // If we've exceeded the time_limit or the work_limit then don't proceed
+            auto now = std::chrono::steady_clock::now();
+            if (now - start_time >= time_limit) break;
+            if (work_units >= work_limit) break;
+
+            round_start_times.emplace_back(now);
+            RoundStatistics& round_statistics = statistics_.rounds.emplace_back();
 
             bool loop_changes = false;
 
-            // Objective
-            {
+            // Objective. It doesn't depend on the bounds, so we only need to handle it once
+            if (!num_rounds) {
                 if (techniques & TechniqueFlags::RemoveSmallBiases) {
-                    loop_changes |= technique_remove_small_biases(model_.objective());
+                    auto& objective = model_.objective();
+                    round_statistics.work_units += objective.num_variables() + 1;
+                    work_units += objective.num_variables() + 1;
+                    const size_type num_biases = this->num_biases(objective);
+                    const bool objective_changes = technique_remove_small_biases(objective);
+                    round_statistics.num_biases_removed += num_biases - this->num_biases(objective);
+                    record(round_statistics.remove_small_biases, 1, objective_changes, now);
+                    loop_changes |= objective_changes;
                 }
 
-                if (std::chrono::steady_clock::now() - start_time >= time_limit) break;
+                if (now - start_time >= time_limit) break;
             }
 
-            // Constraints
-            for (auto& constraint : model_.constraints()) {
-                if (techniques & TechniqueFlags::RemoveSmallBiases) {
-                    loop_changes |= technique_remove_small_biases(constraint);
-                }
+            // If nothing has been queued, then doing more loops won't help, unless
+            // probing finds something
+            if (worklist_.empty() && !probe()) {
+                changes |= loop_changes;
+                break;
+            }
 
-                if (techniques & TechniqueFlags::DomainPropagation) {
-                    loop_changes |= technique_domain_propagation(constraint);
+            // Visit the queued constraints in index order. Constraints queued while we
+            // work through this round that have not been visited yet are still handled
+            // this round, everything else goes onto the worklist for the next one.
+            take_worklist();
+
+            // In parallel mode each pass works from the bounds at its start, so a bound
+            // only travels one constraint further per pass. We keep passing over the
+            // constraints queued by the previous pass until there are none left, so
+            // that a round gets at least as far as a serial one. The passes are capped
+            // at the number of constraints, enough for a bound to travel through all
+            // of them, and do not count against max_num_rounds.
+            if (num_threads > 1) {
+                for (size_type num_passes = 0;; ++num_passes) {
+                    const size_type round_work_units = round_statistics.work_units;
+                    loop_changes |= presolve_round_parallel(round, round_statistics);
+                    work_units += round_statistics.work_units - round_work_units;
+
+                    if (worklist_.empty() || num_passes + 1 >= model_.num_constraints()) break;
+                    if (feasibility() == Feasibility::Infeasible) break;
+                    if (std::chrono::steady_clock::now() - start_time >= time_limit) break;
+                    if (work_units >= work_limit) break;
+
+                    take_worklist();
                 }
+            } else {
+                // The clock reads used for the statistics double as the time_limit check
+                AmortizedClock clock(std::chrono::steady_clock::now());
+
+                // Constraints
+                for (const index_type& c : round) {
+                    queued_[c] = false;
+                    ++round_statistics.num_constraints;
+
+                    auto& constraint = model_.constraint_ref(c);
+
+                    round_statistics.work_units += constraint.num_variables() + 1;
+                    work_units += constraint.num_variables() + 1;
+
+                    // We only time the techniques for the constraints that we read the
+                    // clock for. Each stands in for the constraints since the last read.
+                    const bool timed = clock.tick();
+                    const size_type weight = clock.num_ticks();
+                    if (timed) now = std::chrono::steady_clock::now();
+                    auto time_technique = [&](TechniqueStatistics& statistics) {
+                        if (!timed) return;
+                        const auto end = std::chrono::steady_clock::now();
+                        statistics.time += (end - now) * static_cast<double>(weight);
+                        now = end;
+                    };
+
+                    bool constraint_changes = false;
+
+                    if (techniques & TechniqueFlags::RemoveSmallBiases) {
+                        auto& statistics = round_statistics.remove_small_biases;
+                        const size_type num_biases = this->num_biases(constraint);
+                        const bool technique_changes = technique_remove_small_biases(constraint);
+                        if (technique_changes) {
+                            activities_[c].valid = false;  // the constraint itself changed
+                            constraint_changes = true;
+                        }
+                        round_statistics.num_biases_removed +=
+                                num_biases - this->num_biases(constraint);
+                        ++statistics.num_calls;
+                        statistics.num_changes += technique_changes;
+                        time_technique(statistics);
+                    }
 
-                if (techniques & TechniqueFlags::RemoveRedundantConstraints) {
-                    loop_changes |= technique_clear_redundant_constraint(constraint);
-                }
+                    if (techniques & TechniqueFlags::DomainPropagation) {
+                        auto& statistics = round_statistics.domain_propagation;
+                        const bool technique_changes = technique_domain_propagation(c);
+                        constraint_changes |= technique_changes;
+                        ++statistics.num_calls;
+                        statistics.num_changes += technique_changes;
+                        time_technique(statistics);
+                    }
+
+                    if (techniques & TechniqueFlags::RemoveRedundantConstraints) {
+                        auto& statistics = round_statistics.remove_redundant_constraints;
+                        const bool technique_changes = technique_clear_redundant_constraint(c);
+                        if (technique_changes) {
+                            mark_cleared(c);
+                            constraint_changes = true;
+                        }
+                        ++statistics.num_calls;
+                        statistics.num_changes += technique_changes;
+                        time_technique(statistics);
+                    }
+
+                    // If we changed the constraint itself we want to visit it again, unless
+                    // we cleared it in which case there is nothing left to do.
+                    if (constraint_changes && constraint.num_variables()) enqueue(c);
+
+                    // Likewise every constraint touching a variable with new bounds
+                    process_bound_changes();
+
+                    loop_changes |= constraint_changes;
 
-                // this will ultimately give us a double break because we'll test again in the main
-                // loop
-                if (std::chrono::steady_clock::now() - start_time >= time_limit) break;
+                    // this will ultimately give us a double break because we'll test again in the
+                    // main loop
+                    if (timed) {
+                        clock.read(now);
+                        if (now - start_time >= time_limit) break;
+                    }
+                    if (work_units >= work_limit) break;
+                }
             }
 
             // If we didn't make any changes, then doing more loops won't help
-            // so we exit out
-            if (!loop_changes) break;
+            // so we exit out, unless probing finds something
+            if (!loop_changes && !probe()) break;
 
             changes |= loop_changes;
+
+            // Once enough of the constraints are cleared, walking past them every time
+            // a bound changes costs more than rebuilding the incidence without them.
+            if (num_cleared_in_incidence_ * CLEARED_FRACTION_TO_REBUILD_INCIDENCE >
+                model_.num_constraints()) {
+                build_incidence();
+            }
+        }
+
+        // Each round lasts until the next one starts, less any time spent probing
+        {
+            const auto end_time = std::chrono::steady_clock::now();
+            for (size_type i = 0; i < round_start_times.size(); ++i) {
+                statistics_.rounds[i].time =
+                        (i + 1 < round_start_times.size() ? round_start_times[i + 1] : end_time) -
+                        round_start_times[i];
+            }
+            if (probed) statistics_.rounds[probing_round].time -= probing_time;
         }
 
+        // Roof duality only looks at the variables that are in no constraint, so once
+        // the redundant constraints have been cleared it only needs to run once
+        if ((techniques & TechniqueFlags::RoofDuality) &&
+            feasibility() != Feasibility::Infeasible && work_units < work_limit) {
+            auto now = std::chrono::steady_clock::now();
+            if (now - start_time < time_limit) {
+                const bool technique_changes = technique_roof_duality();
+                record(statistics_.roof_duality, 1, technique_changes, now);
+                changes |= technique_changes;
+            }
+        }
+
+        // Release the worklist memory, it's rebuilt by the next call
+        incidence_starts_ = {};
+        incidence_ = {};
+        worklist_ = {};
+        queued_ = {};
+        cleared_ = {};
+        activities_ = {};
+
         // Cleanup. We do these steps even in the infeasible case.
 
         // These steps are not broken out into methods because we only want to do them here.
@@ -541,9 +869,26 @@ class PresolverImpl {
                 }
             }
 
+            // The implications are kept for the next call, without the fixed variables
+            if (!implications_.empty()) {
+                std::vector<index_type> mapping(model_.num_variables());
+                index_type num_kept = 0;
+                for (size_type v = 0, fi = 0; v < model_.num_variables(); ++v) {
+                    if (fi < variables.size() && variables[fi] == static_cast<index_type>(v)) {
+                        mapping[v] = -1;
+                        ++fi;
+                    } else {
+                        mapping[v] = num_kept++;
+                    }
+                }
+                implications_.relabel(mapping);
+            }
+            statistics_.num_implications = implications_.size();
+
             model_.fix_variables(variables, values);
 
             changes |= variables.size();
+            statistics_.num_variables_fixed = variables.size();
 
             // we may have introduced offsets here, so let's fix them
             changes |= normalization_remove_offsets();
@@ -556,6 +901,7 @@ class PresolverImpl {
             model_.remove_constraints_if(
                     [](const constraint_type& c) { return !c.num_variables(); });
             changes |= num_constraints > model_.num_constraints();  // if we removed any
+            statistics_.num_constraints_removed = num_constraints - model_.num_constraints();
         }
 
         // There are a few normalization steps we want to re-run to clean up the model
@@ -563,6 +909,10 @@ class PresolverImpl {
         // Todo: we could replace this with a step where we can also add discrete markers
         changes |= normalization_remove_invalid_markers();
 
+        model_.compile_restore_plan();
+
+        statistics_.time = std::chrono::steady_clock::now() - presolve_start_time;
+
         // Sanity check that we didn't break normalization
         assert(!normalize());
 
@@ -575,71 +925,37 @@ class PresolverImpl {
         return model_.restore(std::move(reduced));
     }
 
+    /// Restore many samples of the reduced CQM at once using num_threads threads.
+    /// `reduced` is a row-major array with `num_samples` rows, each a sample of the
+    /// reduced CQM. `original` must have room for `num_samples` rows, each a sample of
+    /// the original CQM.
+    template <class T>
+    void restore_batch(const T* reduced, size_type num_samples, assignment_type* original) const {
+        model_.restore_batch(reduced, num_samples, original, num_threads);
+    }
+
+    /// Serialize the information needed to restore samples of the reduced CQM.
+    /// See Restorer.
+    std::string serialize_restore() const { return model_.serialize_restore(); }
+
+    /// Return the statistics of the most recent call to presolve().
+    const PresolveStatistics& statistics() const { return statistics_; }
+
+    /// Return the bounds implied by each value of the binary variables, found by
+    /// TechniqueFlags::Probing. They are relabelled along with the variables of
+    /// model(), so they are kept for the next call to presolve().
+    const implication_table_type& implications() const { return implications_; }
+
     /// Clear redundant constraints by turning them into 0 == 0 constraints.
     /// We don't actually remove them (yet) because we don't want to reallocate
     /// our constraint vector.
     bool technique_clear_redundant_constraint(constraint_type& constraint) {
-        // This method is not (currently, todo) implemented for quadratic constraints
-        if (!constraint.is_linear()) {
-            return false;
-        }
-
         // Skip the constraints that have already been cleared
-        if (!constraint.num_variables() && !constraint.offset() && !constraint.rhs()) {
-            // the constraint is already empty, nothing to do
+        if (is_cleared(constraint)) {
             return false;
         }
 
-        bias_type minac = minimal_activity(constraint);
-        bias_type maxac = maximal_activity(constraint);
-
-        // Test if the constraint is trivially infeasible
-        if (constraint.sense() == dimod::Sense::LE || constraint.sense() == dimod::Sense::EQ) {
-            if (minac > constraint.rhs() + FEASIBILITY_TOLERANCE) {
-                // Soft constraints don't cause the model to be infeasible.
-                if (!constraint.is_soft()) {
-                    model_.feasibility = Feasibility::Infeasible;
-                }
-
-                return false;
-            }
-        }
-        if (constraint.sense() == dimod::Sense::GE || constraint.sense() == dimod::Sense::EQ) {
-            if (maxac < constraint.rhs() - FEASIBILITY_TOLERANCE) {
-                // Soft constraints don't cause the model to be infeasible.
-                if (!constraint.is_soft()) {
-                    model_.feasibility = Feasibility::Infeasible;
-                }
-
-                return false;
-            }
-        }
-
-        // Test if the constraint is always satisfied
-        // If the constraint is soft, it can just be remove it because it will
-        // contribute 0 to the energy of the problem.
-        switch (constraint.sense()) {
-            case dimod::Sense::LE:
-                if (maxac <= constraint.rhs() + FEASIBILITY_TOLERANCE) {
-                    constraint.clear();
-                    return true;
-                }
-                break;
-            case dimod::Sense::GE:
-                if (minac >= constraint.rhs() - FEASIBILITY_TOLERANCE) {
-                    constraint.clear();
-                    return true;
-                }
-                break;
-            case dimod::Sense::EQ:
-                if (minac == constraint.rhs() && maxac == constraint.rhs()) {
-                    constraint.clear();
-                    return true;
-                }
-                break;
-        }
-
-        return false;
+        return technique_clear_redundant_constraint(constraint, Activity(constraint));
     }
 
     /// Tighten bounds based on constraints.
@@ -647,13 +963,19 @@ class PresolverImpl {
     bool technique_domain_propagation(const constraint_type& constraint) {
         bool changes = false;
 
+        auto tighten = [this](index_type v, bool upper, bias_type bound) {
+            return tighten_bound(v, upper, bound);
+        };
+
         if (constraint.sense() == dimod::Sense::LE || constraint.sense() == dimod::Sense::EQ) {
-            changes |= technique_domain_propagation<dimod::Sense::LE>(constraint);
+            changes |= technique_domain_propagation<dimod::Sense::LE>(
+                    constraint, Activity(constraint), tighten);
         }
 
         // We don't need to handle GE, but it makes testing easier so may as well
         if (constraint.sense() == dimod::Sense::GE || constraint.sense() == dimod::Sense::EQ) {
-            changes |= technique_domain_propagation<dimod::Sense::GE>(constraint);
+            changes |= technique_domain_propagation<dimod::Sense::GE>(
+                    constraint, Activity(constraint), tighten);
         }
 
         return changes;
@@ -740,11 +1062,267 @@ class PresolverImpl {
         return changes || variables.size();
     }
 
+    /// Clear the hard linear constraints that are duplicates or scalar multiples of
+    /// another. Each group of parallel constraints keeps only those that give the
+    /// tightest bound on the shared row, or an equality constraint if there is one.
+    /// A discrete constraint is kept over the other equalities, so that the marker
+    /// is not lost with the duplicates.
+    /// The rows are normalized by dividing by the coefficient of their first variable
+    /// and hashed, so only the rows that land in the same bucket are compared, and
+    /// they are compared exactly. If parallel constraints contradict each other the
+    /// model is marked infeasible and no constraints are cleared.
+    bool technique_remove_parallel_constraints() {
+        const std::ptrdiff_t num_constraints = model_.num_constraints();
+
+        // The normalized row of each constraint, sorted by variable, along with the
+        // coefficient it was divided by and its hash. Constraints we don't consider
+        // are left with a scale of 0.
+        std::vector<std::vector<std::pair<index_type, bias_type>>> rows(num_constraints);
+        std::vector<bias_type> scales(num_constraints, 0);
+        std::vector<std::size_t> hashes(num_constraints, 0);
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+        for (std::ptrdiff_t c = 0; c < num_constraints; ++c) {
+            const auto& constraint = model_.constraint_ref(c);
+
+            if (constraint.is_soft() || !constraint.num_variables() || !constraint.is_linear()) {
+                continue;
+            }
+
+            const expression_base_type& base = constraint;
+            const auto& variables = constraint.variables();
+            auto& row = rows[c];
+            row.reserve(base.num_variables());
+            for (size_type vi = 0; vi < base.num_variables(); ++vi) {
+                row.emplace_back(variables[vi], base.linear(vi));
+            }
+            std::sort(row.begin(), row.end());
+
+            const bias_type scale = row.front().second;
+            if (!scale) continue;
+
+            std::size_t hash = row.size();
+            auto combine = [&hash](std::size_t value) {
+                hash ^= value + 0x9e3779b97f4a7c15u + (hash << 6) + (hash >> 2);
+            };
+            for (auto& [v, a] : row) {
+                a /= scale;
+                combine(std::hash<index_type>()(v));
+                combine(std::hash<bias_type>()(a));
+            }
+
+            scales[c] = scale;
+            hashes[c] = hash;
+        }
+
+        // Bucket the constraints by their hash
+        std::vector<index_type> order;
+        for (std::ptrdiff_t c = 0; c < num_constraints; ++c) {
+            if (scales[c]) order.emplace_back(c);
+        }
+        std::sort(order.begin(), order.end(), [&hashes](index_type a, index_type b) {
+            return hashes[a] < hashes[b] || (hashes[a] == hashes[b] && a < b);
+        });
+        std::vector<size_type> bucket_starts;
+        for (size_type i = 0; i < order.size(); ++i) {
+            if (!i || hashes[order[i]] != hashes[order[i - 1]]) bucket_starts.emplace_back(i);
+        }
+        bucket_starts.emplace_back(order.size());
+
+        // Within a bucket, find the groups of identical rows and decide which of their
+        // constraints to clear
+        std::vector<char> clear(num_constraints, false);
+        const std::ptrdiff_t num_buckets = bucket_starts.size() - 1;
+        size_type num_infeasible = 0;
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads) reduction(+ : num_infeasible)
+        for (std::ptrdiff_t b = 0; b < num_buckets; ++b) {
+            const size_type begin = bucket_starts[b];
+            const size_type end = bucket_starts[b + 1];
+            if (end - begin < 2) continue;
+
+            std::vector<char> grouped(end - begin, false);
+            for (size_type i = begin; i < end; ++i) {
+                if (grouped[i - begin]) continue;
+
+                // The tightest bounds on the normalized row, and the constraints that
+                // give them
+                bias_type lower = -std::numeric_limits<bias_type>::infinity();
+                bias_type upper = std::numeric_limits<bias_type>::infinity();
+                index_type lower_c = -1;
+                index_type upper_c = -1;
+                index_type equality_c = -1;
+
+                std::vector<index_type> group;
+                for (size_type j = i; j < end; ++j) {
+                    if (grouped[j - begin] || rows[order[j]] != rows[order[i]]) continue;
+                    grouped[j - begin] = true;
+
+                    const index_type c = order[j];
+                    const auto& constraint = model_.constraint_ref(c);
+                    const bias_type bound = constraint.rhs() / scales[c];
+                    group.emplace_back(c);
+
+                    if (constraint.sense() == dimod::Sense::EQ) {
+                        if (equality_c < 0 ||
+                            (constraint.marked_discrete() &&
+                             !model_.constraint_ref(equality_c).marked_discrete())) {
+                            equality_c = c;
+                        }
+                    }
+                    if (constraint.sense() == dimod::Sense::EQ ||
+                        (constraint.sense() == dimod::Sense::LE) != (scales[c] > 0)) {
+                        if (bound > lower) {
+                            lower = bound;
+                            lower_c = c;
+                        }
+                    }
+                    if (constraint.sense() == dimod::Sense::EQ ||
+                        (constraint.sense() == dimod::Sense::LE) == (scales[c] > 0)) {
+                        if (bound < upper) {
+                            upper = bound;
+                            upper_c = c;
+                        }
+                    }
+                }
+
+                if (group.size() < 2) continue;
+
+                if (lower > upper + FEASIBILITY_TOLERANCE) {
+                    ++num_infeasible;
+                    continue;
+                }
+
+                for (const index_type& c : group) {
+                    if (equality_c >= 0) {
+                        clear[c] = c != equality_c;
+                    } else {
+                        clear[c] = c != lower_c && c != upper_c;
+                    }
+                }
+            }
+        }
+
+        if (num_infeasible) {
+            model_.feasibility = Feasibility::Infeasible;
+            return false;
+        }
+
+        bool changes = false;
+        for (std::ptrdiff_t c = 0; c < num_constraints; ++c) {
+            if (clear[c]) {
+                model_.constraint_ref(c).clear();
+                changes = true;
+            }
+        }
+        return changes;
+    }
+
+    /// Fix the binary variables of the objective that are in no constraint to their
+    /// strong persistencies, found by roof duality. See fix_variables.hpp.
+    /// Soft constraints count too, their penalties are part of what is minimized.
+    /// Variables that interact with a variable that can't be fixed are skipped, so
+    /// the fixed ones form a sub-BQM that can be minimized on its own. The variables
+    /// are fixed by their bounds, presolve() removes them at the end.
+    bool technique_roof_duality() {
+        const auto& objective = model_.objective();
+        const expression_base_type& base = objective;
+        const auto& variables = objective.variables();
+
+        // Whether each variable of the objective, by its index in the objective, can
+        // be fixed
+        std::vector<bool> fixable(base.num_variables(), false);
+        {
+            std::vector<bool> constrained(model_.num_variables(), false);
+            for (size_type c = 0; c < model_.num_constraints(); ++c) {
+                for (const auto& v : model_.constraint_ref(c).variables()) {
+                    constrained[v] = true;
+                }
+            }
+            for (size_type vi = 0; vi < base.num_variables(); ++vi) {
+                const index_type v = variables[vi];
+                fixable[vi] = !constrained[v] && model_.vartype(v) == dimod::Vartype::BINARY &&
+                              model_.lower_bound(v) < model_.upper_bound(v);
+            }
+        }
+
+        // Walk out from the variables that can't be fixed, dropping every fixable
+        // variable they reach
+        std::vector<size_type> stack;
+        for (size_type vi = 0; vi < base.num_variables(); ++vi) {
+            if (!fixable[vi]) stack.emplace_back(vi);
+        }
+        while (!stack.empty()) {
+            const size_type vi = stack.back();
+            stack.pop_back();
+            const auto end = base.cend_neighborhood(vi);
+            for (auto it = base.cbegin_neighborhood(vi); it != end; ++it) {
+                if (fixable[it->v]) {
+                    fixable[it->v] = false;
+                    stack.emplace_back(it->v);
+                }
+            }
+        }
+
+        // Copy the fixable part of the objective into a BQM
+        std::vector<index_type> bqm_variables(base.num_variables(), -1);
+        std::vector<size_type> objective_variables;
+        for (size_type vi = 0; vi < base.num_variables(); ++vi) {
+            if (!fixable[vi]) continue;
+            bqm_variables[vi] = objective_variables.size();
+            objective_variables.emplace_back(vi);
+        }
+        if (objective_variables.empty()) return false;
+
+        dimod::BinaryQuadraticModel<bias_type, index_type> bqm(objective_variables.size(),
+                                                               dimod::Vartype::BINARY);
+        for (size_type ui = 0; ui < objective_variables.size(); ++ui) {
+            const size_type vi = objective_variables[ui];
+            bqm.set_linear(ui, base.linear(vi));
+            const auto end = base.cend_neighborhood(vi);
+            for (auto it = base.cbegin_neighborhood(vi); it != end; ++it) {
+                if (bqm_variables[it->v] > static_cast<index_type>(ui)) {
+                    bqm.add_quadratic(ui, bqm_variables[it->v], it->bias);
+                }
+            }
+        }
+
+        const auto fixed =
+                fix_variables_::fixQuboVariables(bqm, true, 0.0, MaxFlowAlgorithm::AUTOMATIC)
+                        .second;
+
+        bool changes = false;
+        for (const auto& [u, value] : fixed) {
+            changes |= model_.fix_variable(variables[objective_variables[u]], value);
+        }
+        return changes;
+    }
+
     /// The maximum number of rounds of presolving
     int max_num_rounds = 100;
 
+    /// The number of threads used by presolve(). If greater than 1, each round
+    /// is made of passes that evaluate the constraints in parallel against the
+    /// bounds at the start of the pass, then apply the tightest bound found for
+    /// each variable. The passes continue until no constraints are left queued.
+    /// The results are deterministic and the same for any number of threads
+    /// greater than 1. A single thread instead visits the constraints one after
+    /// the other, each seeing the bounds found by the ones before it, so it can
+    /// stop at different reductions. Has no effect unless compiled with OpenMP.
+    int num_threads = 1;
+
     TechniqueFlags techniques = TechniqueFlags::Default;
 
+    /// The order in which TechniqueFlags::Probing probes the binary variables.
+    ProbingOrder probing_order = ProbingOrder::MostConstrainedFirst;
+
+    /// The budget of TechniqueFlags::Probing. Probing stops once it has run for
+    /// `probing_time_limit` or spent `probing_work_limit` work units, see
+    /// presolve(), or once the limits given to presolve() are reached.
+    std::chrono::duration<double> probing_time_limit =
+            std::chrono::duration<double>(std::numeric_limits<double>::infinity());
+    size_type probing_work_limit = 10000000;
+
  private:
     // We want to control access to the model in order to track changes,
     // so we create a rump version of the model.
@@ -753,7 +1331,8 @@ class PresolverImpl {
         ModelView() = default;
         ~ModelView() = default;
 
-        explicit ModelView(model_type&& model) : model_type(model) {}
+        explicit ModelView(model_type&& model)
+                : model_type(model), num_original_variables_(num_variables()) {}
 
         // Const methods are all safe to expose
         using model_type::num_constraints;
@@ -771,8 +1350,9 @@ class PresolverImpl {
         using model_type::add_linear_constraint;
         using model_type::remove_constraints_if;
 
-        // The bound changes don't get tracked, but we do want to maintain normalization
-        // and test for feasibility
+        // The bound changes don't get tracked as transforms, but we do want to maintain
+        // normalization and test for feasibility. We also log which variables had their
+        // bounds tightened so the presolve loop can revisit the affected constraints.
         bool set_lower_bound(index_type v, bias_type lb) {
             // handle the discrete vartypes
             switch (vartype(v)) {
@@ -791,6 +1371,7 @@ class PresolverImpl {
             }
 
             if (lb > lower_bound(v)) {
+                bound_changes_.push_back({v, false, lower_bound(v), lb});
                 model_type::set_lower_bound(v, lb);
                 return true;
             }
@@ -815,6 +1396,7 @@ class PresolverImpl {
             }
 
             if (ub < upper_bound(v)) {
+                bound_changes_.push_back({v, true, upper_bound(v), ub});
                 model_type::set_upper_bound(v, ub);
                 return true;
             }
@@ -822,6 +1404,34 @@ class PresolverImpl {
             return false;
         }
 
+        // A single tightening of a variable's lower or upper bound
+        struct BoundChange {
+            index_type v;
+            bool upper;  // whether it was the upper or the lower bound
+            bias_type old_bound;
+            bias_type new_bound;
+        };
+
+        // The bound changes made since the last call to clear_bound_changes(), in
+        // the order they were made. A variable may appear more than once.
+        const std::vector<BoundChange>& bound_changes() const { return bound_changes_; }
+        void clear_bound_changes() { bound_changes_.clear(); }
+
+        // Undo the bound changes, last to first, until only the first num_kept are
+        // left. The feasibility is not restored. Used by probing to look at the
+        // consequences of a bound without keeping them.
+        void undo_bound_changes(size_type num_kept) {
+            while (bound_changes_.size() > num_kept) {
+                const BoundChange& change = bound_changes_.back();
+                if (change.upper) {
+                    model_type::set_upper_bound(change.v, change.old_bound);
+                } else {
+                    model_type::set_lower_bound(change.v, change.old_bound);
+                }
+                bound_changes_.pop_back();
+            }
+        }
+
         // Expose the objective. Changes don't get tracked
         auto& objective() { return static_cast<model_type*>(this)->objective; }
         const auto& objective() const { return static_cast<const model_type*>(this)->objective; }
@@ -840,8 +1450,8 @@ class PresolverImpl {
         // Track when we add a variable to the model.
         index_type add_variable(dimod::Vartype vartype, bias_type lb, bias_type ub) {
             index_type v = model_type::add_variable(vartype, lb, ub);
-            transforms_.emplace_back(TransformKind::ADD);
-            transforms_.back().v = v;
+            push_transform(TransformKind::ADD);
+            added_variables_.emplace_back(v);
             return v;
         }
 
@@ -850,10 +1460,8 @@ class PresolverImpl {
             if ((model_type::vartype(v) == dimod::Vartype::SPIN) &&
                 (vartype == dimod::Vartype::BINARY)) {
                 // SPIN->BINARY
-                transforms_.emplace_back(TransformKind::SUBSTITUTE);
-                transforms_.back().v = v;
-                transforms_.back().multiplier = 2;
-                transforms_.back().offset = -1;
+                push_transform(TransformKind::SUBSTITUTE);
+                substitutions_.push_back({v, 2, -1});
             } else {
                 // We currently only need SPIN->BINARY, but can add more as needed
                 throw std::logic_error("unsupported vartype change");
@@ -861,6 +1469,14 @@ class PresolverImpl {
             model_type::change_vartype(vartype, v);
         }
 
+        // Fix a variable by setting both of its bounds. The variable is not removed
+        // from the model until fix_variables() is called, which presolve() does once
+        // at the end. Returns whether either bound changed.
+        bool fix_variable(index_type v, assignment_type assignment) {
+            // Use | rather than || because we don't want to short-circuit
+            return set_lower_bound(v, assignment) | set_upper_bound(v, assignment);
+        }
+
         // Track the variables that are fixed.
         // Require that the variables are in sorted order.
         void fix_variables(const std::vector<index_type>& variables,
@@ -876,77 +1492,556 @@ class PresolverImpl {
             // track the changes as if we had applied them one-by-one, but do it
             // in reverse order so that when we're restoring we're pushing onto the end
             assert(std::is_sorted(variables.begin(), variables.end()));
-            auto vit = variables.rbegin();
-            const auto last = variables.rend();
-            auto ait = assignments.rbegin();
-            for (; vit != last; ++vit, ++ait) {
-                transforms_.emplace_back(TransformKind::FIX);
-                transforms_.back().v = (*vit);
-                transforms_.back().value = *ait;
+            push_transform(TransformKind::FIX, variables.size());
+            fixed_variables_.insert(fixed_variables_.end(), variables.rbegin(), variables.rend());
+            fixed_values_.insert(fixed_values_.end(), assignments.rbegin(), assignments.rend());
+
+            // Rather than model_type::fix_variables(), which builds the reduced model while
+            // all of the original is still alive, we move the model over one expression at
+            // a time, releasing each constraint once it has been copied. That way the peak
+            // memory is about one model rather than two.
+
+            // The new index of each variable, or -1 for the fixed ones
+            std::vector<index_type> mapping(num_variables(), 0);
+            std::vector<assignment_type> values(num_variables(), 0);
+            for (size_type i = 0; i < variables.size(); ++i) {
+                mapping[variables[i]] = -1;
+                values[variables[i]] = assignments[i];
+            }
+
+            model_type cqm;
+            for (size_type v = 0; v < num_variables(); ++v) {
+                if (mapping[v] < 0) continue;
+                mapping[v] = cqm.add_variable(vartype(v), lower_bound(v), upper_bound(v));
+            }
+
+            // A single pass over expression, folding the fixed variables into the offset and
+            // the linear biases while relabelling the rest.
+            auto fold = [&](const expression_type& expression, expression_type& reduced) {
+                const expression_base_type& base = expression;
+                const auto& labels = expression.variables();
+
+                reduced.add_offset(base.offset());
+                for (size_type vi = 0; vi < base.num_variables(); ++vi) {
+                    const index_type& v = labels[vi];
+                    if (mapping[v] < 0) {
+                        reduced.add_offset(base.linear(vi) * values[v]);
+                    } else {
+                        reduced.add_linear(mapping[v], base.linear(vi));
+                    }
+                }
+                for (auto it = base.cbegin_quadratic(); it != base.cend_quadratic(); ++it) {
+                    const index_type& u = labels[it->u];
+                    const index_type& v = labels[it->v];
+                    if (mapping[u] < 0 && mapping[v] < 0) {
+                        reduced.add_offset(it->bias * values[u] * values[v]);
+                    } else if (mapping[u] < 0) {
+                        reduced.add_linear(mapping[v], it->bias * values[u]);
+                    } else if (mapping[v] < 0) {
+                        reduced.add_linear(mapping[u], it->bias * values[v]);
+                    } else {
+                        reduced.add_quadratic(mapping[u], mapping[v], it->bias);
+                    }
+                }
+            };
+
+            fold(objective(), cqm.objective);
+
+            for (auto& constraint : constraints()) {
+                auto reduced = cqm.new_constraint();
+                fold(constraint, reduced);
+                reduced.set_sense(constraint.sense());
+                reduced.set_rhs(constraint.rhs());
+                reduced.set_weight(constraint.weight());
+                reduced.set_penalty(constraint.penalty());
+                reduced.mark_discrete(constraint.marked_discrete());
+                cqm.add_constraint(std::move(reduced));
+
+                // release the memory used by the original constraint
+                constraint = model_type::new_constraint();
             }
 
-            /// fix the variables in-place.
             using std::swap;  // ADL, though doubt it makes a difference
-            auto cqm = model_type::fix_variables(variables.begin(), variables.end(),
-                                                 assignments.begin());
             swap(*this, cqm);
         }
 
         // Restore a sample by undoing all of the transforms
         template <class T>
         std::vector<T> restore(std::vector<T> sample) const {
+            if (restore_plan_.num_transforms == num_transforms()) {
+                return restore_plan_.restore(std::move(sample));
+            }
+
             // all that we have to do is undo the transforms back to front.
-            for (auto it = transforms_.crbegin(); it != transforms_.crend(); ++it) {
-                switch (it->kind) {
-                    case TransformKind::FIX:
-                        sample.insert(sample.begin() + it->v, it->value);
-                        break;
-                    case TransformKind::SUBSTITUTE:
-                        sample[it->v] *= it->multiplier;
-                        sample[it->v] += it->offset;
-                        break;
-                    case TransformKind::ADD:
-                        sample.erase(sample.begin() + it->v);
-                        break;
+            size_type fi = fixed_variables_.size();
+            size_type si = substitutions_.size();
+            size_type ai = added_variables_.size();
+            for (auto run = transform_runs_.crbegin(); run != transform_runs_.crend(); ++run) {
+                for (size_type n = 0; n < run->size; ++n) {
+                    switch (run->kind) {
+                        case TransformKind::FIX:
+                            --fi;
+                            sample.insert(sample.begin() + fixed_variables_[fi], fixed_values_[fi]);
+                            break;
+                        case TransformKind::SUBSTITUTE:
+                            --si;
+                            sample[substitutions_[si].v] *= substitutions_[si].multiplier;
+                            sample[substitutions_[si].v] += substitutions_[si].offset;
+                            break;
+                        case TransformKind::ADD:
+                            --ai;
+                            sample.erase(sample.begin() + added_variables_[ai]);
+                            break;
+                    }
                 }
             }
             return sample;
         }
 
+        // Restore a row-major array of num_samples samples of the reduced model into
+        // a row-major array of samples of the original model.
+        template <class T>
+        void restore_batch(const T* reduced, size_type num_samples, assignment_type* original,
+                           int num_threads = 1) const {
+            if (restore_plan_.num_transforms == num_transforms()) {
+                restore_plan_.restore_batch(reduced, num_samples, original, num_threads);
+            } else {
+                make_restore_plan().restore_batch(reduced, num_samples, original, num_threads);
+            }
+        }
+
+        // Serialize the restore plan so it can be loaded by a Restorer
+        std::string serialize_restore() const {
+            if (restore_plan_.num_transforms == num_transforms()) {
+                return restore_plan_.serialize();
+            } else {
+                return make_restore_plan().serialize();
+            }
+        }
+
+        // Compile the transforms into a restore plan used by restore() and
+        // restore_batch(). The plan is only used until more transforms are added.
+        void compile_restore_plan() { restore_plan_ = make_restore_plan(); }
+
+        // The number of variables in the model the view was constructed with
+        size_type num_original_variables() const { return num_original_variables_; }
+
         Feasibility feasibility = Feasibility::Unknown;
 
      private:
         // we want to track what changes were made
-        enum TransformKind { FIX, SUBSTITUTE, ADD };
+        enum TransformKind : std::uint8_t { FIX, SUBSTITUTE, ADD };
 
-        // We could get fancy with pointers and templates to save a bit of space here
-        struct Transform {
+        // Each kind of transform is stored in its own arrays. To replay them in the right
+        // order, we also store the kinds in the order they were applied as a sequence of
+        // runs of the same kind.
+        struct TransformRun {
             TransformKind kind;
-            index_type v;           // what variable it was applied to
-            assignment_type value;  // if it was fixed what it was fixed to
+            size_type size;
+        };
+        std::vector<TransformRun> transform_runs_;
+
+        // FIX: the variable and the value it was fixed to
+        std::vector<index_type> fixed_variables_;
+        std::vector<assignment_type> fixed_values_;
+
+        // SUBSTITUTE: the variable v was replaced by multiplier * v + offset
+        struct Substitution {
+            index_type v;
             bias_type multiplier;
             bias_type offset;
-
-            explicit Transform(TransformKind kind)
-                    : kind(kind), v(-1), value(NAN), multiplier(NAN), offset(NAN) {}
         };
+        std::vector<Substitution> substitutions_;
 
-        std::vector<Transform> transforms_;
-    };
-
-    template <dimod::Sense Sense>
-    bool technique_domain_propagation(const constraint_type& constraint) {
-        // Dev note: if-branche(s) below rely on this static assert
-        static_assert(Sense == dimod::Sense::GE || Sense == dimod::Sense::LE,
-                      "Sense must be <= or >=; equality constraints should call both");
+        // ADD: the variable that was added
+        std::vector<index_type> added_variables_;
 
-        assert(constraint.sense() == dimod::Sense::EQ || constraint.sense() == Sense);
+        void push_transform(TransformKind kind, size_type num = 1) {
+            if (transform_runs_.empty() || transform_runs_.back().kind != kind) {
+                transform_runs_.push_back({kind, 0});
+            }
+            transform_runs_.back().size += num;
+        }
 
-        // todo: extend to quadratic
-        if (!constraint.is_linear()) {
-            return false;  // no changes
+        size_type num_transforms() const {
+            return fixed_variables_.size() + substitutions_.size() + added_variables_.size();
+        }
+
+        // A flat version of the transforms so that samples can be restored in a
+        // single pass. For each variable i of the original model
+        //     original[i] = fill[i]
+        // and then for each of the variables that come from the reduced model
+        //     original[gather_original[k]] += multiplier[k] * reduced[gather_reduced[k]]
+        struct RestorePlan {
+            // The number of transforms the plan was compiled from
+            size_type num_transforms = std::numeric_limits<size_type>::max();
+
+            size_type num_reduced = 0;
+
+            std::vector<assignment_type> fill;
+            std::vector<index_type> gather_original;
+            std::vector<index_type> gather_reduced;
+            std::vector<assignment_type> multiplier;
+
+            template <class T>
+            std::vector<T> restore(std::vector<T> reduced) const {
+                std::vector<T> original(fill.size());
+                for (size_type i = 0; i < fill.size(); ++i) {
+                    original[i] = fill[i];
+                }
+                for (size_type k = 0; k < gather_original.size(); ++k) {
+                    original[gather_original[k]] =
+                            multiplier[k] * reduced[gather_reduced[k]] + fill[gather_original[k]];
+                }
+                return original;
+            }
+
+            template <class T>
+            void restore_batch(const T* reduced, size_type num_samples, assignment_type* original,
+                               int num_threads) const {
+                const size_type num_original = fill.size();
+                const size_type num_gather = gather_original.size();
+
+#pragma omp parallel for num_threads(num_threads)
+                for (std::ptrdiff_t si = 0; si < static_cast<std::ptrdiff_t>(num_samples); ++si) {
+                    const T* in = reduced + si * num_reduced;
+                    assignment_type* out = original + si * num_original;
+
+                    std::copy(fill.begin(), fill.end(), out);
+                    for (size_type k = 0; k < num_gather; ++k) {
+                        out[gather_original[k]] += multiplier[k] * in[gather_reduced[k]];
+                    }
+                }
+            }
+
+            std::string serialize() const {
+                return Restorer::serialize(
+                        num_reduced, std::vector<double>(fill.begin(), fill.end()),
+                        std::vector<std::int64_t>(gather_original.begin(), gather_original.end()),
+                        std::vector<std::int64_t>(gather_reduced.begin(), gather_reduced.end()),
+                        std::vector<double>(multiplier.begin(), multiplier.end()));
+            }
+        };
+
+        // Replay the transforms symbolically to get the restore plan
+        RestorePlan make_restore_plan() const {
+            // Each variable is reduced[source] * multiplier + offset, or just offset if
+            // source is negative.
+            struct Term {
+                index_type source;
+                assignment_type multiplier;
+                assignment_type offset;
+            };
+
+            // Work out how many variables the reduced model has
+            const size_type num_reduced =
+                    num_original_variables_ + added_variables_.size() - fixed_variables_.size();
+
+            std::vector<Term> terms(num_reduced);
+            for (size_type i = 0; i < num_reduced; ++i) {
+                terms[i] = Term{static_cast<index_type>(i), 1, 0};
+            }
+
+            // The same as restore(), back to front, but with terms rather than values.
+            size_type fi = fixed_variables_.size();
+            size_type si = substitutions_.size();
+            size_type ai = added_variables_.size();
+            std::vector<Term> buffer;
+            for (auto run = transform_runs_.crbegin(); run != transform_runs_.crend(); ++run) {
+                switch (run->kind) {
+                    case TransformKind::FIX: {
+                        // fix_variables() records its variables in descending index order so
+                        // back to front we see ascending indices. Each is inserted after the
+                        // last, so we can merge each ascending sequence in one pass.
+                        const size_type first = fi - run->size;
+                        while (fi > first) {
+                            size_type last = fi - 1;
+                            while (last > first &&
+                                   fixed_variables_[last - 1] > fixed_variables_[last]) {
+                                --last;
+                            }
+
+                            buffer.clear();
+                            buffer.reserve(terms.size() + (fi - last));
+                            auto tit = terms.cbegin();
+                            for (; fi > last; --fi) {
+                                const index_type& v = fixed_variables_[fi - 1];
+                                while (static_cast<index_type>(buffer.size()) < v) {
+                                    buffer.emplace_back(*tit++);
+                                }
+                                buffer.emplace_back(Term{-1, 0, fixed_values_[fi - 1]});
+                            }
+                            buffer.insert(buffer.end(), tit, terms.cend());
+                            std::swap(terms, buffer);
+                        }
+                        break;
+                    }
+                    case TransformKind::SUBSTITUTE:
+                        for (size_type n = 0; n < run->size; ++n) {
+                            const Substitution& sub = substitutions_[--si];
+                            terms[sub.v].multiplier *= sub.multiplier;
+                            terms[sub.v].offset = terms[sub.v].offset * sub.multiplier + sub.offset;
+                        }
+                        break;
+                    case TransformKind::ADD:
+                        for (size_type n = 0; n < run->size; ++n) {
+                            terms.erase(terms.begin() + added_variables_[--ai]);
+                        }
+                        break;
+                }
+            }
+
+            RestorePlan plan;
+            plan.num_transforms = num_transforms();
+            plan.num_reduced = num_reduced;
+            plan.fill.reserve(terms.size());
+            for (size_type i = 0; i < terms.size(); ++i) {
+                plan.fill.emplace_back(terms[i].offset);
+                if (terms[i].source >= 0) {
+                    plan.gather_original.emplace_back(i);
+                    plan.gather_reduced.emplace_back(terms[i].source);
+                    plan.multiplier.emplace_back(terms[i].multiplier);
+                }
+            }
+            return plan;
         }
 
+        RestorePlan restore_plan_;
+
+        size_type num_original_variables_ = 0;
+
+        std::vector<BoundChange> bound_changes_;
+    };
+
+    // Very large activities will create numeric issues. So we don't do domain
+    // propagation on those
+    static constexpr double MAX_ACTIVITY = 1.0e10;
+
+    // The minimal and maximal activity of the quadratic term bias * u * v, for u in
+    // [lb_u, ub_u] and v in [lb_v, ub_v]. A bilinear term is extremal at the corners
+    // of its domain, so these are exact for u != v and bounds for self-loops.
+    static std::pair<bias_type, bias_type> quadratic_activity(bias_type bias, bias_type lb_u,
+                                                              bias_type ub_u, bias_type lb_v,
+                                                              bias_type ub_v) {
+        const bias_type corners[4] = {bias * lb_u * lb_v, bias * lb_u * ub_v, bias * ub_u * lb_v,
+                                      bias * ub_u * ub_v};
+        const auto [minimal, maximal] = std::minmax_element(corners, corners + 4);
+        return {*minimal, *maximal};
+    }
+
+    // The minimal and maximal activity of a constraint. We keep the large
+    // activities (see MAX_ACTIVITY) separate from the rest so that domain propagation
+    // can work with the others. See Achterberg et al., section 3.2. Each quadratic
+    // term contributes its own activity range, see quadratic_activity(), so for
+    // quadratic constraints the activities are bounds on the true ones.
+    struct Activity {
+        // The sums of the minimal/maximal activities that are not large, plus the offset
+        bias_type minimal = 0;
+        bias_type maximal = 0;
+
+        // The sums and the number of the minimal/maximal activities that are large
+        bias_type minimal_large = 0;
+        bias_type maximal_large = 0;
+        size_type num_minimal_large = 0;
+        size_type num_maximal_large = 0;
+
+        // The number of incremental updates since the activity was last calculated
+        // from scratch. Used to bound the accumulation of rounding errors.
+        size_type num_updates = 0;
+
+        bool valid = false;
+
+        // Whether the constraint has no quadratic terms. Cached so that the techniques
+        // don't need to call constraint.is_linear(), which is O(n).
+        bool linear = true;
+
+        Activity() = default;
+
+        // Calculate the activity of a constraint
+        explicit Activity(const constraint_type& constraint)
+                : minimal(constraint.offset()), maximal(constraint.offset()), valid(true) {
+            const expression_base_type& base = constraint;
+            for (size_type vi = 0; vi < base.num_variables(); ++vi) {
+                const bias_type a = base.linear(vi);
+                const bias_type lb = base.lower_bound(vi);
+                const bias_type ub = base.upper_bound(vi);
+                update_minimal(0, (a > 0) ? a * lb : a * ub, false);
+                update_maximal(0, (a > 0) ? a * ub : a * lb, false);
+            }
+            for (auto it = base.cbegin_quadratic(), end = base.cend_quadratic(); it != end; ++it) {
+                const auto [term_minimal, term_maximal] = quadratic_activity(
+                        it->bias, base.lower_bound(it->u), base.upper_bound(it->u),
+                        base.lower_bound(it->v), base.upper_bound(it->v));
+                update_minimal(0, term_minimal, false);
+                update_maximal(0, term_maximal, false);
+                linear = false;
+            }
+        }
+
+        // Replace one of the contributions to the minimal activity with another
+        void update_minimal(bias_type old_activity, bias_type new_activity, bool remove = true) {
+            update(minimal, minimal_large, num_minimal_large, old_activity, new_activity, remove);
+        }
+
+        // Replace one of the contributions to the maximal activity with another
+        void update_maximal(bias_type old_activity, bias_type new_activity, bool remove = true) {
+            update(maximal, maximal_large, num_maximal_large, old_activity, new_activity, remove);
+        }
+
+        // The total minimal/maximal activity
+        bias_type total_minimal() const { return minimal + minimal_large; }
+        bias_type total_maximal() const { return maximal + maximal_large; }
+
+     private:
+        static void update(bias_type& sum, bias_type& large_sum, size_type& num_large,
+                           bias_type old_activity, bias_type new_activity, bool remove) {
+            if (remove) {
+                if (std::abs(old_activity) > MAX_ACTIVITY) {
+                    large_sum -= old_activity;
+                    --num_large;
+                } else {
+                    sum -= old_activity;
+                }
+            }
+            if (std::abs(new_activity) > MAX_ACTIVITY) {
+                large_sum += new_activity;
+                ++num_large;
+            } else {
+                sum += new_activity;
+            }
+        }
+    };
+
+    // Get the activity of constraint c. The activity is cached and kept up to date
+    // with the bound changes by process_bound_changes().
+    const Activity& activity(index_type c) {
+        Activity& activity = activities_[c];
+        if (!activity.valid) {
+            activity = Activity(model_.constraint_ref(c));
+        }
+        return activity;
+    }
+
+    // Whether the constraint has been cleared by technique_clear_redundant_constraint()
+    static bool is_cleared(const constraint_type& constraint) {
+        return !constraint.num_variables() && !constraint.offset() && !constraint.rhs();
+    }
+
+    bool technique_clear_redundant_constraint(index_type c) {
+        auto& constraint = model_.constraint_ref(c);
+
+        if (is_cleared(constraint)) {
+            return false;
+        }
+
+        // bring the activity up to date with any changes made by the other techniques
+        process_bound_changes();
+
+        return technique_clear_redundant_constraint(constraint, activity(c));
+    }
+
+    bool technique_clear_redundant_constraint(constraint_type& constraint,
+                                              const Activity& activity) {
+        const bias_type minac = activity.total_minimal();
+        const bias_type maxac = activity.total_maximal();
+        // Test if the constraint is trivially infeasible
+        if (constraint.sense() == dimod::Sense::LE || constraint.sense() == dimod::Sense::EQ) {
+            if (minac > constraint.rhs() + FEASIBILITY_TOLERANCE) {
+                // Soft constraints don't cause the model to be infeasible.
+                if (!constraint.is_soft()) {
+                    model_.feasibility = Feasibility::Infeasible;
+                }
+
+                return false;
+            }
+        }
+        if (constraint.sense() == dimod::Sense::GE || constraint.sense() == dimod::Sense::EQ) {
+            if (maxac < constraint.rhs() - FEASIBILITY_TOLERANCE) {
+                // Soft constraints don't cause the model to be infeasible.
+                if (!constraint.is_soft()) {
+                    model_.feasibility = Feasibility::Infeasible;
+                }
+
+                return false;
+            }
+        }
+
+        // Test if the constraint is always satisfied
+        // If the constraint is soft, it can just be remove it because it will
+        // contribute 0 to the energy of the problem.
+        switch (constraint.sense()) {
+            case dimod::Sense::LE:
+                if (maxac <= constraint.rhs() + FEASIBILITY_TOLERANCE) {
+                    constraint.clear();
+                    return true;
+                }
+                break;
+            case dimod::Sense::GE:
+                if (minac >= constraint.rhs() - FEASIBILITY_TOLERANCE) {
+                    constraint.clear();
+                    return true;
+                }
+                break;
+            case dimod::Sense::EQ:
+                if (minac == constraint.rhs() && maxac == constraint.rhs()) {
+                    constraint.clear();
+                    return true;
+                }
+                break;
+        }
+
+        return false;
+    }
+
+    bool technique_domain_propagation(index_type c) {
+        const auto& constraint = model_.constraint_ref(c);
+
+        bool changes = false;
+
+        auto tighten = [this](index_type v, bool upper, bias_type bound) {
+            return tighten_bound(v, upper, bound);
+        };
+
+        if (constraint.sense() == dimod::Sense::LE || constraint.sense() == dimod::Sense::EQ) {
+            changes |= technique_domain_propagation<dimod::Sense::LE>(constraint, activity(c),
+                                                                       tighten);
+        }
+
+        if (constraint.sense() == dimod::Sense::GE || constraint.sense() == dimod::Sense::EQ) {
+            // bring the activity up to date with any changes made for <=
+            process_bound_changes();
+            changes |= technique_domain_propagation<dimod::Sense::GE>(constraint, activity(c),
+                                                                       tighten);
+        }
+
+        return changes;
+    }
+
+    // Tighten the upper or lower bound of v, returning whether the bound changed
+    bool tighten_bound(index_type v, bool upper, bias_type bound) {
+        // handles vartype and feasibility
+        const bool changed =
+                upper ? model_.set_upper_bound(v, bound) : model_.set_lower_bound(v, bound);
+
+        // the techniques can also be called outside of presolve()
+        if (changed && !statistics_.rounds.empty()) {
+            ++statistics_.rounds.back().num_bounds_tightened;
+        }
+
+        return changed;
+    }
+
+    // Do domain propagation on one side of a constraint. The new bounds are passed
+    // to tighten(v, upper, bound) which returns whether anything changed.
+    template <dimod::Sense Sense, class Tighten>
+    bool technique_domain_propagation(const constraint_type& constraint,
+                                      const Activity& activity, Tighten&& tighten) {
+        // Dev note: if-branche(s) below rely on this static assert
+        static_assert(Sense == dimod::Sense::GE || Sense == dimod::Sense::LE,
+                      "Sense must be <= or >=; equality constraints should call both");
+
+        assert(constraint.sense() == dimod::Sense::EQ || constraint.sense() == Sense);
+
         // Cannot use soft constraints to strengthen bounds.
         if (constraint.is_soft()) {
             return false;  // no changes
@@ -956,55 +2051,78 @@ class PresolverImpl {
         // the reduction is small.
         static constexpr double BOUND_CHANGE_MINIMUM = 1.0e-3 * FEASIBILITY_TOLERANCE;
 
-        // Very large activities will create numeric issues. So we don't do domain
-        // propagation on those
-        static constexpr double MAX_ACTIVITY = 1.0e10;
-
         // In the following code there are three cases we want to account for:
         // - No large activities: we can do domain propagation on all of the variables
         // - Exactly one large activity: we can do domain propagation on the one variable with
         //   large activity
         // - 2+ large activities: we can't do domain propagation
 
-        // Precalculate the activities of each of the variables
-        std::vector<bias_type> activities;
-        std::vector<index_type> large_activities;
-        for (const auto& v : constraint.variables()) {
+        // We work with the variable indices of the constraint, so the biases and bounds
+        // don't need to be looked up by label
+        const expression_base_type& base = constraint;
+        const auto& variables = constraint.variables();
+
+        // The minimal (for <=) or maximal (for >=) activity of the terms that contain
+        // the variable vi, and a coefficient a such that those terms are at least (for
+        // <=) or at most (for >=) a * vi whatever the values of the other variables.
+        // For a linear term that's its bias. With interactions, a is the linear bias
+        // plus the extreme of each bias * u over u's bounds, which only holds when vi is
+        // non-negative, otherwise we return a coefficient of 0 so vi is not propagated.
+        auto variable_terms = [&](size_type vi) -> std::pair<bias_type, bias_type> {
+            const bias_type lb = base.lower_bound(vi);
+            const bias_type ub = base.upper_bound(vi);
+            bias_type a = base.linear(vi);
+            bias_type terms_activity;
             if constexpr (Sense == dimod::Sense::LE) {
-                activities.emplace_back(minimal_activity(constraint, v));
+                terms_activity = (a > 0) ? a * lb : a * ub;
             } else {  // Sense == dimod::Sense::GE, enforced by static_assert above
-                activities.emplace_back(maximal_activity(constraint, v));
+                terms_activity = (a > 0) ? a * ub : a * lb;
             }
 
-            if (std::abs(activities.back()) > MAX_ACTIVITY) {
-                large_activities.emplace_back(v);
+            if (activity.linear) return {terms_activity, a};
 
-                // Early exit test: in the case that we have more than one large
-                // activity, we cannot do domain propagation at all
-                // Everything will work without this test, but it can save some time
-                if (large_activities.size() > 1) {
-                    return false;  // no changes
+            const auto end = base.cend_neighborhood(vi);
+            for (auto it = base.cbegin_neighborhood(vi); it != end; ++it) {
+                const bias_type lb_u = base.lower_bound(it->v);
+                const bias_type ub_u = base.upper_bound(it->v);
+                const auto term = quadratic_activity(it->bias, lb, ub, lb_u, ub_u);
+                if constexpr (Sense == dimod::Sense::LE) {
+                    terms_activity += term.first;
+                    a += std::min(it->bias * lb_u, it->bias * ub_u);
+                } else {
+                    terms_activity += term.second;
+                    a += std::max(it->bias * lb_u, it->bias * ub_u);
                 }
-
-                // Since we've marked it as large, let's zero it out to make
-                // some of the sums later a bit safer
-                activities.back() = 0;
             }
+            if (lb < 0 && base.num_interactions(vi)) a = 0;
+
+            return {terms_activity, a};
+        };
+
+        // The total activity of everything (except the large activity variables)
+        bias_type total_activity;
+        size_type num_large;
+        if constexpr (Sense == dimod::Sense::LE) {
+            total_activity = activity.minimal;
+            num_large = activity.num_minimal_large;
+        } else {
+            total_activity = activity.maximal;
+            num_large = activity.num_maximal_large;
         }
 
-        // Get the total activity of everything (except the large activity variables)
-        const bias_type activity =
-                std::reduce(activities.begin(), activities.end()) + constraint.offset();
+        if (num_large > 1) {
+            return false;  // no changes
+        }
 
         // If, even excluding large activities, we get a large activity we can't do anything
-        if (std::abs(activity) > INF) {
+        if (std::abs(total_activity) > INF) {
             return false;  // no changes
         }
 
         // Create a function to do domain propagation given the activity of the rest
         // of the constraint for a single variable
-        auto propagate = [&](index_type v, bias_type activity_excluding_v) {
-            bias_type a = constraint.linear(v);
+        auto propagate = [&](index_type v, bias_type a, bias_type activity_excluding_v) {
+            if (!a) return false;
 
             // get the new bound
             const bias_type bound = (constraint.rhs() - activity_excluding_v) / a;
@@ -1016,45 +2134,571 @@ class PresolverImpl {
 
             bool changes = false;
             if (a > 0 && model_.upper_bound(v) - bound > BOUND_CHANGE_MINIMUM) {
-                changes |= model_.set_upper_bound(v, bound);  // handles vartype and feasibility
+                changes |= tighten(v, true, bound);
             } else if (a < 0 && bound - model_.lower_bound(v) > BOUND_CHANGE_MINIMUM) {
-                changes |= model_.set_lower_bound(v, bound);  // handles vartype and feasibility
+                changes |= tighten(v, false, bound);
             }
             return changes;
         };
 
-        // Alright, we're finally able to actually do domain propagation
+        // Alright, we're finally able to actually do domain propagation. Note that the
+        // activity is not updated as we go, which is fine because bounds only get tighter
+        // so at worst we miss some tightening that the next visit will find.
 
         bool changes = false;
 
-        if (large_activities.size() == 0) {
+        if (num_large == 0) {
             // we can do domain propagation on every variable
-            auto it = activities.begin();
-            for (const auto& v : constraint.variables()) {
-                // Just subtract out the activity of v
-                const bias_type activity_excluding_v = activity - *it;
+            for (size_type vi = 0; vi < base.num_variables(); ++vi) {
+                // Just subtract out the activity of the terms of vi
+                const auto [terms_activity, a] = variable_terms(vi);
 
-                changes |= propagate(v, activity_excluding_v);
-                ++it;
+                changes |= propagate(variables[vi], a, total_activity - terms_activity);
+            }
+        } else if (activity.linear) {
+            // We can only do domain propagation on the variable with large activity, which
+            // is not included in the total activity. In a quadratic constraint the large
+            // activity may be an interaction, so we don't try.
+            for (size_type vi = 0; vi < base.num_variables(); ++vi) {
+                const auto [terms_activity, a] = variable_terms(vi);
+                if (std::abs(terms_activity) > MAX_ACTIVITY) {
+                    changes |= propagate(variables[vi], a, total_activity);
+                    break;
+                }
+            }
+        }
+
+        return changes;
+    }
+
+    // Propagate the constraints after setting binary variable x to value, without
+    // keeping any of the bounds this implies. A constraint is queued each time one of
+    // its variables gets a tighter bound, and its activity is calculated from scratch
+    // so that the cached ones are left alone. Returns whether the value is infeasible,
+    // and otherwise fills `implied` with the tightest bound implied on each of the
+    // other variables, sorted by variable. The work is added to `work_units`. Stops
+    // once it has spent `work_limit` work units, in which case `implied` has the
+    // bounds found so far.
+    bool probe(index_type x, bool value, std::vector<implication_type>& implied,
+               size_type& work_units, size_type work_limit) {
+        implied.clear();
+        size_type probe_work_units = 0;
+
+        const size_type num_kept = model_.bound_changes().size();
+        const Feasibility feasibility = model_.feasibility;
+
+        // The bounds are set directly, they don't count as tightened
+        auto tighten = [this](index_type v, bool upper, bias_type bound) {
+            return upper ? model_.set_upper_bound(v, bound) : model_.set_lower_bound(v, bound);
+        };
+        tighten(x, !value, value);
+
+        // The bound changes up to num_queued have had their constraints queued
+        size_type num_queued = num_kept;
+        size_type next = 0;
+        probe_queue_.clear();
+        while (model_.feasibility != Feasibility::Infeasible && probe_work_units < work_limit) {
+            for (; num_queued < model_.bound_changes().size(); ++num_queued) {
+                const index_type v = model_.bound_changes()[num_queued].v;
+                for (size_type i = incidence_starts_[v]; i < incidence_starts_[v + 1]; ++i) {
+                    const index_type& c = incidence_[i];
+                    if (cleared_[c] || probe_queued_[c]) continue;
+                    probe_queued_[c] = true;
+                    probe_queue_.emplace_back(c);
+                }
+            }
+            if (next == probe_queue_.size()) break;
+
+            const index_type c = probe_queue_[next++];
+            probe_queued_[c] = false;
+
+            const auto& constraint = model_.constraint_ref(c);
+            probe_work_units += constraint.num_variables() + 1;
+
+            // Soft constraints can be violated, so they don't imply anything
+            if (constraint.is_soft()) continue;
+
+            Activity activity(constraint);
+            if (constraint.sense() != dimod::Sense::GE) {
+                if (activity.total_minimal() > constraint.rhs() + FEASIBILITY_TOLERANCE) {
+                    model_.feasibility = Feasibility::Infeasible;
+                    break;
+                }
+                const size_type num_changes = model_.bound_changes().size();
+                technique_domain_propagation<dimod::Sense::LE>(constraint, activity, tighten);
+                if (model_.bound_changes().size() > num_changes) {
+                    activity = Activity(constraint);
+                }
+            }
+            if (constraint.sense() != dimod::Sense::LE) {
+                if (activity.total_maximal() < constraint.rhs() - FEASIBILITY_TOLERANCE) {
+                    model_.feasibility = Feasibility::Infeasible;
+                    break;
+                }
+                technique_domain_propagation<dimod::Sense::GE>(constraint, activity, tighten);
+            }
+        }
+        for (; next < probe_queue_.size(); ++next) {
+            probe_queued_[probe_queue_[next]] = false;
+        }
+        work_units += probe_work_units;
+
+        const bool infeasible = model_.feasibility == Feasibility::Infeasible;
+        if (!infeasible) {
+            const auto& changes = model_.bound_changes();
+            for (size_type i = num_kept; i < changes.size(); ++i) {
+                if (changes[i].v == x) continue;
+                implied.push_back({changes[i].v, changes[i].upper, changes[i].new_bound});
+            }
+
+            // Keep only the tightest bound of each kind for each variable
+            std::sort(implied.begin(), implied.end(),
+                      [](const implication_type& lhs, const implication_type& rhs) {
+                          if (lhs.v != rhs.v) return lhs.v < rhs.v;
+                          if (lhs.upper != rhs.upper) return lhs.upper < rhs.upper;
+                          return lhs.upper ? lhs.bound < rhs.bound : lhs.bound > rhs.bound;
+                      });
+            implied.erase(std::unique(implied.begin(), implied.end(),
+                                      [](const implication_type& lhs,
+                                         const implication_type& rhs) {
+                                          return lhs.v == rhs.v && lhs.upper == rhs.upper;
+                                      }),
+                          implied.end());
+        }
+
+        model_.undo_bound_changes(num_kept);
+        model_.feasibility = feasibility;
+
+        return infeasible;
+    }
+
+    // Probe both values of the binary variables that are in at least one constraint,
+    // see probe(), in the order given by probing_order, until `time_limit` has passed
+    // since `start` or `work_units` reaches `work_limit`. The time limit is checked
+    // between variables, and each probe is given the work units left of `work_limit`,
+    // so the probes of the last variable can be cut short. If one of the values is
+    // infeasible the variable is fixed to the other, and if both are the model is.
+    // A bound implied by both values holds either way, so it is applied, and the
+    // bounds implied by each value are kept in implications_. Returns whether the
+    // model changed.
+    bool technique_probing(std::chrono::steady_clock::time_point start,
+                           std::chrono::duration<double> time_limit, size_type work_limit,
+                           size_type& work_units) {
+        // bring the activities up to date, probe() expects to start from no changes
+        process_bound_changes();
+
+        implications_.resize(model_.num_variables());
+        probe_queued_.assign(model_.num_constraints(), false);
+
+        auto num_constraints = [this](index_type v) {
+            return incidence_starts_[v + 1] - incidence_starts_[v];
+        };
+
+        std::vector<index_type> candidates;
+        for (size_type v = 0; v < model_.num_variables(); ++v) {
+            if (model_.vartype(v) != dimod::Vartype::BINARY) continue;
+            if (model_.lower_bound(v) == model_.upper_bound(v)) continue;
+            if (!num_constraints(v)) continue;
+            candidates.emplace_back(v);
+        }
+        switch (probing_order) {
+            case ProbingOrder::MostConstrainedFirst:
+                std::stable_sort(candidates.begin(), candidates.end(),
+                                 [&](const index_type& u, const index_type& v) {
+                                     return num_constraints(u) > num_constraints(v);
+                                 });
+                break;
+            case ProbingOrder::IndexOrder:
+                break;
+        }
+
+        // probe() can go over its limit by the last constraint it visits
+        auto remaining_work_units = [&]() {
+            return work_units < work_limit ? work_limit - work_units : 0;
+        };
+
+        bool changes = false;
+        std::vector<implication_type> implied[2];
+        for (const index_type& x : candidates) {
+            if (work_units >= work_limit) break;
+            if (std::chrono::steady_clock::now() - start >= time_limit) break;
+
+            // an earlier probe may have fixed it
+            if (model_.lower_bound(x) == model_.upper_bound(x)) continue;
+
+            ++statistics_.probing.num_calls;
+
+            const bool infeasible[2] = {
+                    probe(x, false, implied[0], work_units, remaining_work_units()),
+                    probe(x, true, implied[1], work_units, remaining_work_units())};
+
+            if (infeasible[0] && infeasible[1]) {
+                model_.feasibility = Feasibility::Infeasible;
+                break;
+            }
+
+            bool x_changes = false;
+            if (infeasible[0] || infeasible[1]) {
+                x_changes = tighten_bound(x, infeasible[1], infeasible[0]);
+            } else {
+                // Both lists are sorted by variable and then by the kind of bound
+                auto it0 = implied[0].cbegin();
+                auto it1 = implied[1].cbegin();
+                while (it0 != implied[0].cend() && it1 != implied[1].cend()) {
+                    if (it0->v != it1->v || it0->upper != it1->upper) {
+                        if (std::make_pair(it0->v, it0->upper) <
+                            std::make_pair(it1->v, it1->upper)) {
+                            ++it0;
+                        } else {
+                            ++it1;
+                        }
+                        continue;
+                    }
+                    const bias_type bound = it0->upper ? std::max(it0->bound, it1->bound)
+                                                       : std::min(it0->bound, it1->bound);
+                    x_changes |= tighten_bound(it0->v, it0->upper, bound);
+                    ++it0;
+                    ++it1;
+                }
+
+                implications_.set(x, false, implied[0]);
+                implications_.set(x, true, implied[1]);
+            }
+
+            if (x_changes) {
+                ++statistics_.probing.num_changes;
+                changes = true;
+
+                // queue the constraints for the next round, and apply the implications
+                // of any variables that were fixed
+                process_bound_changes();
+            }
+        }
+
+        return changes;
+    }
+
+    // Tighten the bounds implied by the value of v, found by technique_probing(), if
+    // v is a binary variable that is fixed.
+    void apply_implications(index_type v) {
+        if (static_cast<size_type>(v) >= implications_.num_variables()) return;
+        if (model_.vartype(v) != dimod::Vartype::BINARY) return;
+        if (model_.lower_bound(v) != model_.upper_bound(v)) return;
+
+        for (const auto& implication : implications_.implications(v, model_.lower_bound(v))) {
+            tighten_bound(implication.v, implication.upper, implication.bound);
+        }
+    }
+
+    // A tightening of a variable's bound found by presolve_round_parallel()
+    struct BoundProposal {
+        index_type v;
+        bool upper;
+        bias_type bound;
+    };
+
+    // Do one round of presolve on the given constraints using num_threads threads.
+    // The constraints are only modified by one thread each, and the bounds are not
+    // modified until all of the constraints have been evaluated.
+    bool presolve_round_parallel(const std::vector<index_type>& round,
+                                 RoundStatistics& round_statistics) {
+        const std::ptrdiff_t num_constraints = round.size();
+
+        for (const index_type& c : round) {
+            queued_[c] = false;
+            round_statistics.work_units += model_.constraint_ref(c).num_variables() + 1;
+        }
+        round_statistics.num_constraints += num_constraints;
+
+        bool changes = false;
+
+        // Each technique is timed as a whole
+        auto now = std::chrono::steady_clock::now();
+
+        if (techniques & TechniqueFlags::RemoveSmallBiases) {
+            std::vector<char> changed(num_constraints, false);
+            size_type num_biases_removed = 0;
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads) reduction(+ : num_biases_removed)
+            for (std::ptrdiff_t i = 0; i < num_constraints; ++i) {
+                auto& constraint = model_.constraint_ref(round[i]);
+                const size_type num_biases = this->num_biases(constraint);
+                if (technique_remove_small_biases(constraint)) {
+                    activities_[round[i]].valid = false;  // the constraint itself changed
+                    changed[i] = true;
+                }
+                num_biases_removed += num_biases - this->num_biases(constraint);
             }
-        } else if (large_activities.size() == 1) {
-            // We can only do domain propagation on the variable with large bias
-            const auto& v = large_activities.back();
 
-            // we already zeroed out the activity associated with v, so this
-            // is just the "activity"
-            const bias_type activity_excluding_v = activity;
+            size_type num_changed = 0;
+            for (std::ptrdiff_t i = 0; i < num_constraints; ++i) {
+                if (changed[i]) {
+                    enqueue(round[i]);
+                    ++num_changed;
+                }
+            }
+            changes |= num_changed;
+
+            round_statistics.num_biases_removed += num_biases_removed;
+            record(round_statistics.remove_small_biases, num_constraints, num_changed, now);
+        }
+
+        if (techniques & TechniqueFlags::DomainPropagation) {
+            std::vector<BoundProposal> proposals;
+            size_type num_proposing = 0;
+
+#pragma omp parallel num_threads(num_threads) reduction(+ : num_proposing)
+            {
+                std::vector<BoundProposal> local_proposals;
+                auto propose = [&local_proposals](index_type v, bool upper, bias_type bound) {
+                    local_proposals.push_back({v, upper, bound});
+                    return true;
+                };
+
+#pragma omp for schedule(dynamic) nowait
+                for (std::ptrdiff_t i = 0; i < num_constraints; ++i) {
+                    const index_type& c = round[i];
+                    const auto& constraint = model_.constraint_ref(c);
+
+                    const Activity& activity = this->activity(c);
+                    const size_type num_proposals = local_proposals.size();
+
+                    if (constraint.sense() == dimod::Sense::LE ||
+                        constraint.sense() == dimod::Sense::EQ) {
+                        technique_domain_propagation<dimod::Sense::LE>(constraint, activity,
+                                                                        propose);
+                    }
+                    if (constraint.sense() == dimod::Sense::GE ||
+                        constraint.sense() == dimod::Sense::EQ) {
+                        technique_domain_propagation<dimod::Sense::GE>(constraint, activity,
+                                                                        propose);
+                    }
+
+                    num_proposing += local_proposals.size() > num_proposals;
+                }
+
+#pragma omp critical
+                proposals.insert(proposals.end(), local_proposals.begin(), local_proposals.end());
+            }
+
+            // Sort so the tightest proposal for each bound comes first. Because we sort
+            // on the bound as well, the order the threads finished in doesn't matter.
+            std::sort(proposals.begin(), proposals.end(),
+                      [](const BoundProposal& lhs, const BoundProposal& rhs) {
+                          if (lhs.v != rhs.v) return lhs.v < rhs.v;
+                          if (lhs.upper != rhs.upper) return lhs.upper < rhs.upper;
+                          return lhs.upper ? lhs.bound < rhs.bound : lhs.bound > rhs.bound;
+                      });
+
+            for (auto it = proposals.begin(); it != proposals.end(); ++it) {
+                if (it != proposals.begin() && (it - 1)->v == it->v &&
+                    (it - 1)->upper == it->upper) {
+                    continue;  // we've already applied a tighter one
+                }
+                changes |= tighten_bound(it->v, it->upper, it->bound);
+            }
 
-            changes |= propagate(v, activity_excluding_v);
-        }  // else large_activities.size() > 1, do nothing. Also we should have already exited early
+            process_bound_changes();
+
+            record(round_statistics.domain_propagation, num_constraints, num_proposing, now);
+        }
+
+        if (techniques & TechniqueFlags::RemoveRedundantConstraints) {
+            // With the activities cached this is cheap enough to do serially
+            size_type num_cleared = 0;
+            for (const index_type& c : round) {
+                if (technique_clear_redundant_constraint(c)) {
+                    mark_cleared(c);
+                    ++num_cleared;
+                }
+            }
+            changes |= num_cleared;
+
+            record(round_statistics.remove_redundant_constraints, num_constraints, num_cleared,
+                   now);
+        }
 
         return changes;
     }
 
+    // Reading the clock after every constraint is a noticeable part of the constraint
+    // loop when the constraints are small. So we only read it every `stride`
+    // constraints, adapting the stride so that the clock is read about every
+    // CLOCK_INTERVAL.
+    class AmortizedClock {
+     public:
+        explicit AmortizedClock(std::chrono::steady_clock::time_point now) : last_read_(now) {}
+
+        // Count a constraint. Returns whether the clock should be read for it.
+        bool tick() { return ++num_ticks_ >= stride_; }
+
+        // The number of constraints since the clock was last read
+        size_type num_ticks() const { return num_ticks_; }
+
+        // Tell the clock it was read, and adapt the stride to the time since the last read
+        void read(std::chrono::steady_clock::time_point now) {
+            const auto elapsed = now - last_read_;
+            if (elapsed < CLOCK_INTERVAL / 2 && stride_ < MAX_STRIDE) {
+                stride_ *= 2;
+            } else if (elapsed > CLOCK_INTERVAL * 2 && stride_ > 1) {
+                stride_ /= 2;
+            }
+            last_read_ = now;
+            num_ticks_ = 0;
+        }
+
+     private:
+        static constexpr std::chrono::duration<double> CLOCK_INTERVAL{1.0e-4};
+        static constexpr size_type MAX_STRIDE = 1 << 12;
+
+        std::chrono::steady_clock::time_point last_read_;
+        size_type stride_ = 1;
+        size_type num_ticks_ = 0;
+    };
+
+    // The number of linear and quadratic biases in an expression
+    static size_type num_biases(const expression_type& expression) {
+        return expression.num_variables() + expression.num_interactions();
+    }
+
+    // Add num_calls and num_changes to a technique's statistics, along with the time
+    // since `since`, which is then advanced to now.
+    static void record(TechniqueStatistics& statistics, size_type num_calls,
+                       size_type num_changes, std::chrono::steady_clock::time_point& since) {
+        const auto now = std::chrono::steady_clock::now();
+        statistics.num_calls += num_calls;
+        statistics.num_changes += num_changes;
+        statistics.time += now - since;
+        since = now;
+    }
+
+    // Build the variable-to-constraint incidence index used by the worklist.
+    void build_incidence() {
+        const size_type num_variables = model_.num_variables();
+
+        // First count the number of constraints each variable appears in, then fill
+        incidence_starts_.assign(num_variables + 1, 0);
+        for (const auto& constraint : model_.constraints()) {
+            for (const auto& v : constraint.variables()) {
+                ++incidence_starts_[v + 1];
+            }
+        }
+        std::partial_sum(incidence_starts_.begin(), incidence_starts_.end(),
+                         incidence_starts_.begin());
+
+        incidence_.resize(incidence_starts_.back());
+        std::vector<size_type> positions(incidence_starts_.begin(), incidence_starts_.end() - 1);
+        for (size_type c = 0; c < model_.num_constraints(); ++c) {
+            for (const auto& v : model_.constraint_ref(c).variables()) {
+                incidence_[positions[v]++] = c;
+            }
+        }
+
+        // Cleared constraints have no variables left, so they are not in it
+        num_cleared_in_incidence_ = 0;
+    }
+
+    // Queue constraint c to be visited by the presolve loop, if it isn't already.
+    // Cleared constraints are never queued again.
+    void enqueue(index_type c) {
+        if (queued_[c] || cleared_[c]) return;
+        queued_[c] = true;
+        worklist_.emplace_back(c);
+    }
+
+    // Record that constraint c was cleared by technique_clear_redundant_constraint().
+    // It stays in the model, so the indices of the others don't change, until the
+    // cleanup at the end of presolve() removes it.
+    void mark_cleared(index_type c) {
+        cleared_[c] = true;
+        activities_[c].valid = false;
+        ++num_cleared_in_incidence_;
+    }
+
+    // Bring the cached activities up to date with the bound changes made since the last
+    // call, and queue every constraint touching a variable whose bounds have changed.
+    // The incidence index is never updated during presolve so it may contain
+    // constraints that no longer contain the variable. That just costs us a visit.
+    // Binary variables that get fixed also tighten the bounds they imply, see
+    // apply_implications(), whose changes are processed in turn.
+    void process_bound_changes() {
+        for (size_type ci = 0; ci < model_.bound_changes().size(); ++ci) {
+            // a copy, because applying the implications adds more changes
+            const auto change = model_.bound_changes()[ci];
+            const index_type& v = change.v;
+            for (size_type i = incidence_starts_[v]; i < incidence_starts_[v + 1]; ++i) {
+                const index_type& c = incidence_[i];
+
+                if (cleared_[c]) continue;
+
+                enqueue(c);
+
+                Activity& activity = activities_[c];
+                if (!activity.valid) continue;
+
+                // The activities of the interactions of v all change, so it's simpler
+                // to recalculate those of quadratic constraints when they're needed
+                if (!activity.linear) {
+                    activity.valid = false;
+                    continue;
+                }
+
+                const bias_type a = model_.constraint_ref(c).linear(v);
+                if (!a) continue;
+
+                // Every so often we recalculate from scratch, to keep the rounding error
+                // from incremental updates in check.
+                if (++activity.num_updates > model_.constraint_ref(c).num_variables()) {
+                    activity.valid = false;
+                    continue;
+                }
+
+                // The lower bound contributes to the minimal activity for positive biases,
+                // and the upper bound for negative ones
+                if ((a > 0) != change.upper) {
+                    activity.update_minimal(a * change.old_bound, a * change.new_bound);
+                } else {
+                    activity.update_maximal(a * change.old_bound, a * change.new_bound);
+                }
+            }
+
+            if (!implications_.empty()) apply_implications(v);
+        }
+        model_.clear_bound_changes();
+    }
+
     ModelView model_;
 
+    // The constraints each variable appears in; those of variable v are
+    // incidence_[incidence_starts_[v]:incidence_starts_[v+1]].
+    std::vector<size_type> incidence_starts_;
+    std::vector<index_type> incidence_;
+
+    // The constraints queued for the next round of presolve.
+    std::vector<index_type> worklist_;
+    std::vector<bool> queued_;
+
+    // The constraints cleared during presolve(), and how many of them are still
+    // in the incidence index. The index is rebuilt without them once they are more
+    // than 1 / CLEARED_FRACTION_TO_REBUILD_INCIDENCE of the constraints.
+    std::vector<bool> cleared_;
+    size_type num_cleared_in_incidence_ = 0;
+    static constexpr size_type CLEARED_FRACTION_TO_REBUILD_INCIDENCE = 4;
+
+    // The cached activity of each constraint
+    std::vector<Activity> activities_;
+
+    // The bounds implied by each value of the binary variables, see technique_probing()
+    implication_table_type implications_;
+
+    // The constraints queued by probe(), and whether each constraint is queued
+    std::vector<index_type> probe_queue_;
+    std::vector<bool> probe_queued_;
+
     bool detached_ = false;
     bool normalized_ = false;
+
+    PresolveStatistics statistics_;
 };
 }  // namespace presolve
 }  // namespace dwave
@@ -0,0 +1,189 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#include "dwave/restorer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace dwave::presolve {
+
+namespace {
+
+constexpr char MAGIC[8] = {'D', 'W', 'R', 'S', 'T', 'O', 'R', 'E'};
+constexpr std::uint32_t BYTE_ORDER_MARKER = 0x01020304;
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t num_original;
+    std::uint64_t num_reduced;
+    std::uint64_t num_gather;
+};
+
+static_assert(sizeof(Header) == 40, "unexpected header padding");
+static_assert(sizeof(double) == 8, "the serialization assumes 64-bit doubles");
+
+// Every array element is 8 bytes so the arrays stay aligned after the header
+constexpr std::size_t WORD = 8;
+
+}  // namespace
+
+Restorer::Restorer() : Restorer(serialize(0, {}, {}, {}, {})) {}
+
+Restorer::Restorer(std::string data) : owned_(std::make_shared<const std::string>(std::move(data))) {
+    load(owned_->data(), owned_->size());
+}
+
+Restorer::Restorer(const char* data, size_type size) { load(data, size); }
+
+Restorer Restorer::view(const void* data, size_type size) {
+    return Restorer(static_cast<const char*>(data), size);
+}
+
+std::string Restorer::serialize(size_type num_reduced, const std::vector<double>& fill,
+                                const std::vector<std::int64_t>& gather_original,
+                                const std::vector<std::int64_t>& gather_reduced,
+                                const std::vector<double>& multiplier) {
+    const size_type num_gather = gather_original.size();
+    if (gather_reduced.size() != num_gather || multiplier.size() != num_gather) {
+        throw std::invalid_argument("gather arrays must all be the same length");
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARKER;
+    header.num_original = fill.size();
+    header.num_reduced = num_reduced;
+    header.num_gather = num_gather;
+
+    std::string data;
+    data.reserve(sizeof(Header) + WORD * (fill.size() + 3 * num_gather));
+    data.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+    data.append(reinterpret_cast<const char*>(fill.data()), WORD * fill.size());
+    data.append(reinterpret_cast<const char*>(gather_original.data()), WORD * num_gather);
+    data.append(reinterpret_cast<const char*>(gather_reduced.data()), WORD * num_gather);
+    data.append(reinterpret_cast<const char*>(multiplier.data()), WORD * num_gather);
+
+    // make sure that we only ever write things we can read back
+    Restorer(data.data(), data.size());
+
+    return data;
+}
+
+std::string Restorer::serialize() const { return std::string(data_, size_); }
+
+Restorer::size_type Restorer::num_original_variables() const { return num_original_; }
+
+Restorer::size_type Restorer::num_reduced_variables() const { return num_reduced_; }
+
+std::vector<double> Restorer::restore(const std::vector<double>& reduced) const {
+    if (reduced.size() != num_reduced_) {
+        throw std::invalid_argument("reduced sample has the wrong number of variables");
+    }
+
+    std::vector<double> original(fill_, fill_ + num_original_);
+    for (size_type k = 0; k < num_gather_; ++k) {
+        original[gather_original_[k]] += multiplier_[k] * reduced[gather_reduced_[k]];
+    }
+    return original;
+}
+
+template <class T>
+void Restorer::restore_batch(const T* reduced, size_type num_samples, double* original) const {
+#pragma omp parallel for
+    for (std::ptrdiff_t si = 0; si < static_cast<std::ptrdiff_t>(num_samples); ++si) {
+        const T* in = reduced + si * num_reduced_;
+        double* out = original + si * num_original_;
+
+        std::copy(fill_, fill_ + num_original_, out);
+        for (size_type k = 0; k < num_gather_; ++k) {
+            out[gather_original_[k]] += multiplier_[k] * in[gather_reduced_[k]];
+        }
+    }
+}
+
+void Restorer::load(const char* data, size_type size) {
+    if (size < sizeof(Header)) {
+        throw std::invalid_argument("serialized restorer is truncated");
+    }
+    if (reinterpret_cast<std::uintptr_t>(data) % WORD) {
+        throw std::invalid_argument("serialized restorer must be 8-byte aligned");
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC))) {
+        throw std::invalid_argument("not a serialized restorer");
+    }
+    if (header.byte_order != BYTE_ORDER_MARKER) {
+        throw std::invalid_argument("serialized restorer has a different byte order");
+    }
+    if (header.version != VERSION) {
+        throw std::invalid_argument("unsupported serialized restorer version " +
+                                    std::to_string(header.version));
+    }
+
+    // check the sizes without overflowing
+    const std::uint64_t num_words = (size - sizeof(Header)) / WORD;
+    if ((size - sizeof(Header)) % WORD || header.num_original > num_words ||
+        header.num_gather > (num_words - header.num_original) / 3 ||
+        header.num_original + 3 * header.num_gather != num_words) {
+        throw std::invalid_argument("serialized restorer has the wrong size");
+    }
+
+    const char* ptr = data + sizeof(Header);
+    const double* fill = reinterpret_cast<const double*>(ptr);
+    ptr += WORD * header.num_original;
+    const std::int64_t* gather_original = reinterpret_cast<const std::int64_t*>(ptr);
+    ptr += WORD * header.num_gather;
+    const std::int64_t* gather_reduced = reinterpret_cast<const std::int64_t*>(ptr);
+    ptr += WORD * header.num_gather;
+    const double* multiplier = reinterpret_cast<const double*>(ptr);
+
+    // a bad index would have us read or write out of bounds later
+    for (std::uint64_t k = 0; k < header.num_gather; ++k) {
+        if (gather_original[k] < 0 ||
+            static_cast<std::uint64_t>(gather_original[k]) >= header.num_original ||
+            gather_reduced[k] < 0 ||
+            static_cast<std::uint64_t>(gather_reduced[k]) >= header.num_reduced) {
+            throw std::invalid_argument("serialized restorer has an out-of-range index");
+        }
+    }
+
+    data_ = data;
+    size_ = size;
+    num_original_ = header.num_original;
+    num_reduced_ = header.num_reduced;
+    num_gather_ = header.num_gather;
+    fill_ = fill;
+    gather_original_ = gather_original;
+    gather_reduced_ = gather_reduced;
+    multiplier_ = multiplier;
+}
+
+// The sample types that dimod uses, see Presolver::restore_batch()
+template void Restorer::restore_batch(const float*, size_type, double*) const;
+template void Restorer::restore_batch(const double*, size_type, double*) const;
+template void Restorer::restore_batch(const signed char*, size_type, double*) const;
+template void Restorer::restore_batch(const short*, size_type, double*) const;
+template void Restorer::restore_batch(const int*, size_type, double*) const;
+template void Restorer::restore_batch(const long*, size_type, double*) const;
+template void Restorer::restore_batch(const long long*, size_type, double*) const;
+
+}  // namespace dwave::presolve
@@ -13,6 +13,7 @@
 # limitations under the License.
 
 import os
+import tempfile
 
 from setuptools import setup
 from setuptools.extension import Extension
@@ -33,18 +34,73 @@ extra_link_args = {
     'unix': ['-std=c++17'],
 }
 
+# Used when the compiler supports OpenMP, otherwise the extensions are serial.
+# MSVC's plain /openmp is OpenMP 2.0, which lacks the atomic read and capture
+# constructs the extensions use, so its LLVM runtime is needed.
+openmp_compile_args = {
+    'msvc': ['/openmp:llvm'],
+    'unix': ['-fopenmp'],
+}
+
+openmp_link_args = {
+    'msvc': [],
+    'unix': ['-fopenmp'],
+}
+
+
+# Uses the OpenMP constructs the extensions need, not just the runtime
+openmp_test_program = """\
+#include <omp.h>
+
+int main() {
+    int count = 0;
+    int last = 0;
+#pragma omp parallel for
+    for (int i = 0; i < 8; ++i) {
+        int seen;
+#pragma omp atomic read
+        seen = count;
+#pragma omp atomic capture
+        last = count++;
+        (void)seen;
+    }
+    return omp_get_max_threads() < 1 || count != 8 || last < 0;
+}
+"""
+
+
+def has_openmp(compiler, compile_args, link_args):
+    """Test whether the compiler can build and link a program using OpenMP."""
+    with tempfile.TemporaryDirectory() as tmpdir:
+        source = os.path.join(tmpdir, 'openmp.cpp')
+        with open(source, 'w') as f:
+            f.write(openmp_test_program)
+
+        try:
+            objects = compiler.compile([source], output_dir=tmpdir,
+                                       extra_postargs=compile_args)
+            compiler.link_executable(objects, 'openmp', output_dir=tmpdir,
+                                     extra_postargs=link_args)
+        except Exception:  # CompileError or LinkError, depending on the setuptools version
+            return False
+
+    return True
+
 
 class build_ext(_build_ext):
     def build_extensions(self):
         compiler = self.compiler.compiler_type
 
-        compile_args = extra_compile_args[compiler]
-        for ext in self.extensions:
-            ext.extra_compile_args.extend(compile_args)
+        compile_args = list(extra_compile_args[compiler])
+        link_args = list(extra_link_args[compiler])
+
+        if has_openmp(self.compiler, openmp_compile_args[compiler], openmp_link_args[compiler]):
+            compile_args.extend(openmp_compile_args[compiler])
+            link_args.extend(openmp_link_args[compiler])
 
-        link_args = extra_link_args[compiler]
         for ext in self.extensions:
-            ext.extra_compile_args.extend(link_args)
+            ext.extra_compile_args.extend(compile_args)
+            ext.extra_link_args.extend(link_args)
 
         super().build_extensions()
 
@@ -53,7 +109,9 @@ setup(
     name='dwave-preprocessing',
     cmdclass=dict(build_ext=build_ext),
     ext_modules=cythonize(
-        ['dwave/preprocessing/cyfix_variables.pyx',
+        ['dwave/preprocessing/cybias_statistics.pyx',
+         'dwave/preprocessing/cyfix_variables.pyx',
+         'dwave/preprocessing/cyspin_reversal_transform.pyx',
          'dwave/preprocessing/presolve/*.pyx',
          ],
         annotate=True,
@@ -102,3 +102,17 @@ class TestClipCompositeClass(unittest.TestCase):
 
         sampleset = ClipComposite(MySampler).sample(bqm)
         self.assertEqual(sampleset.info, {'a': 1})
+
+    def test_one_sided(self):
+        bqm = BinaryQuadraticModel({'a': -4, 'b': 2}, {'ab': 3, 'bc': -5}, 1.5, dimod.SPIN)
+
+        sampler = ClipComposite(dimod.TrackingComposite(ExactSolver()))
+        sampler.sample(bqm, lower_bound=-2)
+        self.assertEqual(sampler.child.input['bqm'],
+                         BinaryQuadraticModel({'a': -2, 'b': 2}, {'ab': 3, 'bc': -2},
+                                              1.5, dimod.SPIN))
+
+        sampler.sample(bqm, upper_bound=2.5)
+        self.assertEqual(sampler.child.input['bqm'],
+                         BinaryQuadraticModel({'a': -4, 'b': 2}, {'ab': 2.5, 'bc': -5},
+                                              1.5, dimod.SPIN))
@@ -22,6 +22,7 @@ from dimod import SampleSet
 
 from dwave.preprocessing.composites import (ConnectedComponentsComposite, 
                                             FixVariablesComposite)
+from dwave.preprocessing.cyfix_variables import connected_components_wrapper
 
 
 @dtest.load_sampler_bqm_tests(ConnectedComponentsComposite(ExactSolver()))
@@ -81,3 +82,42 @@ class TestConnectedComponentsComposite(unittest.TestCase):
         self.assertIsInstance(response, SampleSet)
         self.assertEqual(response.first.sample, {0: 0, 1: 0, 2: 1, 3: 0})
         self.assertAlmostEqual(response.first.energy, bqm.energy({0: 0, 1: 0, 2: 1, 3: 0}))
+
+    def test_sample_labelled(self):
+        bqm = BinaryQuadraticModel({'a': 1.0, 'b': -1.0, 'c': 2.0, 'd': -3.0},
+                                   {('a', 'b'): -2.0, ('c', 'd'): 1.0}, 1.5, Vartype.SPIN)
+
+        sampler = ConnectedComponentsComposite(ExactSolver())
+        response = sampler.sample(bqm)
+        ground = ExactSolver().sample(bqm).first
+        self.assertEqual(response.first.sample, ground.sample)
+        self.assertAlmostEqual(response.first.energy, ground.energy)
+
+
+class TestConnectedComponentsWrapper(unittest.TestCase):
+    def test_components(self):
+        bqm = BinaryQuadraticModel({'a': 1.0, 'b': -1.0, 'c': 2.0, 'd': -3.0, 'e': 0.5},
+                                   {('a', 'd'): -2.0, ('b', 'c'): 1.0, ('d', 'e'): 4.0},
+                                   1.5, Vartype.SPIN)
+
+        for num_threads in [1, 4]:
+            with self.subTest(num_threads=num_threads):
+                components = connected_components_wrapper(bqm, num_threads=num_threads)
+                self.assertEqual([list(c.variables) for c in components],
+                                 [['a', 'd', 'e'], ['b', 'c']])
+                for component in components:
+                    self.assertIs(component.vartype, Vartype.SPIN)
+                    self.assertEqual(component.offset, 0)
+                    for v in component.variables:
+                        self.assertEqual(component.get_linear(v), bqm.get_linear(v))
+                    for u, v, bias in component.iter_quadratic():
+                        self.assertEqual(bias, bqm.get_quadratic(u, v))
+                self.assertEqual(sum(c.num_interactions for c in components),
+                                 bqm.num_interactions)
+
+    def test_empty(self):
+        self.assertEqual(connected_components_wrapper(BinaryQuadraticModel('BINARY')), [])
+
+    def test_num_threads(self):
+        with self.assertRaises(ValueError):
+            connected_components_wrapper(BinaryQuadraticModel('BINARY'), num_threads=0)
@@ -20,7 +20,7 @@ import unittest
 import dimod
 import numpy as np
 
-from dwave.preprocessing import Presolver, Feasibility, InvalidModelError, TechniqueFlags
+from dwave.preprocessing import Presolver, Feasibility, InvalidModelError, ProbingOrder, Restorer, TechniqueFlags
 
 try:
     NUM_CPUS = len(os.sched_getaffinity(0))
@@ -281,6 +281,53 @@ class TestPresolve(unittest.TestCase):
         presolver.normalize()
         presolver.presolve()
 
+    def test_num_threads(self):
+        cqm = dimod.ConstrainedQuadraticModel()
+        cqm.add_variables("INTEGER", 10)
+        for i in range(9):
+            cqm.add_constraint([(i, 1), (i + 1, -1)], "<=", 0)
+        cqm.add_constraint([(9, 1)], "<=", 5)
+
+        serial = Presolver(cqm)
+        serial.apply()
+
+        parallel = Presolver(cqm)
+        self.assertEqual(parallel.num_threads(), 1)
+        self.assertEqual(parallel.set_num_threads(4), 4)
+        parallel.apply()
+
+        self.assertTrue(serial.copy_model().is_equal(parallel.copy_model()))
+
+    def test_statistics(self):
+        cqm = dimod.ConstrainedQuadraticModel()
+        i, j = dimod.Integers("ij")
+        cqm.set_objective(i + 1e-12 * j)
+        cqm.add_constraint(i + j <= 5)
+        cqm.add_constraint(i >= 5)
+
+        presolver = Presolver(cqm)
+        self.assertEqual(presolver.statistics()["rounds"], [])
+
+        presolver.apply()
+
+        stats = presolver.statistics()
+        self.assertGreaterEqual(len(stats["rounds"]), 1)
+        self.assertEqual(stats["num_variables_fixed"], 2)
+        self.assertEqual(stats["num_constraints_removed"], 2)
+        self.assertGreaterEqual(stats["time"], stats["total"]["time"])
+
+        total = stats["total"]
+        self.assertEqual(total["num_biases_removed"], 1)
+        self.assertGreater(total["num_bounds_tightened"], 0)
+
+        redundant = total["techniques"][TechniqueFlags.RemoveRedundantConstraints]
+        self.assertEqual(redundant["num_changes"], 2)
+        self.assertGreaterEqual(redundant["num_calls"], 2)
+        self.assertGreaterEqual(redundant["time"], 0)
+
+        with self.assertRaises(ValueError):
+            parallel.set_num_threads(0)
+
     def test_time_limit(self):
         # Given a presolveable CQM
         cqm = dimod.CQM()
@@ -298,6 +345,26 @@ class TestPresolve(unittest.TestCase):
         self.assertFalse(presolver.presolve(time_limit_s=0))  # 0 time_limit does nothing
         self.assertTrue(presolver.presolve(time_limit_s=100))  # finally it can do work
 
+    def test_work_limit(self):
+        cqm = dimod.CQM()
+        i, j = dimod.Integers('ij')
+        cqm.add_variables('INTEGER', 'ij')
+        cqm.add_constraint(i <= 5)
+        cqm.add_constraint(i >= -5)
+        cqm.add_constraint(j == 105)
+
+        presolver = Presolver(cqm)
+        presolver.normalize()
+
+        with self.assertRaises(ValueError):
+            presolver.presolve(work_limit=-1)
+
+        self.assertFalse(presolver.presolve(work_limit=0))  # 0 work_limit does nothing
+        self.assertEqual(presolver.statistics()["total"]["work_units"], 0)
+
+        self.assertTrue(presolver.presolve(work_limit=1000))  # finally it can do work
+        self.assertGreater(presolver.statistics()["total"]["work_units"], 0)
+
 
 class TestTechniques(unittest.TestCase):
     def test_add_techniques(self):
@@ -343,6 +410,100 @@ class TestTechniques(unittest.TestCase):
         self.assertEqual(cqm.upper_bound(i), 10)
         self.assertEqual(cqm.num_constraints(), 0)
 
+    def test_remove_parallel_constraints(self):
+        cqm = dimod.ConstrainedQuadraticModel()
+        i, j = dimod.Integers("ij")
+        cqm.add_constraint(i + 2*j <= 10, label="c0")
+        cqm.add_constraint(2*i + 4*j <= 12, label="c1")
+
+        presolver = Presolver(cqm)
+        presolver.set_techniques(TechniqueFlags.RemoveParallelConstraints)
+        self.assertTrue(presolver.apply())
+
+        reduced = presolver.copy_model()
+        self.assertEqual(reduced.num_constraints(), 1)
+        self.assertEqual(presolver.statistics()["remove_parallel_constraints"]["num_changes"], 1)
+
+    def test_roof_duality(self):
+        cqm = dimod.ConstrainedQuadraticModel()
+        a, b, c = dimod.Binaries("abc")
+        cqm.set_objective(-a + b + .5 * a * b - c)
+        cqm.add_constraint(c <= 0, label="c")
+
+        presolver = Presolver(cqm)
+        presolver.set_techniques(TechniqueFlags.RoofDuality)
+        self.assertTrue(presolver.apply())
+
+        # a and b are fixed, c is in a constraint so it is left alone
+        reduced = presolver.copy_model()
+        self.assertEqual(reduced.variables, ["c"])
+        self.assertEqual(presolver.statistics()["roof_duality"]["num_changes"], 1)
+
+        original = presolver.restore_samples([[0]])[0]
+        np.testing.assert_array_equal(original, [[1, 0, 0]])
+
+        self.assertNotIn(TechniqueFlags.RoofDuality, TechniqueFlags.Default)
+
+    def test_probing(self):
+        # a == 0 forces b == c == 1, which breaks the last constraint, but none of
+        # the constraints shows that on its own
+        cqm = dimod.ConstrainedQuadraticModel()
+        a, b, c = dimod.Binaries("abc")
+        cqm.add_constraint(a + b >= 1)
+        cqm.add_constraint(a + c >= 1)
+        cqm.add_constraint(b + c <= 1)
+
+        presolver = Presolver(cqm)
+        presolver.apply()
+        self.assertEqual(presolver.copy_model().num_variables(), 3)
+        self.assertEqual(presolver.statistics()["probing"]["num_calls"], 0)
+
+        presolver = Presolver(cqm)
+        presolver.add_techniques(TechniqueFlags.Probing)
+        self.assertTrue(presolver.apply())
+
+        reduced = presolver.copy_model()
+        self.assertEqual(reduced.num_variables(), 2)
+        self.assertEqual(reduced.num_constraints(), 1)
+
+        stats = presolver.statistics()
+        self.assertEqual(stats["probing"]["num_calls"], 3)
+        self.assertEqual(stats["probing"]["num_changes"], 1)
+        self.assertEqual(stats["num_implications"], 2)
+
+        original = presolver.restore_samples([[0, 1]])[0]
+        np.testing.assert_array_equal(original, [[1, 0, 1]])
+
+        self.assertNotIn(TechniqueFlags.Probing, TechniqueFlags.Default)
+
+    def test_probing_budget(self):
+        cqm = dimod.ConstrainedQuadraticModel()
+        x = dimod.Binaries(range(4))
+        for v in range(3):
+            cqm.add_constraint(x[v] + x[3] <= 1)
+
+        presolver = Presolver(cqm)
+        presolver.add_techniques(TechniqueFlags.Probing)
+        self.assertEqual(presolver.probing_order(), ProbingOrder.MostConstrainedFirst)
+        self.assertEqual(presolver.set_probing_order(ProbingOrder.IndexOrder),
+                         ProbingOrder.IndexOrder)
+        self.assertEqual(presolver.set_probing_limits(work_limit=0), (float("inf"), 0))
+
+        presolver.apply()
+        self.assertEqual(presolver.statistics()["probing"]["num_calls"], 0)
+
+        presolver = Presolver(cqm)
+        presolver.add_techniques(TechniqueFlags.Probing)
+        presolver.set_probing_limits(time_limit_s=10)
+        self.assertEqual(presolver.probing_limits()[0], 10)
+
+        presolver.apply()
+        self.assertEqual(presolver.statistics()["probing"]["num_calls"], 4)
+        self.assertEqual(presolver.statistics()["num_implications"], 6)
+
+        with self.assertRaises(ValueError):
+            presolver.set_probing_limits(work_limit=-1)
+
     def test_load_default_techniques(self):
         presolver = Presolver(dimod.CQM())
 
@@ -544,6 +705,51 @@ class TestPresolver(unittest.TestCase):
             presolver.apply()
             self.assertIs(presolver.feasibility(), Feasibility.Infeasible)
 
+    def test_restore_samples(self):
+        a, b = dimod.Spins("ab")
+        i = dimod.Integer("i")
+        cqm = dimod.ConstrainedQuadraticModel()
+        cqm.set_objective(a + b + i)
+        cqm.add_constraint(i == 3)
+
+        presolver = Presolver(cqm)
+        presolver.apply()
+
+        self.assertEqual(presolver.copy_model().num_variables(), 2)
+
+        samples = np.array([[0, 0], [0, 1], [1, 0], [1, 1]], dtype=np.int8)
+        samplearray, labels = presolver.restore_samples(samples)
+
+        np.testing.assert_array_equal(
+            samplearray, [[-1, -1, 3], [-1, 1, 3], [1, -1, 3], [1, 1, 3]])
+        self.assertEqual(labels, 'abi')
+
+        presolver.set_num_threads(2)
+        for dtype in [np.uint8, np.int16, np.int32, np.int64, np.float32, np.double]:
+            with self.subTest(dtype=dtype):
+                samplearray, _ = presolver.restore_samples(samples.astype(dtype))
+                np.testing.assert_array_equal(
+                    samplearray, [[-1, -1, 3], [-1, 1, 3], [1, -1, 3], [1, 1, 3]])
+
+    def test_serialize_restore(self):
+        a, b = dimod.Spins("ab")
+        i = dimod.Integer("i")
+        cqm = dimod.ConstrainedQuadraticModel()
+        cqm.set_objective(a + b + i)
+        cqm.add_constraint(i == 3)
+
+        presolver = Presolver(cqm)
+        presolver.apply()
+
+        restorer = Restorer(presolver.serialize_restore(), cqm.variables)
+        self.assertEqual(restorer.num_reduced_variables(), 2)
+
+        samples = np.array([[0, 0], [0, 1], [1, 0], [1, 1]], dtype=np.int8)
+        samplearray, labels = restorer.restore_samples(samples)
+
+        np.testing.assert_array_equal(samplearray, presolver.restore_samples(samples)[0])
+        self.assertEqual(labels, 'abi')
+
     def test_self_loop(self):
         i = dimod.Integer("i")
         cqm = dimod.ConstrainedQuadraticModel()
@@ -630,3 +836,62 @@ class TestPresolver(unittest.TestCase):
         self.assertEqual(updated_cqm.upper_bound(6), 0.5**31)
         self.assertEqual(updated_cqm.lower_bound(7), 0)
         self.assertEqual(updated_cqm.upper_bound(7), 0.5**30)
+
+
+class TestRestorer(unittest.TestCase):
+    def test_empty(self):
+        presolver = Presolver(dimod.ConstrainedQuadraticModel())
+        presolver.apply()
+
+        restorer = Restorer(presolver.serialize_restore())
+        samples, labels = restorer.restore_samples([[], []])
+        self.assertEqual(samples.shape, (2, 0))
+        self.assertEqual(labels, [])
+
+    def test_invalid(self):
+        with self.assertRaises(ValueError):
+            Restorer(b"")
+        with self.assertRaises(ValueError):
+            Restorer(b"a" * 64)
+
+    def test_mmap(self):
+        import mmap
+        import tempfile
+
+        cqm = dimod.ConstrainedQuadraticModel()
+        i = dimod.Integer('i', lower_bound=-5, upper_bound=5)
+        j = dimod.Integer('j', lower_bound=5, upper_bound=10)
+        cqm.set_objective(i + j)
+        cqm.add_constraint(j <= 5)
+
+        presolver = Presolver(cqm)
+        presolver.apply()
+
+        with tempfile.TemporaryFile() as f:
+            f.write(presolver.serialize_restore())
+            f.flush()
+            with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mm:
+                restorer = Restorer(mm, 'ij')
+                samples, labels = restorer.restore_samples([[-5], [3]])
+                np.testing.assert_array_equal(samples, [[-5, 5], [3, 5]])
+                self.assertEqual(labels, 'ij')
+                del restorer
+
+    def test_serialize(self):
+        a, b = dimod.Spins("ab")
+        cqm = dimod.ConstrainedQuadraticModel()
+        cqm.set_objective(a * b)
+
+        presolver = Presolver(cqm)
+        presolver.apply()
+
+        restorer = Restorer(presolver.serialize_restore())
+        other = Restorer(restorer.serialize())
+        np.testing.assert_array_equal(other.restore_samples([[0, 1]])[0], [[-1, 1]])
+
+    def test_wrong_variables(self):
+        presolver = Presolver(dimod.ConstrainedQuadraticModel())
+        presolver.apply()
+
+        with self.assertRaises(ValueError):
+            Restorer(presolver.serialize_restore(), 'abc')
@@ -16,7 +16,7 @@ import unittest
 
 import dimod
 
-from dwave.preprocessing.lower_bounds import roof_duality
+from dwave.preprocessing.lower_bounds import roof_duality, roof_duality_batch
 
 class TestRoofDuality(unittest.TestCase):
     def test_empty(self):
@@ -54,3 +54,32 @@ class TestRoofDuality(unittest.TestCase):
         lb, fixed = roof_duality(bqm)
         self.assertEqual(fixed, {'a': -1, 'b': -1, 'c': 1})
         self.assertEqual(lb, -12.0)
+
+
+class TestRoofDualityBatch(unittest.TestCase):
+    def test_empty(self):
+        self.assertEqual(roof_duality_batch([]), [])
+
+    def test_same_as_roof_duality(self):
+        bqms = [
+            dimod.BinaryQuadraticModel('BINARY'),
+            dimod.BinaryQuadraticModel(3, 'BINARY'),
+            dimod.BinaryQuadraticModel.from_ising({'a': 10}, {'ab': -1, 'bc': 1}),
+            dimod.DictBQM.from_ising({'a': 10}, {'ab': -1, 'bc': 1}),
+            dimod.generators.gnp_random_bqm(20, .3, 'BINARY', random_state=5),
+            dimod.generators.gnp_random_bqm(30, .2, 'SPIN', random_state=6),
+            ]
+        bqms[4].offset = 3.5
+
+        for strict in [True, False]:
+            for num_threads in [1, 4]:
+                with self.subTest(strict=strict, num_threads=num_threads):
+                    results = roof_duality_batch(bqms, strict=strict,
+                                                 num_threads=num_threads)
+                    self.assertEqual(
+                        results, [roof_duality(bqm, strict=strict) for bqm in bqms])
+
+    def test_invalid_num_threads(self):
+        bqm = dimod.BinaryQuadraticModel.from_ising({'a': 10}, {})
+        with self.assertRaises(ValueError):
+            roof_duality_batch([bqm], num_threads=0)
@@ -117,3 +117,24 @@ class TestScaleComposite(unittest.TestCase):
         self.assertEqual(sampler.child.input['bqm'],
                          dimod.BQM.from_ising({'a': -2.0, 'b': -2.0},
                                               {('a', 'b'): 1.6}, .75))
+
+    def test_normalize_matches_dimod(self):
+        bqm = dimod.generators.gnp_random_bqm(10, .5, 'SPIN', random_state=7)
+        bqm.offset = 1.5
+
+        for kwargs in [dict(), dict(bias_range=2), dict(bias_range=[-1, 3]),
+                       dict(bias_range=1, quadratic_range=[-2, 1]),
+                       dict(ignore_offset=True)]:
+            with self.subTest(**kwargs):
+                sampler = ScaleComposite(dimod.TrackingComposite(dimod.ExactSolver()))
+                sampleset = sampler.sample(bqm, **kwargs)
+                dtest.assert_sampleset_energies(sampleset, bqm)
+
+                expected = bqm.copy()
+                scalar = expected.normalize(**kwargs)
+                self.assertAlmostEqual(sampleset.info['scalar'], scalar)
+                self.assertEqual(sampler.child.input['bqm'].offset, expected.offset)
+                for v, bias in expected.linear.items():
+                    self.assertAlmostEqual(sampler.child.input['bqm'].get_linear(v), bias)
+                for u, v, bias in expected.iter_quadratic():
+                    self.assertAlmostEqual(sampler.child.input['bqm'].get_quadratic(u, v), bias)
@@ -18,6 +18,8 @@ import dimod
 import numpy as np
 
 from dwave.preprocessing.composites import SpinReversalTransformComposite
+from dwave.preprocessing.cyspin_reversal_transform import (
+    spin_reversal_transform_batch_wrapper, spin_reversal_unflip_batch_wrapper)
 
 
 @dimod.testing.load_sampler_bqm_tests(SpinReversalTransformComposite(dimod.ExactSolver()))
@@ -143,3 +145,54 @@ class TestSpinTransformComposite(unittest.TestCase):
 
         self.assertTrue((ss1.record == ss2.record).all())
         self.assertFalse((ss1.record == ss3.record).all())
+
+    def test_binary(self):
+        bqm = dimod.BQM({'a': 1, 'b': -2, 'c': .5}, {'ab': 3, 'bc': -1}, 1.5, 'BINARY')
+
+        sampler = SpinReversalTransformComposite(dimod.ExactSolver(), seed=5)
+        sampleset = sampler.sample(bqm, num_spin_reversal_transforms=4)
+
+        self.assertEqual(len(sampleset), 4 * 2**3)
+        np.testing.assert_array_almost_equal(sampleset.record.energy,
+                                             bqm.energies(sampleset))
+
+
+class TestSpinReversalTransformBatch(unittest.TestCase):
+    def test_energies(self):
+        rng = np.random.default_rng(42)
+        for vartype in [dimod.SPIN, dimod.BINARY]:
+            with self.subTest(vartype=vartype):
+                bqm = dimod.generators.gnp_random_bqm(8, .5, vartype, random_state=3)
+                bqm.relabel_variables({v: 'abcdefgh'[v] for v in bqm.variables})
+                flips = rng.random((5, bqm.num_variables)) > .5
+
+                transformed = spin_reversal_transform_batch_wrapper(bqm, flips, num_threads=2)
+                self.assertEqual(len(transformed), 5)
+
+                samples = dimod.ExactSolver().sample(bqm)
+                for t, tbqm in enumerate(transformed):
+                    self.assertEqual(tbqm.variables, bqm.variables)
+                    self.assertEqual(tbqm.num_interactions, bqm.num_interactions)
+
+                    flipped = samples.record.sample.copy()
+                    if vartype is dimod.SPIN:
+                        flipped[:, flips[t]] *= -1
+                    else:
+                        flipped[:, flips[t]] = 1 - flipped[:, flips[t]]
+                    np.testing.assert_array_almost_equal(
+                        tbqm.energies((flipped, samples.variables)),
+                        bqm.energies(samples))
+
+                    # and back
+                    num_samples = [0] * 5
+                    num_samples[t] = len(flipped)
+                    unflipped = np.ascontiguousarray(flipped, dtype=np.int8)
+                    spin_reversal_unflip_batch_wrapper(unflipped, num_samples, flips, vartype)
+                    np.testing.assert_array_equal(unflipped, samples.record.sample)
+
+    def test_invalid(self):
+        bqm = dimod.BQM({'a': 1}, {}, 0, 'SPIN')
+        with self.assertRaises(ValueError):
+            spin_reversal_transform_batch_wrapper(bqm, [[True, False]])
+        with self.assertRaises(ValueError):
+            spin_reversal_transform_batch_wrapper(bqm, [[True]], num_threads=0)
@@ -0,0 +1,253 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+// Benchmarks for roof duality and presolve. Each run generates one instance, see
+// generators.hpp, times the phases of fixing its variables or of presolving it
+// and prints one line of JSON, so that the output of two releases can be diffed
+// or loaded line by line. The times are the fastest of the repeats, in seconds.
+//
+//     bench.out --generator NAME --size NUM_VARIABLES [--seed SEED] [--repeat REPEAT]
+//               [--threads NUM_THREADS] [--strict] [--probing]
+//
+// The peak memory is that of the whole process, so each instance should be run
+// in a process of its own, as `make bench` does.
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dwave-preprocessing/fix_variables.hpp"
+#include "dwave/presolve.hpp"
+#include "generators.hpp"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using seconds = std::chrono::duration<double>;
+
+struct Options {
+    std::string generator;
+    int size = 0;
+    std::uint64_t seed = 42;
+    int repeat = 3;
+    int num_threads = 1;
+    bool strict = false;
+    bool probing = false;  // add TechniqueFlags::Probing to the presolve techniques
+};
+
+// The fastest time of each phase over the repeats, in the order they ran.
+class Timings {
+ public:
+    void record(const std::string& phase, seconds time) {
+        auto it = std::find_if(phases_.begin(), phases_.end(),
+                               [&](const auto& p) { return p.first == phase; });
+        if (it == phases_.end()) {
+            phases_.emplace_back(phase, time.count());
+        } else {
+            it->second = std::min(it->second, time.count());
+        }
+    }
+
+    const std::vector<std::pair<std::string, double>>& phases() const { return phases_; }
+
+ private:
+    std::vector<std::pair<std::string, double>> phases_;
+};
+
+// The peak resident set size of the process, in KiB.
+long peak_memory_kib() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+void print_json(const Options& options, const std::string& benchmark,
+                const std::map<std::string, double>& counts, const Timings& timings) {
+    std::cout << "{\"benchmark\": \"" << benchmark << "\", \"generator\": \""
+              << options.generator << "\", \"size\": " << options.size
+              << ", \"seed\": " << options.seed << ", \"repeat\": " << options.repeat
+              << ", \"threads\": " << options.num_threads;
+    for (const auto& [name, value] : counts) {
+        std::cout << ", \"" << name << "\": " << value;
+    }
+    std::cout << ", \"seconds\": {";
+    const char* separator = "";
+    for (const auto& [phase, time] : timings.phases()) {
+        std::cout << separator << "\"" << phase << "\": " << time;
+        separator = ", ";
+    }
+    std::cout << "}, \"peak_memory_kib\": " << peak_memory_kib() << "}" << std::endl;
+}
+
+// Fix the variables of a QUBO with the steps of fix_variables_::fixQuboVariables(),
+// timing each of them.
+void bench_roof_duality(const Options& options, const bench::BQM& bqm) {
+    using capacity_t = fix_variables_::capacity_type;
+    using posiform_type = PosiformInfo<bench::BQM, capacity_t>;
+    using network_type = ImplicationNetwork<capacity_t, true>;
+
+    Timings timings;
+    std::map<std::string, double> counts;
+    counts["num_variables"] = bqm.num_variables();
+    counts["num_interactions"] = bqm.num_interactions();
+
+    typename network_type::workspace_t workspace;
+    for (int r = 0; r < options.repeat; ++r) {
+        auto start = clock_type::now();
+        posiform_type posiform(bqm);
+        auto posiform_built = clock_type::now();
+        network_type network(posiform);
+        auto network_built = clock_type::now();
+        timings.record("posiform", posiform_built - start);
+        timings.record("network", network_built - posiform_built);
+
+        std::vector<std::pair<int, int>> fixed_posiform;
+        auto algorithm = network.selectMaxFlowAlgorithm();
+        network.fixVariables(fixed_posiform, options.strict, algorithm, &workspace);
+        timings.record("maximum_flow", workspace.timings.maximum_flow);
+        timings.record("symmetrization", workspace.timings.symmetrization);
+        timings.record("strongly_connected_components",
+                       workspace.timings.strongly_connected_components);
+        timings.record("fixing", workspace.timings.fixing);
+
+        start = clock_type::now();
+        std::vector<std::pair<int, int>> fixed;
+        fix_variables_::convertFixedVariables(posiform, bqm.num_variables(), options.strict,
+                                              fixed_posiform, fixed);
+        timings.record("conversion", clock_type::now() - start);
+
+        counts["num_fixed"] = fixed.size();
+        counts["boykov_kolmogorov"] = algorithm == MaxFlowAlgorithm::BOYKOV_KOLMOGOROV;
+    }
+    print_json(options, "roof_duality", counts, timings);
+}
+
+// Normalize, presolve and restore a CQM, timing each step and each round.
+void bench_presolve(const Options& options, const bench::CQM& cqm) {
+    using Presolver = dwave::presolve::Presolver<double, int, double>;
+
+    Timings timings;
+    std::map<std::string, double> counts;
+    counts["num_variables"] = cqm.num_variables();
+    counts["num_constraints"] = cqm.num_constraints();
+
+    const std::size_t num_samples = 100;
+    for (int r = 0; r < options.repeat; ++r) {
+        Presolver presolver(cqm);
+        presolver.set_num_threads(options.num_threads);
+        if (options.probing) presolver.add_techniques(dwave::presolve::TechniqueFlags::Probing);
+
+        auto start = clock_type::now();
+        presolver.normalize();
+        timings.record("normalize", clock_type::now() - start);
+
+        start = clock_type::now();
+        presolver.presolve();
+        timings.record("presolve", clock_type::now() - start);
+
+        const auto& statistics = presolver.statistics();
+        for (std::size_t round = 0; round < statistics.rounds.size(); ++round) {
+            timings.record("round_" + std::to_string(round), statistics.rounds[round].time);
+        }
+        timings.record("remove_parallel_constraints",
+                       statistics.remove_parallel_constraints.time);
+        timings.record("roof_duality", statistics.roof_duality.time);
+        timings.record("probing", statistics.probing.time);
+
+        std::vector<double> reduced(num_samples * presolver.model().num_variables(), 0);
+        std::vector<double> original(num_samples * cqm.num_variables());
+        start = clock_type::now();
+        presolver.restore_batch(reduced.data(), num_samples, original.data());
+        timings.record("restore", clock_type::now() - start);
+
+        counts["num_rounds"] = statistics.rounds.size();
+        counts["num_reduced_variables"] = presolver.model().num_variables();
+        counts["num_reduced_constraints"] = presolver.model().num_constraints();
+        counts["num_restored_samples"] = num_samples;
+        counts["num_probed"] = statistics.probing.num_calls;
+        counts["num_implications"] = statistics.num_implications;
+    }
+    print_json(options, "presolve", counts, timings);
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--generator") {
+            options.generator = value();
+        } else if (arg == "--size") {
+            options.size = std::stoi(value());
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(value());
+        } else if (arg == "--repeat") {
+            options.repeat = std::stoi(value());
+        } else if (arg == "--threads") {
+            options.num_threads = std::stoi(value());
+        } else if (arg == "--strict") {
+            options.strict = true;
+        } else if (arg == "--probing") {
+            options.probing = true;
+        } else {
+            throw std::invalid_argument("unknown argument " + arg);
+        }
+    }
+    if (options.size < 1) throw std::invalid_argument("--size must be positive");
+    if (options.repeat < 1) throw std::invalid_argument("--repeat must be positive");
+    if (options.num_threads < 1) throw std::invalid_argument("--threads must be positive");
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parse_options(argc, argv);
+        if (options.generator == "qubo") {
+            bench_roof_duality(options, bench::random_sparse_qubo(options.size, 6, options.seed));
+        } else if (options.generator == "chimera") {
+            bench_roof_duality(options, bench::chimera_qubo(options.size, options.seed));
+        } else if (options.generator == "kings") {
+            bench_roof_duality(options, bench::kings_qubo(options.size, options.seed));
+        } else if (options.generator == "knapsack") {
+            bench_presolve(options, bench::knapsack_cqm(options.size, options.seed));
+        } else if (options.generator == "assignment") {
+            bench_presolve(options, bench::assignment_cqm(options.size, options.seed));
+        } else {
+            throw std::invalid_argument(
+                    "--generator must be one of qubo, chimera, kings, knapsack or assignment");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "dimod/binary_quadratic_model.h"
+#include "dimod/constrained_quadratic_model.h"
+
+// Instance generators for the benchmarks. They are all seeded, so an instance is
+// the same across runs, machines and releases for the same parameters. The biases
+// are integers so that the QUBOs never need the wide capacities.
+namespace bench {
+
+using BQM = dimod::BinaryQuadraticModel<double, int>;
+using CQM = dimod::ConstrainedQuadraticModel<double, int>;
+
+// A QUBO on num_variables variables with about average_degree * num_variables / 2
+// interactions between uniformly random pairs of variables.
+inline BQM random_sparse_qubo(int num_variables, int average_degree, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> bias(-100, 100);
+    std::uniform_int_distribution<int> variable(0, num_variables - 1);
+
+    BQM bqm(num_variables, dimod::Vartype::BINARY);
+    for (int v = 0; v < num_variables; ++v) {
+        bqm.set_linear(v, bias(rng));
+    }
+    std::int64_t num_interactions = static_cast<std::int64_t>(num_variables) * average_degree / 2;
+    for (std::int64_t i = 0; i < num_interactions; ++i) {
+        int u = variable(rng);
+        int v = variable(rng);
+        if (u != v) {
+            bqm.add_quadratic(u, v, bias(rng));
+        }
+    }
+    return bqm;
+}
+
+// A QUBO on a Chimera lattice of m x m unit cells, each a complete bipartite
+// graph between two shores of t variables, with the shores coupled to the same
+// shore of the neighbouring cells vertically or horizontally. The smallest
+// lattice with at least num_variables variables is used.
+inline BQM chimera_qubo(int num_variables, std::uint64_t seed, int t = 4) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> bias(-100, 100);
+
+    int m = std::max(1, static_cast<int>(std::ceil(std::sqrt(num_variables / (2.0 * t)))));
+    auto index = [&](int row, int col, int shore, int k) {
+        return ((row * m + col) * 2 + shore) * t + k;
+    };
+
+    BQM bqm(2 * t * m * m, dimod::Vartype::BINARY);
+    for (std::size_t v = 0; v < bqm.num_variables(); ++v) {
+        bqm.set_linear(v, bias(rng));
+    }
+    for (int row = 0; row < m; ++row) {
+        for (int col = 0; col < m; ++col) {
+            for (int i = 0; i < t; ++i) {
+                for (int j = 0; j < t; ++j) {
+                    bqm.add_quadratic(index(row, col, 0, i), index(row, col, 1, j), bias(rng));
+                }
+                if (row + 1 < m) {
+                    bqm.add_quadratic(index(row, col, 0, i), index(row + 1, col, 0, i), bias(rng));
+                }
+                if (col + 1 < m) {
+                    bqm.add_quadratic(index(row, col, 1, i), index(row, col + 1, 1, i), bias(rng));
+                }
+            }
+        }
+    }
+    return bqm;
+}
+
+// A QUBO on a square lattice where each variable is coupled to its eight
+// neighbours, horizontally, vertically and diagonally. It has the degree and
+// the short cycles of the denser QPU topologies, like Pegasus and Zephyr, without
+// their exact structure. The smallest square with at least num_variables
+// variables is used.
+inline BQM kings_qubo(int num_variables, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> bias(-100, 100);
+
+    int side = std::max(1, static_cast<int>(std::ceil(std::sqrt(num_variables))));
+    BQM bqm(side * side, dimod::Vartype::BINARY);
+    for (int row = 0; row < side; ++row) {
+        for (int col = 0; col < side; ++col) {
+            int v = row * side + col;
+            bqm.set_linear(v, bias(rng));
+            if (col + 1 < side) bqm.add_quadratic(v, v + 1, bias(rng));
+            if (row + 1 < side) {
+                bqm.add_quadratic(v, v + side, bias(rng));
+                if (col + 1 < side) bqm.add_quadratic(v, v + side + 1, bias(rng));
+                if (col > 0) bqm.add_quadratic(v, v + side - 1, bias(rng));
+            }
+        }
+    }
+    return bqm;
+}
+
+// A knapsack problem: maximize the value of the binary variables picked, while
+// their total weight is at most half of the weight of all of them.
+inline CQM knapsack_cqm(int num_variables, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> value(1, 1000);
+    std::uniform_int_distribution<int> weight(1, 1000);
+
+    CQM cqm;
+    cqm.add_variables(dimod::Vartype::BINARY, num_variables);
+
+    std::vector<int> variables(num_variables);
+    std::vector<double> weights(num_variables);
+    double total_weight = 0;
+    for (int v = 0; v < num_variables; ++v) {
+        cqm.objective.set_linear(v, -value(rng));
+        variables[v] = v;
+        weights[v] = weight(rng);
+        total_weight += weights[v];
+    }
+    cqm.add_linear_constraint(variables, weights, dimod::Sense::LE, total_weight / 2);
+    return cqm;
+}
+
+// An assignment problem on the smallest n x n grid of binary variables with at
+// least num_variables variables: assign each of n agents to one of n tasks at
+// the least cost, with each task done by exactly one agent.
+inline CQM assignment_cqm(int num_variables, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> cost(1, 100);
+
+    int n = std::max(1, static_cast<int>(std::ceil(std::sqrt(num_variables))));
+    CQM cqm;
+    cqm.add_variables(dimod::Vartype::BINARY, n * n);
+    for (int v = 0; v < n * n; ++v) {
+        cqm.objective.set_linear(v, cost(rng));
+    }
+
+    std::vector<double> ones(n, 1);
+    std::vector<int> variables(n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) variables[j] = i * n + j;
+        cqm.add_linear_constraint(variables, ones, dimod::Sense::EQ, 1);
+        for (int j = 0; j < n; ++j) variables[j] = j * n + i;
+        cqm.add_linear_constraint(variables, ones, dimod::Sense::EQ, 1);
+    }
+    return cqm;
+}
+
+}  // namespace bench
@@ -0,0 +1,116 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+
+#include "catch2/catch.hpp"
+#include "dwave-preprocessing/bias_statistics.hpp"
+#include "dwave-preprocessing/posiform_info.hpp"
+
+TEST_CASE("Tests for biasStatistics", "[biasstatistics]") {
+    GIVEN("a BQM") {
+        auto bqm = dimod::BinaryQuadraticModel<double, int>(4, dimod::Vartype::SPIN);
+        bqm.set_linear(0, 1.5);
+        bqm.set_linear(1, -3);
+        bqm.set_linear(2, 0);
+        bqm.set_linear(3, .5);
+        bqm.add_quadratic(0, 1, 2);
+        bqm.add_quadratic(1, 3, -.25);
+        bqm.add_quadratic(2, 3, 4);
+        bqm.set_offset(2);
+
+        auto stats = biasStatistics(bqm);
+
+        THEN("the statistics are those of the linear and of the quadratic biases") {
+            CHECK(stats.num_linear == 4);
+            CHECK(stats.min_linear == -3);
+            CHECK(stats.max_linear == 1.5);
+            CHECK(stats.max_abs_linear == 3);
+            CHECK(stats.min_abs_linear == .5);
+
+            CHECK(stats.num_quadratic == 3);
+            CHECK(stats.min_quadratic == -.25);
+            CHECK(stats.max_quadratic == 4);
+            CHECK(stats.max_abs_quadratic == 4);
+            CHECK(stats.min_abs_quadratic == .25);
+
+            CHECK(stats.maxAbsBias() == 4);
+            CHECK(stats.minAbsBias() == .25);
+        }
+
+        WHEN("the BQM is scaled with the statistics") {
+            scaleBiases(bqm, -2.0, false, &stats);
+
+            THEN("the biases are scaled, but not the offset") {
+                CHECK(bqm.linear(1) == 6);
+                CHECK(bqm.quadratic(2, 3) == -8);
+                CHECK(bqm.offset() == 2);
+            }
+
+            THEN("the statistics are those of the scaled BQM") {
+                auto expected = biasStatistics(bqm);
+                CHECK(stats.min_linear == expected.min_linear);
+                CHECK(stats.max_linear == expected.max_linear);
+                CHECK(stats.max_abs_linear == expected.max_abs_linear);
+                CHECK(stats.min_abs_linear == expected.min_abs_linear);
+                CHECK(stats.min_quadratic == expected.min_quadratic);
+                CHECK(stats.max_quadratic == expected.max_quadratic);
+                CHECK(stats.max_abs_quadratic == expected.max_abs_quadratic);
+                CHECK(stats.min_abs_quadratic == expected.min_abs_quadratic);
+            }
+        }
+
+        WHEN("the BQM is clipped with the statistics") {
+            clipBiases(bqm, -1.0, 1.0, &stats);
+
+            THEN("the biases are clipped, but not the offset") {
+                CHECK(bqm.linear(0) == 1);
+                CHECK(bqm.linear(1) == -1);
+                CHECK(bqm.linear(3) == .5);
+                CHECK(bqm.quadratic(0, 1) == 1);
+                CHECK(bqm.quadratic(1, 3) == -.25);
+                CHECK(bqm.quadratic(3, 2) == 1);
+                CHECK(bqm.offset() == 2);
+            }
+
+            THEN("the statistics are those of the clipped BQM") {
+                CHECK(stats.min_linear == -1);
+                CHECK(stats.max_linear == 1);
+                CHECK(stats.max_quadratic == 1);
+                CHECK(stats.min_abs_quadratic == .25);
+            }
+        }
+
+        WHEN("a PosiformInfo is built from the statistics") {
+            PosiformInfo<dimod::BinaryQuadraticModel<double, int>, std::int64_t> from_bqm(bqm);
+            PosiformInfo<dimod::BinaryQuadraticModel<double, int>, std::int64_t> from_stats(
+                    bqm, 1, &stats);
+
+            THEN("it is the same as one that reads the biases itself") {
+                CHECK(from_stats.getBiasConversionRatio() == from_bqm.getBiasConversionRatio());
+                CHECK(from_stats.getMinAbsoluteBias() == from_bqm.getMinAbsoluteBias());
+                CHECK(from_stats.getConstant() == from_bqm.getConstant());
+            }
+        }
+    }
+
+    GIVEN("an empty BQM") {
+        auto bqm = dimod::BinaryQuadraticModel<double, int>(dimod::Vartype::BINARY);
+        auto stats = biasStatistics(bqm);
+        CHECK(stats.num_linear == 0);
+        CHECK(stats.num_quadratic == 0);
+        CHECK(stats.maxAbsBias() == 0);
+        CHECK(stats.minAbsBias() == 0);
+    }
+}
@@ -0,0 +1,116 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "dwave-preprocessing/connected_components.hpp"
+#include "dwave-preprocessing/fix_variables.hpp"
+
+TEST_CASE("Tests for connectedComponents", "[connectedcomponents]") {
+    SECTION("Test simple case") {
+        // 0 - 3 - 4, 1 - 2 and 5 on its own
+        auto bqm = dimod::BinaryQuadraticModel<double, int>(6, dimod::Vartype::SPIN);
+        for (int v = 0; v < 6; v++) bqm.set_linear(v, v);
+        bqm.add_quadratic(3, 4, -1);
+        bqm.add_quadratic(0, 3, 2);
+        bqm.add_quadratic(2, 1, 3);
+
+        for (int num_threads : {1, 3}) {
+            auto components = connectedComponents(bqm, num_threads);
+            REQUIRE(components.size() == 3);
+
+            CHECK(components[0].variables == std::vector<int>{0, 3, 4});
+            CHECK(components[0].linear == std::vector<double>{0, 3, 4});
+            CHECK(components[0].irow == std::vector<int>{0, 1});
+            CHECK(components[0].icol == std::vector<int>{1, 2});
+            CHECK(components[0].quadratic == std::vector<double>{2, -1});
+
+            CHECK(components[1].variables == std::vector<int>{1, 2});
+            CHECK(components[1].linear == std::vector<double>{1, 2});
+            CHECK(components[1].irow == std::vector<int>{0});
+            CHECK(components[1].icol == std::vector<int>{1});
+            CHECK(components[1].quadratic == std::vector<double>{3});
+
+            CHECK(components[2].variables == std::vector<int>{5});
+            CHECK(components[2].linear == std::vector<double>{5});
+            CHECK(components[2].quadratic.empty());
+
+            auto sub = components[0].toBQM(dimod::Vartype::SPIN);
+            CHECK(sub.num_variables() == 3);
+            CHECK(sub.num_interactions() == 2);
+            CHECK(sub.quadratic(0, 1) == 2);
+            CHECK(sub.quadratic(1, 2) == -1);
+            CHECK(sub.linear(2) == 4);
+        }
+
+        REQUIRE_THROWS_AS(connectedComponents(bqm, 0), std::invalid_argument);
+    }
+
+    SECTION("Test a large sparse BQM with many threads") {
+        // Real valued biases, so that there are no ties between optimal solutions
+        // that the posiforms of the whole BQM and of the components could round
+        // differently.
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> bias(-10, 10);
+        const int num_vars = 2000;
+        std::uniform_int_distribution<int> variable(0, num_vars - 1);
+
+        auto bqm = dimod::BinaryQuadraticModel<double, int>(num_vars, dimod::Vartype::BINARY);
+        for (int u = 0; u < num_vars; u++) bqm.set_linear(u, bias(rng));
+        for (int i = 0; i < num_vars / 2; i++) {
+            int u = variable(rng);
+            int v = variable(rng);
+            if (u != v) bqm.add_quadratic(u, v, bias(rng) + 11);
+        }
+
+        auto components = connectedComponents(bqm);
+        auto parallel_components = connectedComponents(bqm, 8);
+        REQUIRE(components.size() == parallel_components.size());
+
+        std::size_t num_component_variables = 0;
+        std::size_t num_component_interactions = 0;
+        std::vector<dimod::BinaryQuadraticModel<double, int>> bqms;
+        for (std::size_t c = 0; c < components.size(); c++) {
+            CHECK(components[c].variables == parallel_components[c].variables);
+            CHECK(components[c].quadratic == parallel_components[c].quadratic);
+            num_component_variables += components[c].variables.size();
+            num_component_interactions += components[c].quadratic.size();
+            bqms.push_back(components[c].toBQM(dimod::Vartype::BINARY));
+        }
+        CHECK(num_component_variables == bqm.num_variables());
+        CHECK(num_component_interactions == bqm.num_interactions());
+
+        // The components can be fixed independently, with the same result as the
+        // whole BQM when strict
+        std::vector<dimod::BinaryQuadraticModel<double, int>*> pointers;
+        for (auto& sub : bqms) pointers.push_back(&sub);
+        auto results = fix_variables_::fixQuboVariablesBatch(pointers, true, {}, 4);
+
+        std::vector<std::pair<int, int>> fixed;
+        for (std::size_t c = 0; c < components.size(); c++) {
+            for (auto& [v, value] : results[c].second) {
+                fixed.emplace_back(components[c].variables[v], value);
+            }
+        }
+        std::sort(fixed.begin(), fixed.end());
+
+        auto expected = fix_variables_::fixQuboVariables(bqm, true).second;
+        std::sort(expected.begin(), expected.end());
+        CHECK(fixed == expected);
+    }
+}
@@ -0,0 +1,97 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "dwave/implications.hpp"
+
+namespace dwave {
+
+using ImplicationTable = presolve::ImplicationTable<double, int>;
+using Implication = ImplicationTable::Implication;
+
+TEST_CASE("Test ImplicationTable", "[presolve][implications]") {
+    GIVEN("A table with the implications of three variables") {
+        ImplicationTable table;
+        table.resize(3);
+
+        // x0 == 0 implies x1 <= 0 and x2 >= 1, x0 == 1 implies x2 <= 0.5
+        table.set(0, false, {{1, true, 0}, {2, false, 1}});
+        table.set(0, true, {{2, true, 0.5}});
+        // x2 == 1 implies x1 >= 1
+        table.set(2, true, {{1, false, 1}});
+
+        THEN("they can be read back") {
+            CHECK(table.num_variables() == 3);
+            CHECK(table.size() == 4);
+            CHECK(!table.empty());
+
+            const auto& implications = table.implications(0, false);
+            REQUIRE(implications.size() == 2);
+            CHECK(implications[1].v == 2);
+            CHECK(!implications[1].upper);
+            CHECK(implications[1].bound == 1);
+            CHECK(table.implications(1, true).empty());
+        }
+
+        WHEN("the implications of a value are replaced") {
+            table.set(0, false, {{1, true, 0}});
+
+            THEN("the size is updated") {
+                CHECK(table.size() == 3);
+                CHECK(table.implications(0, false).size() == 1);
+            }
+        }
+
+        WHEN("x1 is removed and the others are relabelled") {
+            table.relabel({0, -1, 1});
+
+            THEN("the implications of and on x1 are dropped") {
+                CHECK(table.num_variables() == 2);
+                CHECK(table.size() == 2);
+
+                const auto& implications = table.implications(0, false);
+                REQUIRE(implications.size() == 1);
+                CHECK(implications[0].v == 1);
+                CHECK(!implications[0].upper);
+                CHECK(implications[0].bound == 1);
+
+                REQUIRE(table.implications(0, true).size() == 1);
+                CHECK(table.implications(0, true)[0].v == 1);
+                CHECK(table.implications(1, true).empty());
+            }
+        }
+
+        WHEN("the table is made smaller") {
+            table.resize(2);
+
+            THEN("the implications of the removed variable are dropped") {
+                CHECK(table.num_variables() == 2);
+                CHECK(table.size() == 3);
+            }
+        }
+
+        WHEN("the table is cleared") {
+            table.clear();
+
+            THEN("it is empty") {
+                CHECK(table.empty());
+                CHECK(table.num_variables() == 0);
+            }
+        }
+    }
+}
+
+}  // namespace dwave
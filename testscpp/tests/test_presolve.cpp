@@ -12,6 +12,9 @@
 //    See the License for the specific language governing permissions and
 //    limitations under the License.
 
+#include <stdexcept>
+#include <string>
+
 #include "catch2/catch.hpp"
 #include "dimod/constrained_quadratic_model.h"
 #include "dwave/exceptions.hpp"
@@ -61,6 +64,62 @@ TEST_CASE("Test Presolver::presolve()", "[presolve]") {
 
             CHECK(!pre.presolve(std::chrono::duration<double>(0)));
         }
+
+        THEN("Presolving with 0 work_limit does nothing") {
+            auto pre = Presolver(cqm);
+            pre.normalize();
+
+            CHECK(!pre.presolve(std::chrono::duration<double>(100), 0));
+            CHECK(pre.statistics().total().work_units == 0);
+        }
+    }
+
+    GIVEN("A CQM where the bounds propagate along a chain of constraints") {
+        // x0 <= x1 <= ... <= x19 <= 5, presolve the last constraint first so each round
+        // propagates the bound one step down the chain
+        const int num_variables = 20;
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, num_variables);
+        for (int v = 0; v < num_variables - 1; ++v) {
+            cqm.add_linear_constraint({v, v + 1}, {1, -1}, dimod::Sense::LE, 0);
+        }
+        cqm.add_linear_constraint({num_variables - 1}, {1}, dimod::Sense::LE, 5);
+
+        WHEN("We presolve without a work_limit") {
+            auto pre = Presolver(cqm);
+            pre.normalize();
+            pre.presolve();
+
+            THEN("The bound propagates all of the way down") {
+                CHECK(pre.model().upper_bound(0) == 5);
+            }
+        }
+
+        WHEN("We presolve with a work_limit") {
+            const std::size_t work_limit = 80;
+
+            auto pre0 = Presolver(cqm);
+            pre0.normalize();
+            pre0.presolve(std::chrono::duration<double>(100), work_limit);
+
+            auto pre1 = Presolver(cqm);
+            pre1.normalize();
+            pre1.presolve(std::chrono::duration<double>(100), work_limit);
+
+            THEN("Presolve stops once the work is spent") {
+                const auto work_units = pre0.statistics().total().work_units;
+                CHECK(work_units >= work_limit);
+                CHECK(work_units <= work_limit + 3);  // at most one more constraint
+                CHECK(pre0.model().upper_bound(0) > 5);
+            }
+
+            THEN("The result is the same every time") {
+                CHECK(pre0.statistics().rounds.size() == pre1.statistics().rounds.size());
+                for (int v = 0; v < num_variables; ++v) {
+                    CHECK(pre0.model().upper_bound(v) == pre1.model().upper_bound(v));
+                }
+            }
+        }
     }
 }
 
@@ -151,6 +210,118 @@ TEST_CASE("Presolve techniques can be changed", "[presolve]") {
     }
 }
 
+TEST_CASE("Presolve threads can be changed", "[presolve]") {
+    GIVEN("An empty presolver") {
+        auto pre = Presolver();
+
+        THEN("It defaults to one thread") {
+            CHECK(pre.num_threads() == 1);
+        }
+
+        WHEN("We set the number of threads") {
+            auto num_threads = pre.set_num_threads(8);
+
+            THEN("The new value is returned and set") {
+                CHECK(num_threads == 8);
+                CHECK(pre.num_threads() == 8);
+            }
+        }
+
+        WHEN("We set a number of threads that is not positive") {
+            THEN("An exception is thrown and the number of threads is unchanged") {
+                CHECK_THROWS_AS(pre.set_num_threads(0), std::invalid_argument);
+                CHECK_THROWS_AS(pre.set_num_threads(-3), std::invalid_argument);
+                CHECK(pre.num_threads() == 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("Presolve probing can be configured", "[presolve]") {
+    GIVEN("An empty presolver") {
+        auto pre = Presolver();
+
+        THEN("It probes the most constrained variables first, within a work limit") {
+            CHECK(pre.probing_order() == presolve::ProbingOrder::MostConstrainedFirst);
+            CHECK(pre.probing_work_limit() == 10000000);
+            CHECK(pre.implications().empty());
+        }
+
+        WHEN("We set the order and the limits") {
+            auto order = pre.set_probing_order(presolve::ProbingOrder::IndexOrder);
+            pre.set_probing_limits(std::chrono::duration<double>(1.5), 100);
+
+            THEN("The new values are set") {
+                CHECK(order == presolve::ProbingOrder::IndexOrder);
+                CHECK(pre.probing_order() == presolve::ProbingOrder::IndexOrder);
+                CHECK(pre.probing_time_limit().count() == 1.5);
+                CHECK(pre.probing_work_limit() == 100);
+            }
+        }
+    }
+}
+
+TEST_CASE("Presolve statistics", "[presolve]") {
+    GIVEN("A CQM where domain propagation fixes every variable") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, 2);
+        cqm.objective.set_linear(0, 1);
+        cqm.objective.set_linear(1, 1e-12);  // small enough to be removed
+        cqm.add_linear_constraint({0, 1}, {1, 1}, dimod::Sense::LE, 5);
+        cqm.add_linear_constraint({0}, {1}, dimod::Sense::GE, 5);
+
+        auto pre = Presolver(cqm);
+
+        THEN("There are no statistics before presolve") {
+            CHECK(pre.statistics().rounds.empty());
+            CHECK(pre.statistics().num_variables_fixed == 0);
+        }
+
+        for (int num_threads : {1, 2}) {
+            WHEN("We presolve with " + std::to_string(num_threads) + " thread(s)") {
+                pre.set_num_threads(num_threads);
+                pre.normalize();
+                pre.presolve();
+
+                const auto& statistics = pre.statistics();
+                const auto total = statistics.total();
+
+                THEN("The reductions are counted") {
+                    REQUIRE(statistics.rounds.size() >= 1);
+                    if (num_threads > 1) {
+                        // the later passes of the round visit the constraints again
+                        CHECK(statistics.rounds[0].num_constraints >= 2);
+                    } else {
+                        CHECK(statistics.rounds[0].num_constraints == 2);
+                    }
+
+                    CHECK(total.num_bounds_tightened >= 3);
+                    CHECK(total.num_biases_removed == 1);
+                    CHECK(total.domain_propagation.num_changes >= 1);
+                    CHECK(total.remove_redundant_constraints.num_changes == 2);
+                    CHECK(total.remove_small_biases.num_calls >= 3);  // objective + constraints
+
+                    CHECK(statistics.num_variables_fixed == 2);
+                    CHECK(statistics.num_constraints_removed == 2);
+                }
+
+                THEN("The timings are consistent") {
+                    CHECK(total.domain_propagation.time.count() >= 0);
+                    CHECK(total.time <= statistics.time);
+                }
+
+                AND_WHEN("We presolve again") {
+                    pre.presolve();
+
+                    THEN("The statistics are for the new call") {
+                        CHECK(pre.statistics().num_variables_fixed == 0);
+                    }
+                }
+            }
+        }
+    }
+}
+
 SCENARIO("constrained quadratic models can be presolved") {
     GIVEN("a cqm with some trivial issues") {
         auto cqm = dimod::ConstrainedQuadraticModel<double>();
@@ -12,6 +12,10 @@
 //    See the License for the specific language governing permissions and
 //    limitations under the License.
 
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
 #include "catch2/catch.hpp"
 #include "dimod/constrained_quadratic_model.h"
 #include "presolveimpl.hpp"
@@ -60,6 +64,479 @@ TEST_CASE("Test apply()", "[presolve][impl]") {
     }
 }
 
+TEST_CASE("Test presolve()", "[presolve][impl]") {
+    GIVEN("A CQM with a chain of constraints that must be visited back to front") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, 5, 0, 100);
+        for (int v = 0; v < 4; ++v) {
+            cqm.add_linear_constraint({v, v + 1}, {1, -1}, dimod::Sense::LE, 0);  // xv <= xv+1
+        }
+        cqm.add_linear_constraint({4}, {1}, dimod::Sense::LE, 5);  // x4 <= 5
+
+        WHEN("We presolve with domain propagation") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::DomainPropagation;
+            pre.normalize();
+            CHECK(pre.presolve());
+
+            THEN("The tightened bound is propagated along the whole chain") {
+                REQUIRE(pre.model().num_variables() == 5);
+                for (int v = 0; v < 5; ++v) {
+                    CHECK(pre.model().lower_bound(v) == 0);
+                    CHECK(pre.model().upper_bound(v) == 5);
+                }
+            }
+        }
+
+        WHEN("We presolve with domain propagation using several threads") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::DomainPropagation;
+            pre.num_threads = 4;
+            pre.normalize();
+            CHECK(pre.presolve());
+
+            THEN("The result is the same as the serial one") {
+                REQUIRE(pre.model().num_variables() == 5);
+                for (int v = 0; v < 5; ++v) {
+                    CHECK(pre.model().lower_bound(v) == 0);
+                    CHECK(pre.model().upper_bound(v) == 5);
+                }
+            }
+        }
+
+        WHEN("We presolve with too few rounds to reach the front of the chain") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::DomainPropagation;
+            pre.max_num_rounds = 2;
+            pre.normalize();
+            pre.presolve();
+
+            THEN("Only the constraints queued by the bound changes have been visited") {
+                CHECK(pre.model().upper_bound(4) == 5);
+                CHECK(pre.model().upper_bound(3) == 5);
+                CHECK(pre.model().upper_bound(2) == 100);
+            }
+        }
+    }
+
+    GIVEN("A CQM with a chain of constraints longer than the number of rounds") {
+        const int num_variables = 150;
+
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, num_variables, 0, 1000);
+        cqm.add_linear_constraint({0}, {1}, dimod::Sense::LE, 5);  // x0 <= 5
+        for (int v = 0; v + 1 < num_variables; ++v) {
+            cqm.add_linear_constraint({v + 1, v}, {1, -1}, dimod::Sense::LE, 0);  // xv+1 <= xv
+        }
+
+        auto serial = PresolverImpl(cqm);
+        serial.techniques = presolve::TechniqueFlags::DomainPropagation;
+        serial.max_num_rounds = 100;
+        serial.normalize();
+        serial.presolve();
+
+        for (int num_threads : {2, 4}) {
+            WHEN("We presolve with " + std::to_string(num_threads) + " threads") {
+                auto pre = PresolverImpl(cqm);
+                pre.techniques = presolve::TechniqueFlags::DomainPropagation;
+                pre.max_num_rounds = 100;
+                pre.num_threads = num_threads;
+                pre.normalize();
+                pre.presolve();
+
+                THEN("The bound is propagated along the whole chain, as it is serially") {
+                    REQUIRE(pre.model().num_variables() == num_variables);
+                    REQUIRE(serial.model().num_variables() == num_variables);
+                    for (int v = 0; v < num_variables; ++v) {
+                        CHECK(pre.model().upper_bound(v) == serial.model().upper_bound(v));
+                    }
+                    CHECK(pre.model().upper_bound(num_variables - 1) == 5);
+                }
+            }
+        }
+    }
+
+    GIVEN("A CQM where the lower bounds found by some constraints tighten another") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, 3, 0, 100);
+        cqm.add_linear_constraint({0, 1, 2}, {1, 1, 1}, dimod::Sense::LE, 10);
+        cqm.add_linear_constraint({0}, {1}, dimod::Sense::GE, 4);
+        cqm.add_linear_constraint({1}, {1}, dimod::Sense::GE, 5);
+
+        WHEN("We presolve with domain propagation") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::DomainPropagation;
+            pre.normalize();
+            CHECK(pre.presolve());
+
+            THEN("The first constraint sees the updated activities") {
+                CHECK(pre.model().lower_bound(0) == 4);
+                CHECK(pre.model().upper_bound(0) == 5);
+                CHECK(pre.model().lower_bound(1) == 5);
+                CHECK(pre.model().upper_bound(1) == 6);
+                CHECK(pre.model().lower_bound(2) == 0);
+                CHECK(pre.model().upper_bound(2) == 1);
+            }
+        }
+
+        WHEN("We presolve using several threads") {
+            auto pre = PresolverImpl(cqm);
+            pre.num_threads = 3;
+            pre.normalize();
+            pre.presolve();
+
+            THEN("The result is the same as the serial one") {
+                REQUIRE(pre.model().num_variables() == 3);
+                CHECK(pre.model().lower_bound(0) == 4);
+                CHECK(pre.model().upper_bound(0) == 5);
+                CHECK(pre.model().lower_bound(1) == 5);
+                CHECK(pre.model().upper_bound(1) == 6);
+                CHECK(pre.model().lower_bound(2) == 0);
+                CHECK(pre.model().upper_bound(2) == 1);
+            }
+        }
+
+        WHEN("We add a constraint that conflicts with the others") {
+            cqm.add_linear_constraint({0}, {1}, dimod::Sense::LE, 3);
+
+            auto pre = PresolverImpl(cqm);
+            pre.num_threads = 2;
+            pre.normalize();
+            pre.presolve();
+
+            THEN("The model is found to be infeasible") {
+                CHECK(pre.feasibility() == presolve::Feasibility::Infeasible);
+            }
+        }
+    }
+
+    GIVEN("A CQM with a redundant constraint over a chain of constraints") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, 4, 0, 100);
+        cqm.add_linear_constraint({0, 1, 2, 3}, {1, 1, 1, 1}, dimod::Sense::LE, 1000);
+        for (int v = 0; v < 3; ++v) {
+            cqm.add_linear_constraint({v, v + 1}, {1, -1}, dimod::Sense::LE, 0);  // xv <= xv+1
+        }
+        cqm.add_linear_constraint({3}, {1}, dimod::Sense::LE, 5);  // x3 <= 5
+
+        for (int num_threads : {1, 2}) {
+            WHEN("We presolve with " + std::to_string(num_threads) + " thread(s)") {
+                auto pre = PresolverImpl(cqm);
+                pre.techniques = presolve::TechniqueFlags::DomainPropagation |
+                                 presolve::TechniqueFlags::RemoveRedundantConstraints;
+                pre.num_threads = num_threads;
+                pre.normalize();
+                CHECK(pre.presolve());
+
+                THEN("The cleared constraint is not visited again") {
+                    const auto& rounds = pre.statistics().rounds;
+                    REQUIRE(rounds.size() >= 1);
+                    CHECK(rounds[0].remove_redundant_constraints.num_changes == 2);
+
+                    // each of the three bound changes along the chain queues at most
+                    // the two constraints of the variable that are left. In parallel
+                    // they are visited by later passes of the first round.
+                    if (num_threads > 1) {
+                        CHECK(rounds[0].num_constraints <= 5 + 3 * 2);
+                    } else {
+                        REQUIRE(rounds.size() > 1);
+                        CHECK(rounds[0].num_constraints == 5);
+                        for (std::size_t r = 1; r < rounds.size(); ++r) {
+                            CHECK(rounds[r].num_constraints <= 2);
+                        }
+                    }
+                }
+
+                THEN("The bounds are the same as without clearing") {
+                    REQUIRE(pre.model().num_variables() == 4);
+                    for (int v = 0; v < 4; ++v) {
+                        CHECK(pre.model().upper_bound(v) == 5);
+                    }
+                    CHECK(pre.model().num_constraints() == 3);
+                }
+            }
+        }
+    }
+
+    GIVEN("A quadratic CQM with a variable fixed by a constraint") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, 3, 0, 10);
+        cqm.objective.set_quadratic(0, 1, 1);
+        cqm.objective.set_linear(2, 2);
+        auto& c0 = cqm.constraint_ref(cqm.add_constraint());
+        c0.set_quadratic(0, 2, 1);
+        c0.set_linear(1, 1);
+        c0.set_rhs(20);
+        c0.set_weight(5);
+        cqm.add_linear_constraint({0}, {1}, dimod::Sense::EQ, 3);
+
+        WHEN("We presolve") {
+            auto pre = PresolverImpl(cqm);
+            pre.apply();
+
+            THEN("The fixed variable is folded into the expressions") {
+                REQUIRE(pre.model().num_variables() == 2);
+                CHECK(pre.model().objective.is_linear());
+                CHECK(pre.model().objective.linear(0) == 3);
+                CHECK(pre.model().objective.linear(1) == 2);
+
+                REQUIRE(pre.model().num_constraints() == 1);
+                const auto& constraint = pre.model().constraint_ref(0);
+                CHECK(constraint.is_linear());
+                CHECK(constraint.linear(0) == 1);
+                CHECK(constraint.linear(1) == 3);
+                CHECK(constraint.rhs() == 20);
+                CHECK(constraint.weight() == 5);
+            }
+
+            THEN("We can restore samples") {
+                CHECK(pre.restore(std::vector<double>{4, 5}) == std::vector<double>{3, 4, 5});
+            }
+        }
+    }
+
+    GIVEN("A feasible CQM with many overlapping constraints") {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> variable(0, 29);
+        std::uniform_int_distribution<int> bias(-5, 5);
+        std::uniform_int_distribution<int> value(0, 20);
+        std::uniform_int_distribution<int> slack(0, 2);
+
+        // every constraint is within a little slack of this point, so they tighten
+        // each other's bounds without making the model infeasible
+        std::vector<int> point(30);
+        for (auto& x : point) x = value(rng);
+
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, 30, 0, 20);
+        for (int c = 0; c < 60; ++c) {
+            std::vector<int> variables;
+            std::vector<double> biases;
+            double activity = 0;
+            for (int i = 0; i < 4; ++i) {
+                const int v = variable(rng);
+                if (std::find(variables.begin(), variables.end(), v) != variables.end()) continue;
+                variables.push_back(v);
+                biases.push_back(bias(rng) + 0.5);  // never zero
+                activity += biases.back() * point[v];
+            }
+            if (c % 2) {
+                cqm.add_linear_constraint(variables, biases, dimod::Sense::LE,
+                                          activity + slack(rng));
+            } else {
+                cqm.add_linear_constraint(variables, biases, dimod::Sense::GE,
+                                          activity - slack(rng));
+            }
+        }
+
+        auto presolve_with = [&](int num_threads) {
+            auto pre = PresolverImpl(cqm);
+            pre.num_threads = num_threads;
+            pre.normalize();
+            pre.presolve();
+            return pre;
+        };
+
+        WHEN("We presolve with different numbers of threads greater than 1") {
+            auto reference = presolve_with(2);
+            REQUIRE(reference.feasibility() != presolve::Feasibility::Infeasible);
+
+            THEN("the presolved models are the same") {
+                for (int num_threads : {2, 3, 8}) {
+                    auto pre = presolve_with(num_threads);
+
+                    REQUIRE(pre.feasibility() == reference.feasibility());
+                    REQUIRE(pre.model().num_variables() == reference.model().num_variables());
+                    for (std::size_t v = 0; v < pre.model().num_variables(); ++v) {
+                        CHECK(pre.model().lower_bound(v) == reference.model().lower_bound(v));
+                        CHECK(pre.model().upper_bound(v) == reference.model().upper_bound(v));
+                    }
+
+                    REQUIRE(pre.model().num_constraints() == reference.model().num_constraints());
+                    for (std::size_t c = 0; c < pre.model().num_constraints(); ++c) {
+                        const auto& constraint = pre.model().constraint_ref(c);
+                        const auto& expected = reference.model().constraint_ref(c);
+                        REQUIRE(constraint.variables() == expected.variables());
+                        for (const auto& v : constraint.variables()) {
+                            CHECK(constraint.linear(v) == expected.linear(v));
+                        }
+                        CHECK(constraint.sense() == expected.sense());
+                        CHECK(constraint.rhs() == expected.rhs());
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Test restore()", "[presolve][impl]") {
+    GIVEN("A CQM with a spin variable, a self-loop and a fixed variable") {
+        auto cqm = ConstrainedQuadraticModel();
+        auto s = cqm.add_variable(dimod::Vartype::SPIN);
+        auto i = cqm.add_variable(dimod::Vartype::INTEGER, 0, 5);
+        auto j = cqm.add_variable(dimod::Vartype::INTEGER, 0, 5);
+        auto x = cqm.add_variable(dimod::Vartype::BINARY);
+        cqm.objective.set_linear(s, 1);
+        cqm.objective.set_quadratic(i, i, 1);
+        cqm.objective.set_quadratic(j, x, 1);
+        cqm.add_linear_constraint({j}, {1}, dimod::Sense::EQ, 2);
+
+        auto pre = PresolverImpl(cqm);
+        pre.apply();
+
+        // the reduced model has s (now binary), i, x and the variable added for the self-loop
+        REQUIRE(pre.model().num_variables() == 4);
+
+        const std::vector<double> reduced{1, 3, 0, 3, 0, 4, 1, 4};
+        const std::vector<double> original{1, 3, 2, 0, -1, 4, 2, 1};
+
+        WHEN("We restore the samples one at a time") {
+            THEN("We get the original samples") {
+                CHECK(pre.restore(std::vector<double>(reduced.begin(), reduced.begin() + 4)) ==
+                      std::vector<double>(original.begin(), original.begin() + 4));
+                CHECK(pre.restore(std::vector<double>(reduced.begin() + 4, reduced.end())) ==
+                      std::vector<double>(original.begin() + 4, original.end()));
+            }
+        }
+
+        WHEN("We restore the samples as a batch") {
+            std::vector<double> restored(original.size());
+            pre.restore_batch(reduced.data(), 2, restored.data());
+
+            THEN("We get the original samples") {
+                CHECK(restored == original);
+            }
+        }
+
+        WHEN("We restore integer samples as a batch with more than one thread") {
+            const std::vector<std::int8_t> reduced_int(reduced.begin(), reduced.end());
+            std::vector<double> restored(original.size());
+            pre.num_threads = 4;
+            pre.restore_batch(reduced_int.data(), 2, restored.data());
+
+            THEN("We get the original samples") {
+                CHECK(restored == original);
+            }
+        }
+    }
+
+    GIVEN("A CQM that has variables fixed by more than one call to presolve()") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, 3, 0, 10);
+        cqm.add_linear_constraint({0, 1}, {-1, 1}, dimod::Sense::EQ, 0);  // x0 == x1
+        cqm.add_linear_constraint({0}, {1}, dimod::Sense::EQ, 3);
+
+        auto pre = PresolverImpl(cqm);
+        pre.techniques = presolve::TechniqueFlags::DomainPropagation;
+        pre.max_num_rounds = 1;  // only fix x0
+        pre.normalize();
+        pre.presolve();
+        REQUIRE(pre.model().num_variables() == 2);
+        pre.presolve();  // now fix x1
+        REQUIRE(pre.model().num_variables() == 1);
+
+        THEN("Both are restored") {
+            CHECK(pre.restore(std::vector<double>{7}) == std::vector<double>{3, 3, 7});
+
+            std::vector<double> restored(6);
+            const std::vector<double> reduced{7, 8};
+            pre.restore_batch(reduced.data(), 2, restored.data());
+            CHECK(restored == std::vector<double>{3, 3, 7, 3, 3, 8});
+        }
+    }
+
+    GIVEN("A CQM that has only been partly normalized") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::SPIN, 2);
+
+        auto pre = PresolverImpl(cqm);
+        pre.normalization_spin_to_binary();
+
+        THEN("restore() and restore_batch() still undo the transforms") {
+            CHECK(pre.restore(std::vector<double>{0, 1}) == std::vector<double>{-1, 1});
+
+            std::vector<double> restored(2);
+            const std::vector<double> reduced{1, 0};
+            pre.restore_batch(reduced.data(), 1, restored.data());
+            CHECK(restored == std::vector<double>{1, -1});
+        }
+    }
+}
+
+TEST_CASE("Test normalize()", "[presolve][impl]") {
+    GIVEN("A CQM that needs every normalization step") {
+        auto cqm = ConstrainedQuadraticModel();
+        auto s = cqm.add_variable(dimod::Vartype::SPIN);
+        auto i = cqm.add_variable(dimod::Vartype::INTEGER, -5, 5);
+        auto x = cqm.add_variable(dimod::Vartype::BINARY, -1, 2);
+        auto r = cqm.add_variable(dimod::Vartype::REAL, 0, std::numeric_limits<double>::infinity());
+
+        cqm.objective.set_linear(s, 1);
+        cqm.objective.set_quadratic(i, i, 2);
+        for (int c = 0; c < 20; ++c) {
+            auto& constraint = cqm.constraint_ref(cqm.add_constraint());
+            constraint.set_linear(s, c % 3 - 1);
+            constraint.set_linear(r, (c % 5) ? 1 : std::numeric_limits<double>::infinity());
+            constraint.set_quadratic(x, i, 0.5 * c);
+            if (c % 4 == 0) constraint.set_quadratic(i, i, 1);
+            constraint.set_offset(c);
+            constraint.set_sense(c % 2 ? dimod::Sense::GE : dimod::Sense::LE);
+            constraint.set_rhs(c % 7);
+        }
+
+        // The steps run one after the other, as separate passes over the model
+        auto serial = PresolverImpl(cqm);
+        serial.normalization_check_nan();
+        serial.normalization_replace_inf();
+        serial.normalization_spin_to_binary();
+        serial.normalization_remove_offsets();
+        serial.normalization_remove_self_loops();
+        serial.normalization_flip_constraints();
+        serial.normalization_remove_invalid_markers();
+        serial.normalization_fix_bounds();
+
+        for (int num_threads : {1, 2}) {
+            WHEN("We normalize with " + std::to_string(num_threads) + " thread(s)") {
+                auto pre = PresolverImpl(cqm);
+                pre.num_threads = num_threads;
+                CHECK(pre.normalize());
+
+                THEN("we get the same model as with the separate steps") {
+                    const auto& expected = serial.model();
+                    const auto& model = pre.model();
+
+                    REQUIRE(model.num_variables() == expected.num_variables());
+                    for (std::size_t v = 0; v < model.num_variables(); ++v) {
+                        CHECK(model.vartype(v) == expected.vartype(v));
+                        CHECK(model.lower_bound(v) == expected.lower_bound(v));
+                        CHECK(model.upper_bound(v) == expected.upper_bound(v));
+                    }
+
+                    REQUIRE(model.num_constraints() == expected.num_constraints());
+                    for (std::size_t c = 0; c < model.num_constraints(); ++c) {
+                        const auto& constraint = model.constraint_ref(c);
+                        const auto& expected_constraint = expected.constraint_ref(c);
+                        CHECK(constraint.sense() == expected_constraint.sense());
+                        CHECK(constraint.rhs() == expected_constraint.rhs());
+                        CHECK(constraint.offset() == expected_constraint.offset());
+                        CHECK(constraint.variables() == expected_constraint.variables());
+                        CHECK(constraint.num_interactions() ==
+                              expected_constraint.num_interactions());
+                        for (const auto& v : constraint.variables()) {
+                            CHECK(constraint.linear(v) == expected_constraint.linear(v));
+                        }
+                    }
+
+                    CHECK(model.objective.variables() == expected.objective.variables());
+                    CHECK(model.objective.num_interactions() ==
+                          expected.objective.num_interactions());
+                    CHECK(model.objective.offset() == expected.objective.offset());
+                }
+            }
+        }
+    }
+}
+
 TEST_CASE("Test normalization_fix_bounds", "[presolve][impl]") {
     GIVEN("A CQM with valid bounds") {
         auto cqm = ConstrainedQuadraticModel();
@@ -530,6 +1007,43 @@ TEST_CASE("Test technique_clear_redundant_constraint", "[presolve][impl]") {
             }
         }
     }
+
+    GIVEN("A CQM with a quadratic constraint x*y + x <= 12 over integers in [0, 3]") {
+        auto cqm = ConstrainedQuadraticModel();
+        auto x = cqm.add_variable(dimod::Vartype::INTEGER, 0, 3);
+        auto y = cqm.add_variable(dimod::Vartype::INTEGER, 0, 3);
+        auto& c = cqm.constraint_ref(cqm.add_constraint());
+        c.set_quadratic(x, y, 1);
+        c.set_linear(x, 1);
+        c.set_sense(dimod::Sense::LE);
+        c.set_rhs(12);
+
+        WHEN("We remove redundant constraints") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::RemoveRedundantConstraints;
+            pre.normalize();
+            pre.presolve();
+
+            THEN("the constraint is removed because its maximal activity is 12") {
+                CHECK(pre.model().num_constraints() == 0);
+                CHECK(pre.feasibility() != presolve::Feasibility::Infeasible);
+            }
+        }
+
+        WHEN("We lower the rhs to 11 and remove redundant constraints") {
+            c.set_rhs(11);
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::RemoveRedundantConstraints;
+            pre.normalize();
+            pre.presolve();
+
+            THEN("the constraint is kept") {
+                REQUIRE(pre.model().num_constraints() == 1);
+                CHECK(pre.model().constraint_ref(0).num_variables() == 2);
+                CHECK(pre.model().constraint_ref(0).quadratic(x, y) == 1);
+            }
+        }
+    }
 }
 
 TEST_CASE("Test technique_domain_propagation", "[presolve][impl]") {
@@ -791,6 +1305,59 @@ TEST_CASE("Test technique_domain_propagation", "[presolve][impl]") {
         }
     }
 
+    GIVEN("A CQM with a binary variable x and an integer variable v in [0, 50]") {
+        auto cqm = ConstrainedQuadraticModel();
+        auto x = cqm.add_variable(dimod::Vartype::BINARY);
+        auto v = cqm.add_variable(dimod::Vartype::INTEGER, 0, 50);
+
+        AND_GIVEN("A 2xv + 4v <= 20 constraint") {
+            auto& c = cqm.constraint_ref(cqm.add_constraint());
+            c.set_quadratic(x, v, 2);
+            c.set_linear(v, 4);
+            c.set_sense(dimod::Sense::LE);
+            c.set_rhs(20);
+
+            WHEN("We apply domain propagation") {
+                auto pre = PresolverImpl(cqm);
+                CHECK(pre.technique_domain_propagation(pre.model().constraint_ref(0)));
+
+                THEN("The upper bound of v is updated using the interval of 2x") {
+                    CHECK(pre.model().lower_bound(x) == 0.0);
+                    CHECK(pre.model().upper_bound(x) == 1.0);
+                    CHECK(pre.model().lower_bound(v) == 0.0);
+                    CHECK(pre.model().upper_bound(v) == 5.0);
+                    CHECK(pre.feasibility() == presolve::Feasibility::Unknown);
+                }
+            }
+        }
+    }
+
+    GIVEN("A CQM with a binary variable x and an integer variable v in [-50, 50]") {
+        auto cqm = ConstrainedQuadraticModel();
+        auto x = cqm.add_variable(dimod::Vartype::BINARY);
+        auto v = cqm.add_variable(dimod::Vartype::INTEGER, -50, 50);
+
+        AND_GIVEN("A 2xv + 4v <= 20 constraint") {
+            auto& c = cqm.constraint_ref(cqm.add_constraint());
+            c.set_quadratic(x, v, 2);
+            c.set_linear(v, 4);
+            c.set_sense(dimod::Sense::LE);
+            c.set_rhs(20);
+
+            WHEN("We apply domain propagation") {
+                auto pre = PresolverImpl(cqm);
+                CHECK(!pre.technique_domain_propagation(pre.model().constraint_ref(0)));
+
+                THEN("v is not tightened because it can be negative") {
+                    CHECK(pre.model().lower_bound(x) == 0.0);
+                    CHECK(pre.model().upper_bound(x) == 1.0);
+                    CHECK(pre.model().lower_bound(v) == -50.0);
+                    CHECK(pre.model().upper_bound(v) == 50.0);
+                }
+            }
+        }
+    }
+
     GIVEN("A CQM with an equality constraint over two binary variables") {
         auto cqm = ConstrainedQuadraticModel();
         auto x = cqm.add_variable(dimod::Vartype::BINARY);
@@ -869,6 +1436,119 @@ TEST_CASE("Test technique_domain_propagation", "[presolve][impl]") {
     }
 }
 
+TEST_CASE("Test technique_remove_parallel_constraints", "[presolve][impl]") {
+    GIVEN("A CQM with parallel inequality constraints") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, 3, 0, 10);
+        auto c0 = cqm.add_linear_constraint({0, 1}, {1, 2}, dimod::Sense::LE, 10);
+        auto c1 = cqm.add_linear_constraint({1, 0}, {4, 2}, dimod::Sense::LE, 12);
+        auto c2 = cqm.add_linear_constraint({0, 1}, {-1, -2}, dimod::Sense::LE, -1);
+        auto c3 = cqm.add_linear_constraint({0, 1, 2}, {1, 2, 1}, dimod::Sense::LE, 5);
+        auto c4 = cqm.add_linear_constraint({0, 1}, {3, 6}, dimod::Sense::LE, 30);
+        cqm.constraint_ref(c4).set_weight(5);
+
+        for (int num_threads : {1, 2}) {
+            WHEN("We remove parallel constraints with " + std::to_string(num_threads) +
+                 " threads") {
+                auto pre = PresolverImpl(cqm);
+                pre.num_threads = num_threads;
+                CHECK(pre.technique_remove_parallel_constraints());
+
+                THEN("only the tightest upper and lower bounds on x + 2y are kept") {
+                    CHECK(pre.model().constraint_ref(c0).num_variables() == 0);
+                    CHECK(pre.model().constraint_ref(c1).num_variables() == 2);
+                    CHECK(pre.model().constraint_ref(c1).rhs() == 12);
+                    CHECK(pre.model().constraint_ref(c2).num_variables() == 2);
+                    CHECK(pre.model().constraint_ref(c3).num_variables() == 3);
+                    CHECK(pre.model().constraint_ref(c4).num_variables() == 2);  // soft
+                    CHECK(pre.feasibility() == presolve::Feasibility::Unknown);
+                }
+            }
+        }
+
+        WHEN("We presolve with only RemoveParallelConstraints") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::RemoveParallelConstraints;
+            pre.apply();
+
+            THEN("the duplicate is removed from the model") {
+                CHECK(pre.model().num_constraints() == 4);
+                CHECK(pre.statistics().remove_parallel_constraints.num_calls == 1);
+                CHECK(pre.statistics().remove_parallel_constraints.num_changes == 1);
+            }
+        }
+    }
+
+    GIVEN("A CQM with an equality constraint and a parallel inequality") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, 2, 0, 10);
+        auto c0 = cqm.add_linear_constraint({0, 1}, {2, 2}, dimod::Sense::LE, 10);
+        auto c1 = cqm.add_linear_constraint({0, 1}, {1, 1}, dimod::Sense::EQ, 2);
+
+        WHEN("We remove parallel constraints") {
+            auto pre = PresolverImpl(cqm);
+            CHECK(pre.technique_remove_parallel_constraints());
+
+            THEN("only the equality is kept") {
+                CHECK(pre.model().constraint_ref(c0).num_variables() == 0);
+                CHECK(pre.model().constraint_ref(c1).num_variables() == 2);
+                CHECK(pre.model().constraint_ref(c1).sense() == dimod::Sense::EQ);
+            }
+        }
+    }
+
+    GIVEN("A CQM with a discrete constraint and duplicates of it that come first") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::BINARY, 3);
+        auto c0 = cqm.add_linear_constraint({0, 1, 2}, {1, 1, 1}, dimod::Sense::EQ, 1);
+        auto c1 = cqm.add_linear_constraint({2, 1, 0}, {2, 2, 2}, dimod::Sense::EQ, 2);
+        auto c2 = cqm.add_linear_constraint({0, 1, 2}, {1, 1, 1}, dimod::Sense::EQ, 1);
+        cqm.constraint_ref(c2).mark_discrete();
+
+        WHEN("We remove parallel constraints") {
+            auto pre = PresolverImpl(cqm);
+            CHECK(pre.technique_remove_parallel_constraints());
+
+            THEN("the discrete constraint is the one kept") {
+                CHECK(pre.model().constraint_ref(c0).num_variables() == 0);
+                CHECK(pre.model().constraint_ref(c1).num_variables() == 0);
+                CHECK(pre.model().constraint_ref(c2).num_variables() == 3);
+                CHECK(pre.model().constraint_ref(c2).marked_discrete());
+            }
+        }
+
+        WHEN("We presolve with only RemoveParallelConstraints") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::RemoveParallelConstraints;
+            pre.apply();
+
+            THEN("the model keeps one constraint and it is still discrete") {
+                REQUIRE(pre.model().num_constraints() == 1);
+                CHECK(pre.model().constraint_ref(0).marked_discrete());
+                CHECK(pre.model().constraint_ref(0).is_onehot());
+            }
+        }
+    }
+
+    GIVEN("A CQM with parallel constraints that contradict each other") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::REAL, 2, -10, 10);
+        cqm.add_linear_constraint({0, 1}, {1, 1}, dimod::Sense::LE, 1);
+        cqm.add_linear_constraint({0, 1}, {-2, -2}, dimod::Sense::LE, -4);
+
+        WHEN("We remove parallel constraints") {
+            auto pre = PresolverImpl(cqm);
+            CHECK(!pre.technique_remove_parallel_constraints());
+
+            THEN("the model is infeasible and the constraints are kept") {
+                CHECK(pre.feasibility() == presolve::Feasibility::Infeasible);
+                CHECK(pre.model().constraint_ref(0).num_variables() == 2);
+                CHECK(pre.model().constraint_ref(1).num_variables() == 2);
+            }
+        }
+    }
+}
+
 TEST_CASE("Test technique_remove_small_biases", "[presolve][impl]") {
     GIVEN("A linear CQM with small biases") {
         auto cqm = ConstrainedQuadraticModel();
@@ -986,4 +1666,223 @@ TEST_CASE("Test technique_remove_small_biases", "[presolve][impl]") {
         }
     }
 }
+
+TEST_CASE("Test technique_roof_duality", "[presolve][impl]") {
+    GIVEN("A CQM with binary variables in and out of the constraints") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::BINARY, 5);
+        auto i = cqm.add_variable(dimod::Vartype::INTEGER, 0, 5);
+
+        // x0 and x1 are in no constraint and only interact with each other
+        cqm.objective.set_linear(0, -1);
+        cqm.objective.set_linear(1, 1);
+        cqm.objective.set_quadratic(0, 1, 0.5);
+
+        // x2 is in a constraint
+        cqm.objective.set_linear(2, -1);
+        cqm.add_linear_constraint({2, i}, {1, 1}, dimod::Sense::LE, 3);
+
+        // x3 interacts with an integer variable and x4 interacts with x3
+        cqm.objective.set_quadratic(3, i, 1);
+        cqm.objective.set_linear(3, -1);
+        cqm.objective.set_quadratic(3, 4, -1);
+        cqm.objective.set_linear(4, -1);
+
+        WHEN("We presolve with the default techniques") {
+            auto pre = PresolverImpl(cqm);
+            pre.apply();
+
+            THEN("roof duality is not run") {
+                CHECK(pre.model().num_variables() == 6);
+                CHECK(pre.statistics().roof_duality.num_calls == 0);
+            }
+        }
+
+        WHEN("We presolve with roof duality") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::RoofDuality;
+            pre.apply();
+
+            THEN("only the variables of the independent part of the objective are fixed") {
+                CHECK(pre.model().num_variables() == 4);
+                CHECK(pre.model().num_constraints() == 1);
+                CHECK(pre.statistics().num_variables_fixed == 2);
+                CHECK(pre.statistics().roof_duality.num_calls == 1);
+                CHECK(pre.statistics().roof_duality.num_changes == 1);
+            }
+
+            THEN("We can restore samples") {
+                CHECK(pre.restore(std::vector<double>{1, 0, 1, 2}) ==
+                      std::vector<double>{1, 0, 1, 0, 1, 2});
+            }
+        }
+    }
+}
+
+TEST_CASE("Test technique_probing", "[presolve][impl]") {
+    GIVEN("A CQM where x0 == 0 is infeasible but no single constraint shows it") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::BINARY, 3);
+        cqm.add_linear_constraint({0, 1}, {1, 1}, dimod::Sense::GE, 1);
+        cqm.add_linear_constraint({0, 2}, {1, 1}, dimod::Sense::GE, 1);
+        cqm.add_linear_constraint({1, 2}, {1, 1}, dimod::Sense::LE, 1);
+
+        WHEN("We presolve with the default techniques") {
+            auto pre = PresolverImpl(cqm);
+            pre.apply();
+
+            THEN("nothing is fixed") {
+                CHECK(pre.model().num_variables() == 3);
+                CHECK(pre.statistics().probing.num_calls == 0);
+                CHECK(pre.implications().empty());
+            }
+        }
+
+        WHEN("We presolve with probing") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::Default | presolve::TechniqueFlags::Probing;
+            pre.apply();
+
+            THEN("x0 is fixed to 1 and the constraints it satisfies are removed") {
+                CHECK(pre.feasibility() != presolve::Feasibility::Infeasible);
+                CHECK(pre.model().num_variables() == 2);
+                CHECK(pre.model().num_constraints() == 1);
+                CHECK(pre.statistics().num_variables_fixed == 1);
+                CHECK(pre.statistics().probing.num_calls == 3);
+                CHECK(pre.statistics().probing.num_changes == 1);
+                CHECK(pre.restore(std::vector<double>{0, 1}) == std::vector<double>{1, 0, 1});
+            }
+
+            THEN("the time spent probing is not counted in the rounds as well") {
+                const auto& statistics = pre.statistics();
+                CHECK(statistics.probing.time.count() > 0);
+                CHECK(statistics.total().time + statistics.probing.time <= statistics.time);
+            }
+
+            THEN("the implications of x1 and x2 are kept, relabelled") {
+                CHECK(pre.statistics().num_implications == 2);
+                const auto& implications = pre.implications();
+                REQUIRE(implications.num_variables() == 2);
+                CHECK(implications.implications(0, false).empty());
+                REQUIRE(implications.implications(0, true).size() == 1);
+                CHECK(implications.implications(0, true)[0].v == 1);
+                CHECK(implications.implications(0, true)[0].upper);
+                CHECK(implications.implications(0, true)[0].bound == 0);
+            }
+        }
+    }
+
+    GIVEN("A CQM where each value of x0 implies a different bound on i") {
+        auto cqm = ConstrainedQuadraticModel();
+        auto x = cqm.add_variable(dimod::Vartype::BINARY);
+        auto i = cqm.add_variable(dimod::Vartype::INTEGER, 0, 10);
+        cqm.add_linear_constraint({i, x}, {1, -7}, dimod::Sense::LE, 3);  // x == 0 => i <= 3
+        cqm.add_linear_constraint({i, x}, {1, 5}, dimod::Sense::LE, 10);  // x == 1 => i <= 5
+
+        WHEN("We presolve with probing") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::Default | presolve::TechniqueFlags::Probing;
+            pre.apply();
+
+            THEN("the weaker of the two bounds holds either way") {
+                CHECK(pre.model().num_variables() == 2);
+                CHECK(pre.model().lower_bound(i) == 0);
+                CHECK(pre.model().upper_bound(i) == 5);
+                CHECK(pre.statistics().probing.num_changes == 1);
+            }
+
+            THEN("the bound implied by each value is recorded") {
+                const auto& implications = pre.implications();
+                REQUIRE(implications.implications(x, false).size() == 1);
+                CHECK(implications.implications(x, false)[0].v == i);
+                CHECK(implications.implications(x, false)[0].upper);
+                CHECK(implications.implications(x, false)[0].bound == 3);
+                REQUIRE(implications.implications(x, true).size() == 1);
+                CHECK(implications.implications(x, true)[0].bound == 5);
+            }
+        }
+    }
+
+    GIVEN("A CQM where both values of x0 are infeasible") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::BINARY, 5);
+        // x0 == 0 forces x1 == x2 == 1
+        cqm.add_linear_constraint({0, 1}, {1, 1}, dimod::Sense::GE, 1);
+        cqm.add_linear_constraint({0, 2}, {1, 1}, dimod::Sense::GE, 1);
+        cqm.add_linear_constraint({1, 2}, {1, 1}, dimod::Sense::LE, 1);
+        // x0 == 1 forces x3 == x4 == 0
+        cqm.add_linear_constraint({0, 3}, {1, 1}, dimod::Sense::LE, 1);
+        cqm.add_linear_constraint({0, 4}, {1, 1}, dimod::Sense::LE, 1);
+        cqm.add_linear_constraint({3, 4}, {1, 1}, dimod::Sense::GE, 1);
+
+        WHEN("We presolve with the default techniques") {
+            auto pre = PresolverImpl(cqm);
+            pre.apply();
+
+            THEN("the model is not known to be infeasible") {
+                CHECK(pre.feasibility() != presolve::Feasibility::Infeasible);
+            }
+        }
+
+        WHEN("We presolve with probing") {
+            auto pre = PresolverImpl(cqm);
+            pre.techniques = presolve::TechniqueFlags::Default | presolve::TechniqueFlags::Probing;
+            pre.apply();
+
+            THEN("the model is infeasible") {
+                CHECK(pre.feasibility() == presolve::Feasibility::Infeasible);
+                CHECK(pre.statistics().probing.num_calls == 1);
+            }
+        }
+    }
+
+    GIVEN("A CQM with one variable in more constraints than the others") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::BINARY, 4);
+        for (int v = 0; v < 3; ++v) {
+            cqm.add_linear_constraint({v, 3}, {1, 1}, dimod::Sense::LE, 1);
+        }
+
+        auto pre = PresolverImpl(cqm);
+        pre.techniques = presolve::TechniqueFlags::Default | presolve::TechniqueFlags::Probing;
+        pre.normalize();
+
+        // Each visit to a constraint costs 3. Probing both values of x3 visits its
+        // three constraints twice, which is the whole budget, while probing x0 takes
+        // five visits and leaves one for x1.
+        pre.probing_work_limit = 18;
+
+        WHEN("We probe the most constrained variables first") {
+            pre.presolve();
+
+            THEN("only x3 is probed") {
+                CHECK(pre.statistics().probing.num_calls == 1);
+                CHECK(pre.implications().implications(3, true).size() == 3);
+                CHECK(pre.implications().implications(0, true).empty());
+            }
+        }
+
+        WHEN("We probe the variables in index order") {
+            pre.probing_order = presolve::ProbingOrder::IndexOrder;
+            pre.presolve();
+
+            THEN("x0 is probed and x1 only gets what is left of the budget") {
+                CHECK(pre.statistics().probing.num_calls == 2);
+                CHECK(pre.implications().implications(0, true).size() == 1);
+                CHECK(pre.implications().implications(1, true).empty());
+                CHECK(pre.implications().implications(3, true).empty());
+            }
+        }
+
+        WHEN("We don't limit the work") {
+            pre.probing_work_limit = std::numeric_limits<std::size_t>::max();
+            pre.presolve();
+
+            THEN("every variable is probed") {
+                CHECK(pre.statistics().probing.num_calls == 4);
+                CHECK(pre.statistics().num_implications == 6);
+            }
+        }
+    }
+}
 }  // namespace dwave
@@ -0,0 +1,160 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "dimod/constrained_quadratic_model.h"
+#include "dwave/presolve.hpp"
+#include "dwave/restorer.hpp"
+
+namespace dwave {
+
+using Presolver = presolve::Presolver<double, int, double>;
+using Restorer = presolve::Restorer;
+using ConstrainedQuadraticModel = dimod::ConstrainedQuadraticModel<double, int>;
+
+TEST_CASE("Restorer construction", "[restorer]") {
+    GIVEN("An empty restorer") {
+        auto restorer = Restorer();
+
+        THEN("It has no variables") {
+            CHECK(restorer.num_original_variables() == 0);
+            CHECK(restorer.num_reduced_variables() == 0);
+            CHECK(restorer.restore({}).empty());
+        }
+
+        THEN("It can be serialized and loaded") {
+            auto other = Restorer(restorer.serialize());
+            CHECK(other.num_original_variables() == 0);
+        }
+    }
+
+    GIVEN("Bytes that are not a serialized restorer") {
+        THEN("Loading them throws") {
+            CHECK_THROWS_AS(Restorer(std::string()), std::invalid_argument);
+            CHECK_THROWS_AS(Restorer(std::string(64, 'a')), std::invalid_argument);
+        }
+    }
+
+    GIVEN("A serialized restore plan") {
+        // original = [5, 2 * r1 + 1, r0]
+        auto data = Restorer::serialize(2, {5, 1, 0}, {1, 2}, {1, 0}, {2, 1});
+
+        THEN("It can be loaded and used") {
+            auto restorer = Restorer(data);
+            CHECK(restorer.num_original_variables() == 3);
+            CHECK(restorer.num_reduced_variables() == 2);
+            CHECK(restorer.restore({3, 4}) == std::vector<double>{5, 9, 3});
+            CHECK_THROWS_AS(restorer.restore({3}), std::invalid_argument);
+        }
+
+        THEN("It can be viewed without being copied") {
+            auto restorer = Restorer::view(data.data(), data.size());
+            CHECK(restorer.restore({3, 4}) == std::vector<double>{5, 9, 3});
+            CHECK(restorer.serialize() == data);
+        }
+
+        THEN("Truncating it makes it invalid") {
+            CHECK_THROWS_AS(Restorer(data.substr(0, data.size() - 8)), std::invalid_argument);
+        }
+
+        THEN("Changing the version makes it invalid") {
+            data[8] = 100;
+            CHECK_THROWS_AS(Restorer(data), std::invalid_argument);
+        }
+
+        THEN("An out-of-range index makes it invalid") {
+            data[40 + 3 * 8] = 3;  // gather_original[0] = 3
+            CHECK_THROWS_AS(Restorer(data), std::invalid_argument);
+        }
+    }
+
+    GIVEN("An inconsistent restore plan") {
+        THEN("Serializing it throws") {
+            CHECK_THROWS_AS(Restorer::serialize(2, {0, 0}, {0, 1}, {0}, {1, 1}),
+                            std::invalid_argument);
+            CHECK_THROWS_AS(Restorer::serialize(1, {0, 0}, {0, 1}, {0, 1}, {1, 1}),
+                            std::invalid_argument);
+        }
+    }
+}
+
+TEST_CASE("Restorer can restore samples of a presolved model", "[restorer]") {
+    GIVEN("A presolved CQM with fixed and spin variables") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variables(dimod::Vartype::INTEGER, 2);
+        auto s = cqm.add_variable(dimod::Vartype::SPIN);
+        cqm.add_variable(dimod::Vartype::INTEGER, 3, 3);  // fixed at 3
+        cqm.objective.set_linear(0, 1);
+        cqm.objective.set_quadratic(1, s, 2);
+        cqm.add_linear_constraint({0, 1}, {1, 1}, dimod::Sense::LE, 5);
+
+        auto pre = Presolver(cqm);
+        pre.normalize();
+        pre.presolve();
+
+        const auto num_reduced = pre.model().num_variables();
+        REQUIRE(num_reduced == 3);
+
+        WHEN("We serialize the restore information and load it into a restorer") {
+            auto restorer = Restorer(pre.serialize_restore());
+
+            THEN("It restores samples the same way as the presolver") {
+                CHECK(restorer.num_original_variables() == 4);
+                CHECK(restorer.num_reduced_variables() == num_reduced);
+
+                for (std::vector<double> sample :
+                     {std::vector<double>{0, 0, 0}, {1, 2, 1}, {4, 1, 0}}) {
+                    CHECK(restorer.restore(sample) == pre.restore(sample));
+                }
+
+                std::vector<double> reduced = {1, 2, 1, 4, 1, 0};
+                std::vector<double> original(8);
+                restorer.restore_batch(reduced.data(), 2, original.data());
+                CHECK(original == std::vector<double>{1, 2, 1, 3, 4, 1, -1, 3});
+
+                // the samples do not need to be doubles
+                std::vector<std::int64_t> reduced_int(reduced.begin(), reduced.end());
+                std::vector<double> original_int(8);
+                restorer.restore_batch(reduced_int.data(), 2, original_int.data());
+                CHECK(original_int == original);
+
+                pre.set_num_threads(2);
+                pre.restore_batch(reduced_int.data(), 2, original_int.data());
+                CHECK(original_int == original);
+            }
+        }
+    }
+
+    GIVEN("A normalized CQM that has not been presolved") {
+        auto cqm = ConstrainedQuadraticModel();
+        cqm.add_variable(dimod::Vartype::SPIN);
+        cqm.add_variable(dimod::Vartype::BINARY);
+
+        auto pre = Presolver(cqm);
+        pre.normalize();
+
+        THEN("The restorer undoes the normalization") {
+            auto restorer = Restorer(pre.serialize_restore());
+            CHECK(restorer.restore({0, 1}) == std::vector<double>{-1, 1});
+            CHECK(restorer.restore({1, 0}) == pre.restore({1, 0}));
+        }
+    }
+}
+
+}  // namespace dwave
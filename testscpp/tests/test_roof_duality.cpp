@@ -12,6 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
 #include <dimod/quadratic_model.h>
 
 #include "catch2/catch.hpp"
@@ -136,6 +143,141 @@ TEST_CASE("Tests for fixQuboVariables", "[roofduality]") {
         }
     }
 
+    SECTION("Test 32-bit capacities") {
+        float Q[16] = {1, -3, 2, 0, 0, -1, 4, -2, 0, 0, 2, 3, 0, 0, 0, -5};
+
+        int num_vars = 4;
+        auto bqm = dimod::BinaryQuadraticModel<float, int>(Q, num_vars, dimod::Vartype::BINARY);
+
+        for (auto mode : {true, false}) {
+            auto result = fixQuboVariables(bqm, mode);
+            auto result32 = fixQuboVariables<int, float, std::int32_t>(bqm, mode);
+
+            REQUIRE(result32.first == Approx(result.first));
+            REQUIRE(result32.second == result.second);
+        }
+    }
+
+#ifdef __SIZEOF_INT128__
+    SECTION("Test 128-bit capacities are used for a large dynamic range") {
+        // the bias of variable 1 is flushed to zero with 64-bit capacities
+        double Q[9] = {1e15, 0, 0, 0, 1e-5, -3e-5, 0, 0, 1e-5};
+
+        int num_vars = 3;
+        auto bqm = dimod::BinaryQuadraticModel<double, int>(Q, num_vars, dimod::Vartype::BINARY);
+
+        PosiformInfo<dimod::BinaryQuadraticModel<double, int>, capacity_type> posiform(bqm);
+        REQUIRE(needsWideCapacity(posiform));
+        std::vector<std::pair<int, int>> fixed_vars;
+        fixQuboVariables(posiform, num_vars, true, fixed_vars);
+        REQUIRE(fixed_vars == std::vector<std::pair<int, int>>{{0, 0}});
+
+        PosiformInfo<dimod::BinaryQuadraticModel<double, int>, wide_capacity_type> wide_posiform(
+                bqm);
+        REQUIRE(!needsWideCapacity(wide_posiform));
+
+        // x1 = x2 = 1 is the only minimum
+        auto result = fixQuboVariables(bqm, true);
+        REQUIRE(result.first == Approx(-1e-5));
+        REQUIRE(result.second == std::vector<std::pair<int, int>>{{1, 1}, {2, 1}, {0, 0}});
+
+        for (auto algorithm : {MaxFlowAlgorithm::PARALLEL_PUSH_RELABEL,
+                               MaxFlowAlgorithm::BOYKOV_KOLMOGOROV}) {
+            REQUIRE(fixQuboVariables(bqm, true, 0.0, algorithm) == result);
+        }
+
+        // a narrower capacity type asked for explicitly is kept
+        auto result32 = fixQuboVariables<int, double, std::int32_t>(bqm, true);
+        REQUIRE(result32.second == std::vector<std::pair<int, int>>{{0, 0}});
+    }
+#endif
+
+    SECTION("Test batch") {
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> bias(-10, 10);
+        std::uniform_real_distribution<double> density(0, 1);
+
+        std::vector<dimod::BinaryQuadraticModel<double, int>> bqms;
+        std::vector<double> offsets;
+        for (int num_vars : {0, 1, 30, 5, 100, 2, 60}) {
+            auto& bqm = bqms.emplace_back(num_vars, dimod::Vartype::BINARY);
+            for (int u = 0; u < num_vars; u++) {
+                bqm.set_linear(u, bias(rng));
+                for (int v = u + 1; v < num_vars; v++) {
+                    if (density(rng) < 0.2) bqm.add_quadratic(u, v, bias(rng));
+                }
+            }
+            offsets.push_back(bias(rng));
+        }
+        std::vector<dimod::BinaryQuadraticModel<double, int>*> pointers;
+        for (auto& bqm : bqms) {
+            pointers.push_back(&bqm);
+        }
+
+        for (bool strict : {true, false}) {
+            auto results = fixQuboVariablesBatch(pointers, strict, offsets, 4);
+            REQUIRE(results.size() == bqms.size());
+            for (std::size_t i = 0; i < bqms.size(); i++) {
+                REQUIRE(results[i] == fixQuboVariables(bqms[i], strict, offsets[i]));
+            }
+
+            results = fixQuboVariablesBatch(pointers, strict);
+            for (std::size_t i = 0; i < bqms.size(); i++) {
+                REQUIRE(results[i] == fixQuboVariables(bqms[i], strict));
+            }
+        }
+
+        REQUIRE_THROWS_AS(fixQuboVariablesBatch(pointers, true, {1.0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(fixQuboVariablesBatch(pointers, true, offsets, 0),
+                          std::invalid_argument);
+        REQUIRE(fixQuboVariablesBatch(
+                        std::vector<dimod::BinaryQuadraticModel<double, int>*>{}, true)
+                        .empty());
+    }
+
+    SECTION("Test a reused workspace gives the same results") {
+        std::mt19937 rng(9);
+        std::uniform_int_distribution<int> bias(-10, 10);
+        std::uniform_real_distribution<double> density(0, 1);
+
+        // sizes going up and down, so the buffers are both grown and reused
+        std::vector<dimod::BinaryQuadraticModel<double, int>> bqms;
+        for (int num_vars : {40, 3, 100, 0, 25, 100, 1}) {
+            auto& bqm = bqms.emplace_back(num_vars, dimod::Vartype::BINARY);
+            for (int u = 0; u < num_vars; u++) {
+                bqm.set_linear(u, bias(rng));
+                for (int v = u + 1; v < num_vars; v++) {
+                    if (density(rng) < 0.2) bqm.add_quadratic(u, v, bias(rng));
+                }
+            }
+        }
+
+        // the weak persistencies depend on the flow, which may differ from run
+        // to run with the parallel push-relabel
+        std::vector<std::pair<MaxFlowAlgorithm, bool>> runs = {
+                {MaxFlowAlgorithm::PUSH_RELABEL, true},
+                {MaxFlowAlgorithm::PUSH_RELABEL, false},
+                {MaxFlowAlgorithm::BOYKOV_KOLMOGOROV, true},
+                {MaxFlowAlgorithm::BOYKOV_KOLMOGOROV, false},
+                {MaxFlowAlgorithm::PARALLEL_PUSH_RELABEL, true}};
+
+        RoofDualityWorkspace<> workspace;
+        std::size_t capacity = 0;
+        for (auto [algorithm, strict] : runs) {
+            for (auto& bqm : bqms) {
+                auto result = fixQuboVariables(bqm, strict, 1.5, algorithm, &workspace);
+                REQUIRE(result == fixQuboVariables(bqm, strict, 1.5, algorithm));
+
+                // the buffers only grow
+                std::size_t new_capacity = workspace.network.bfs_depth_values.capacity();
+                REQUIRE(new_capacity >= capacity);
+                capacity = new_capacity;
+            }
+        }
+        REQUIRE(workspace.network.push_relabel.vertices.capacity() > 100);
+        REQUIRE(workspace.network.boykov_kolmogorov.trees.capacity() > 100);
+    }
+
     SECTION("Test from previously found bug (BugSAPI1311)") {
         float Q[4] = {2.2, -4.0, 0, 2.0};
 
@@ -224,4 +366,606 @@ TEST_CASE("Tests for PosiformInfo", "[roofduality]") {
     }
 }
 
+// A BQM given as a sorted edge list, read in chunks as if from a file.
+struct EdgeListStream {
+    using bias_type = double;
+
+    std::vector<double> linear_biases;
+    std::vector<std::tuple<int, int, double>> edges;
+    std::size_t chunk_size = 7;
+    int num_reads = 0;
+
+    int num_variables() { return linear_biases.size(); }
+
+    double linear(int variable) { return linear_biases[variable]; }
+
+    template <class Callback>
+    void forEachQuadratic(Callback callback) {
+        num_reads++;
+        std::vector<std::tuple<int, int, double>> chunk;
+        for (std::size_t start = 0; start < edges.size(); start += chunk_size) {
+            chunk.assign(edges.begin() + start,
+                         edges.begin() + std::min(start + chunk_size, edges.size()));
+            for (auto& [u, v, bias] : chunk) {
+                callback(u, v, bias);
+            }
+        }
+    }
+};
+
+TEST_CASE("Tests for StreamingPosiformInfo", "[roofduality]") {
+    SECTION("Test the same variables are fixed as from the BQM") {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<double> bias(-10, 10);
+        std::uniform_real_distribution<double> density(0, 1);
+
+        for (int num_vars : {1, 10, 50, 200}) {
+            auto bqm = dimod::BinaryQuadraticModel<double, int>(num_vars, dimod::Vartype::BINARY);
+            EdgeListStream stream;
+            for (int u = 0; u < num_vars; u++) {
+                // leave some variables out of the posiform
+                double linear = (density(rng) < 0.9) ? bias(rng) : 0;
+                bqm.set_linear(u, linear);
+                stream.linear_biases.push_back(linear);
+            }
+            for (int u = 0; u < num_vars; u++) {
+                for (int v = u + 1; v < num_vars; v++) {
+                    if (density(rng) < 0.05) {
+                        double quadratic = bias(rng);
+                        bqm.add_quadratic(u, v, quadratic);
+                        stream.edges.emplace_back(u, v, quadratic);
+                    }
+                }
+            }
+
+            for (bool strict : {true, false}) {
+                stream.num_reads = 0;
+                auto result = fixQuboVariablesFromStream(stream, strict);
+                REQUIRE(stream.num_reads == 3);
+                REQUIRE(result == fixQuboVariables(bqm, strict));
+            }
+        }
+    }
+
+    SECTION("Test all zero bias case") {
+        EdgeListStream stream;
+        stream.linear_biases = {0, 0, 0};
+        stream.edges = {{0, 2, 0}};
+
+        StreamingPosiformInfo<EdgeListStream, capacity_type> posiform(stream);
+        REQUIRE(posiform.getNumVariables() == 0);
+        REQUIRE(posiform.mapVariableQuboToPosiform(1) == -1);
+
+        auto result = fixQuboVariablesFromStream(stream, false, 1.5);
+        REQUIRE(result.first == 1.5);
+        REQUIRE(result.second.size() == 3);
+    }
+}
+
+TEST_CASE("Tests for ImplicationNetwork", "[roofduality]") {
+    SECTION("Test edges are stored per vertex") {
+        float Q[9] = {22, -4, 0, 0, 0, 4, 0, 0, -2};
+
+        int num_vars = 3;
+        auto bqm = dimod::BinaryQuadraticModel<float, int>(Q, num_vars, dimod::Vartype::BINARY);
+        PosiformInfo<dimod::BinaryQuadraticModel<float, int>, capacity_type> posiform(bqm);
+        ImplicationNetwork<capacity_type> network(posiform);
+
+        auto& adjacency_list = network.getAdjacencyList();
+        REQUIRE(adjacency_list.size() == static_cast<std::size_t>(2 * num_vars + 2));
+
+        // each of the 2 quadratic and 2 linear terms creates 4 edges
+        REQUIRE(adjacency_list.num_edges() == 16);
+        REQUIRE(adjacency_list[network.getSource()].size() == 2);
+        REQUIRE(adjacency_list[network.getSink()].size() == 2);
+
+        std::size_t num_edges = 0;
+        for (std::size_t vertex = 0; vertex < adjacency_list.size(); vertex++) {
+            for (auto& edge : adjacency_list[vertex]) {
+                REQUIRE(edge.from_vertex == static_cast<int>(vertex));
+                auto& reverse = adjacency_list[edge.to_vertex][edge.reverse_edge_index];
+                REQUIRE(reverse.to_vertex == edge.from_vertex);
+                REQUIRE(reverse.getCapacity() == edge.getReverseEdgeCapacity());
+                num_edges++;
+            }
+        }
+        REQUIRE(num_edges == adjacency_list.num_edges());
+    }
+
+    SECTION("Test the parallel push-relabel finds the same maximum flow") {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> bias(-10, 10);
+        std::uniform_real_distribution<double> density(0, 1);
+
+        for (int num_vars : {2, 10, 50, 200}) {
+            std::vector<float> Q(num_vars * num_vars, 0);
+            for (int u = 0; u < num_vars; u++) {
+                Q[u * num_vars + u] = bias(rng);
+                for (int v = u + 1; v < num_vars; v++) {
+                    if (density(rng) < 0.1) Q[u * num_vars + v] = bias(rng);
+                }
+            }
+            auto bqm = dimod::BinaryQuadraticModel<float, int>(Q.data(), num_vars,
+                                                                dimod::Vartype::BINARY);
+            PosiformInfo<dimod::BinaryQuadraticModel<float, int>, capacity_type> posiform(bqm);
+
+            ImplicationNetwork<capacity_type> serial(posiform);
+            std::vector<std::pair<int, int>> serial_fixed;
+            auto serial_flow = serial.fixVariables(serial_fixed, true);
+
+            ImplicationNetwork<capacity_type> parallel(posiform);
+            std::vector<std::pair<int, int>> parallel_fixed;
+            auto parallel_flow = parallel.fixVariables(parallel_fixed, true,
+                                                       MaxFlowAlgorithm::PARALLEL_PUSH_RELABEL);
+
+            auto result = isMaximumFlow(parallel.getAdjacencyList(), parallel.getSource(),
+                                        parallel.getSink());
+            REQUIRE(result.second);
+            REQUIRE(result.first == parallel_flow);
+            REQUIRE(parallel_flow == serial_flow);
+
+            // the strong persistencies do not depend on which maximum flow is found
+            std::sort(serial_fixed.begin(), serial_fixed.end());
+            std::sort(parallel_fixed.begin(), parallel_fixed.end());
+            REQUIRE(parallel_fixed == serial_fixed);
+
+            // non-strict mode gives the same lower bound
+            ImplicationNetwork<capacity_type> weak(posiform);
+            std::vector<std::pair<int, int>> weak_fixed;
+            REQUIRE(weak.fixVariables(weak_fixed, false,
+                                      MaxFlowAlgorithm::PARALLEL_PUSH_RELABEL) == serial_flow);
+        }
+    }
+
+    SECTION("Test Boykov-Kolmogorov finds the same maximum flow") {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> bias(-10, 10);
+        std::uniform_real_distribution<double> density(0, 1);
+
+        for (int num_vars : {2, 10, 50, 200}) {
+            std::vector<float> Q(num_vars * num_vars, 0);
+            for (int u = 0; u < num_vars; u++) {
+                Q[u * num_vars + u] = bias(rng);
+                for (int v = u + 1; v < num_vars; v++) {
+                    if (density(rng) < 0.1) Q[u * num_vars + v] = bias(rng);
+                }
+            }
+            auto bqm = dimod::BinaryQuadraticModel<float, int>(Q.data(), num_vars,
+                                                                dimod::Vartype::BINARY);
+            PosiformInfo<dimod::BinaryQuadraticModel<float, int>, capacity_type> posiform(bqm);
+
+            ImplicationNetwork<capacity_type> serial(posiform);
+            std::vector<std::pair<int, int>> serial_fixed;
+            auto serial_flow = serial.fixVariables(serial_fixed, true);
+
+            ImplicationNetwork<capacity_type> network(posiform);
+            std::vector<std::pair<int, int>> fixed;
+            auto flow = network.fixVariables<BoykovKolmogorovSolver>(fixed, true);
+
+            auto result = isMaximumFlow(network.getAdjacencyList(), network.getSource(),
+                                        network.getSink());
+            REQUIRE(result.second);
+            REQUIRE(result.first == flow);
+            REQUIRE(flow == serial_flow);
+
+            std::sort(serial_fixed.begin(), serial_fixed.end());
+            std::sort(fixed.begin(), fixed.end());
+            REQUIRE(fixed == serial_fixed);
+
+            // the same through the enum, in non-strict mode
+            ImplicationNetwork<capacity_type> weak(posiform);
+            std::vector<std::pair<int, int>> weak_fixed;
+            REQUIRE(weak.fixVariables(weak_fixed, false,
+                                      MaxFlowAlgorithm::BOYKOV_KOLMOGOROV) == serial_flow);
+
+            // sparse networks pick Boykov-Kolmogorov
+            ImplicationNetwork<capacity_type> automatic(posiform);
+            if (num_vars <= 50) {
+                REQUIRE(automatic.selectMaxFlowAlgorithm() ==
+                        MaxFlowAlgorithm::BOYKOV_KOLMOGOROV);
+            }
+
+            auto lower_bound = fixQuboVariables(bqm, true).first;
+            auto automatic_result =
+                    fixQuboVariables(bqm, true, 0.0, MaxFlowAlgorithm::AUTOMATIC);
+            REQUIRE(automatic_result.first == Approx(lower_bound));
+        }
+    }
+
+    SECTION("Test automatic selection of the maximum flow algorithm on a dense network") {
+        int num_vars = 40;
+        std::vector<float> Q(num_vars * num_vars, 0);
+        for (int u = 0; u < num_vars; u++) {
+            Q[u * num_vars + u] = (u % 3) - 1;
+            for (int v = u + 1; v < num_vars; v++) {
+                Q[u * num_vars + v] = ((u + v) % 2) ? 1 : -1;
+            }
+        }
+        auto bqm = dimod::BinaryQuadraticModel<float, int>(Q.data(), num_vars,
+                                                            dimod::Vartype::BINARY);
+        PosiformInfo<dimod::BinaryQuadraticModel<float, int>, capacity_type> posiform(bqm);
+        ImplicationNetwork<capacity_type> network(posiform);
+        REQUIRE(network.selectMaxFlowAlgorithm() == MaxFlowAlgorithm::PUSH_RELABEL);
+    }
+
+    SECTION("Test compact edges") {
+        REQUIRE(sizeof(ImplicationEdge<std::int32_t, true>) <
+                sizeof(ImplicationEdge<std::int32_t>));
+        REQUIRE(sizeof(ImplicationEdge<std::int32_t, true>) < sizeof(ImplicationEdge<capacity_type>));
+
+        float Q[9] = {22, -4, 0, 0, 0, 4, 0, 0, -2};
+
+        auto bqm = dimod::BinaryQuadraticModel<float, int>(Q, 3, dimod::Vartype::BINARY);
+        PosiformInfo<dimod::BinaryQuadraticModel<float, int>, std::int32_t> posiform(bqm);
+        ImplicationNetwork<std::int32_t, true> network(posiform);
+
+        std::vector<std::pair<int, int>> fixed_variables;
+        auto max_flow = network.fixVariables(fixed_variables, true);
+
+        auto result = isMaximumFlow(network.getAdjacencyList(), network.getSource(),
+                                    network.getSink());
+        REQUIRE(result.second);
+        REQUIRE(result.first == max_flow);
+        REQUIRE(fixed_variables.size() == 3);
+    }
+
+    SECTION("Test changing the coefficients keeps the flow valid") {
+        float Q[16] = {1, -3, 2, 0, 0, -1, 4, -2, 0, 0, 2, 3, 0, 0, 0, -5};
+
+        auto bqm = dimod::BinaryQuadraticModel<float, int>(Q, 4, dimod::Vartype::BINARY);
+        PosiformInfo<dimod::BinaryQuadraticModel<float, int>, capacity_type> posiform(bqm);
+        ImplicationNetwork<capacity_type> network(posiform, true);
+
+        std::vector<std::pair<int, int>> fixed_variables;
+        network.fixVariables(fixed_variables, false);
+
+        // the linear coefficient of the first variable is negative
+        REQUIRE(posiform.getLinear(0) < 0);
+        REQUIRE(!network.setLinearCoefficient(0, 1));
+        REQUIRE(network.setLinearCoefficient(0, posiform.getLinear(0) / 2));
+        REQUIRE(network.setQuadraticCoefficient(1, 0, 0));
+
+        auto result = isMaximumFlow(network.getAdjacencyList(), network.getSource(),
+                                    network.getSink());
+        REQUIRE(result.second);
+
+        fixed_variables.clear();
+        auto max_flow = network.fixVariables(fixed_variables, true);
+        result = isMaximumFlow(network.getAdjacencyList(), network.getSource(),
+                               network.getSink());
+        REQUIRE(result.second);
+        REQUIRE(result.first == max_flow);
+    }
+
+    SECTION("Test cancelling flow uses the workspace and detects an invalid flow") {
+        float Q[16] = {1, -3, 2, 0, 0, -1, 4, -2, 0, 0, 2, 3, 0, 0, 0, -5};
+
+        auto bqm = dimod::BinaryQuadraticModel<float, int>(Q, 4, dimod::Vartype::BINARY);
+        PosiformInfo<dimod::BinaryQuadraticModel<float, int>, capacity_type> posiform(bqm);
+
+        {
+            std::mt19937 rng(3);
+            std::uniform_real_distribution<double> bias(-10, 10);
+            auto frustrated = dimod::BinaryQuadraticModel<double, int>(20, dimod::Vartype::BINARY);
+            for (int u = 0; u < 20; u++) {
+                frustrated.set_linear(u, bias(rng));
+                for (int v = u + 1; v < 20; v++) {
+                    if (rng() % 4 == 0) frustrated.add_quadratic(u, v, bias(rng));
+                }
+            }
+            PosiformInfo<dimod::BinaryQuadraticModel<double, int>, capacity_type> frustrated_posiform(
+                    frustrated);
+
+            ImplicationNetwork<capacity_type> network(frustrated_posiform, true);
+            std::vector<std::pair<int, int>> fixed_variables;
+            REQUIRE(network.fixVariables(fixed_variables, false) > 0);
+
+            // all of the flow leaves the source through the linear terms
+            ImplicationNetwork<capacity_type>::workspace_t workspace;
+            for (int variable = 0; variable < frustrated_posiform.getNumVariables(); variable++) {
+                REQUIRE(network.setLinearCoefficient(variable, 0, &workspace));
+            }
+            REQUIRE(isMaximumFlow(network.getAdjacencyList(), network.getSource(),
+                                  network.getSink())
+                            .second);
+
+            // the parents are left unvisited for the next search
+            auto& parents = workspace.cancel_parents;
+            REQUIRE(parents.size() == network.getAdjacencyList().size());
+            REQUIRE(std::count(parents.begin(), parents.end(), -1) ==
+                    static_cast<std::ptrdiff_t>(parents.size()));
+        }
+
+        {
+            // flow out of the source that goes nowhere, so it is on no cycle
+            ImplicationNetwork<capacity_type> network(posiform, true);
+            auto& adjacency_list = network.getAdjacencyList();
+            for (auto& edge : adjacency_list[network.getSource()]) {
+                auto& reverse_edge = adjacency_list[edge.to_vertex][edge.reverse_edge_index];
+                reverse_edge.residual += edge.residual;
+                edge.residual = 0;
+            }
+
+            REQUIRE(!network.setLinearCoefficient(0, posiform.getLinear(0) / 2));
+        }
+    }
+
+    SECTION("Test the flow is a maximum flow") {
+        float Q[16] = {1, -3, 2, 0, 0, -1, 4, -2, 0, 0, 2, 3, 0, 0, 0, -5};
+
+        int num_vars = 4;
+        auto bqm = dimod::BinaryQuadraticModel<float, int>(Q, num_vars, dimod::Vartype::BINARY);
+        PosiformInfo<dimod::BinaryQuadraticModel<float, int>, capacity_type> posiform(bqm);
+        ImplicationNetwork<capacity_type> network(posiform);
+
+        std::vector<std::pair<int, int>> fixed_variables;
+        auto max_flow = network.fixVariables(fixed_variables, true);
+
+        auto result = isMaximumFlow(network.getAdjacencyList(), network.getSource(),
+                                    network.getSink());
+        REQUIRE(result.second);
+        REQUIRE(result.first == max_flow);
+    }
+}
+
+// Random directed graphs, from very sparse ones with mostly trivial components
+// to ones with a large component.
+std::vector<std::vector<std::vector<int>>> randomGraphs() {
+    std::mt19937 gen(7);
+    std::vector<std::vector<std::vector<int>>> graphs;
+    for (int num_vertices : {1, 10, 100, 1000}) {
+        for (double average_degree : {0.5, 1.0, 2.0, 5.0}) {
+            std::uniform_int_distribution<int> vertex_dist(0, num_vertices - 1);
+            std::vector<std::vector<int>> adjacency_list(num_vertices);
+            int num_edges = average_degree * num_vertices;
+            for (int i = 0; i < num_edges; i++) {
+                adjacency_list[vertex_dist(gen)].push_back(vertex_dist(gen));
+            }
+            graphs.push_back(adjacency_list);
+        }
+    }
+    return graphs;
+}
+
+compressed_adjacency_list<int> compress(std::vector<std::vector<int>>& adjacency_list) {
+    std::vector<std::size_t> degrees;
+    for (auto& out_edges : adjacency_list) {
+        degrees.push_back(out_edges.size());
+    }
+    compressed_adjacency_list<int> compressed(degrees);
+    for (std::size_t vertex = 0; vertex < adjacency_list.size(); vertex++) {
+        for (int to_vertex : adjacency_list[vertex]) {
+            compressed.emplace_back(vertex, to_vertex);
+        }
+    }
+    compressed.finalize();
+    return compressed;
+}
+
+TEST_CASE("Tests for the graph algorithms", "[roofduality]") {
+    auto graphs = randomGraphs();
+
+    SECTION("Test compressed adjacency lists written in place") {
+        // Enough vertices for the offsets to be summed in several blocks.
+        std::size_t num_vertices = 200000;
+        std::vector<std::size_t> degrees(num_vertices);
+        for (std::size_t vertex = 0; vertex < num_vertices; vertex++) {
+            degrees[vertex] = vertex % 3;
+        }
+        compressed_adjacency_list<int> adjacency_list(degrees, true);
+        REQUIRE(adjacency_list.size() == num_vertices);
+        REQUIRE(adjacency_list.num_edges() == num_vertices - 1);
+
+        std::vector<std::size_t> offsets, expected_offsets;
+        std::size_t offset = 0;
+        for (std::size_t vertex = 0; vertex < num_vertices; vertex++) {
+            auto out_edges = adjacency_list[vertex];
+            offsets.push_back(out_edges.begin() - adjacency_list[0].begin());
+            offsets.push_back(out_edges.size());
+            expected_offsets.push_back(offset);
+            expected_offsets.push_back(degrees[vertex]);
+            offset += degrees[vertex];
+        }
+        REQUIRE(offsets == expected_offsets);
+    }
+
+    SECTION("Test the transpose lists the in edges in order") {
+        for (auto& adjacency_list : graphs) {
+            int num_vertices = adjacency_list.size();
+            std::vector<std::vector<int>> expected(num_vertices);
+            for (int vertex = 0; vertex < num_vertices; vertex++) {
+                for (int to_vertex : adjacency_list[vertex]) {
+                    expected[to_vertex].push_back(vertex);
+                }
+            }
+            std::vector<std::vector<int>> transposed;
+            getTransposedAdjacencyList(adjacency_list, transposed);
+            REQUIRE(transposed == expected);
+
+            auto compressed = compress(adjacency_list);
+            compressed_adjacency_list<int> compressed_transposed;
+            getTransposedAdjacencyList(compressed, compressed_transposed);
+            REQUIRE(compressed_transposed.num_edges() == compressed.num_edges());
+            for (int vertex = 0; vertex < num_vertices; vertex++) {
+                auto in_edges = compressed_transposed[vertex];
+                REQUIRE(std::vector<int>(in_edges.begin(), in_edges.end()) == expected[vertex]);
+            }
+        }
+    }
+
+    SECTION("Test the parallel strongly connected components match Tarjan's") {
+        for (auto& adjacency_list : graphs) {
+            int num_vertices = adjacency_list.size();
+            std::vector<std::vector<int>> transposed;
+            getTransposedAdjacencyList(adjacency_list, transposed);
+
+            std::vector<int> components;
+            int num_components = stronglyConnectedComponents(adjacency_list, components);
+            std::vector<int> components_parallel;
+            REQUIRE(stronglyConnectedComponentsParallel(adjacency_list, transposed,
+                                                        components_parallel) == num_components);
+
+            // Same partition, numbered in the order of the smallest vertex.
+            std::vector<int> numbering(num_components, -1);
+            int next_number = 0;
+            for (int vertex = 0; vertex < num_vertices; vertex++) {
+                if (numbering[components[vertex]] == -1) {
+                    numbering[components[vertex]] = next_number++;
+                }
+                REQUIRE(components_parallel[vertex] == numbering[components[vertex]]);
+            }
+
+            auto compressed = compress(adjacency_list);
+            compressed_adjacency_list<int> compressed_transposed;
+            getTransposedAdjacencyList(compressed, compressed_transposed);
+            std::vector<int> components_compressed;
+            REQUIRE(stronglyConnectedComponents(compressed, components_compressed) ==
+                    num_components);
+            REQUIRE(components_compressed == components);
+            REQUIRE(stronglyConnectedComponentsParallel(compressed, compressed_transposed,
+                                                        components_compressed) ==
+                    num_components);
+            REQUIRE(components_compressed == components_parallel);
+        }
+    }
+
+    SECTION("Test breadth first search") {
+        for (auto& adjacency_list : graphs) {
+            int num_vertices = adjacency_list.size();
+            std::vector<int> depths;
+            int unvisited = breadthFirstSearch(adjacency_list, 0, depths);
+
+            std::vector<int> expected(num_vertices, unvisited);
+            std::vector<int> queue = {0};
+            expected[0] = 0;
+            for (std::size_t i = 0; i < queue.size(); i++) {
+                for (int to_vertex : adjacency_list[queue[i]]) {
+                    if (expected[to_vertex] == unvisited) {
+                        expected[to_vertex] = expected[queue[i]] + 1;
+                        queue.push_back(to_vertex);
+                    }
+                }
+            }
+            REQUIRE(depths == expected);
+        }
+    }
+}
+
+TEST_CASE("Tests for IncrementalRoofDuality", "[roofduality]") {
+    SECTION("Test small changes give the same result as fixQuboVariables") {
+        // The networks are scaled differently, so with integer biases ties
+        // between minimum cuts can be broken differently by the rounding.
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> bias(-10, 10);
+        std::uniform_real_distribution<double> density(0, 1);
+
+        int num_vars = 60;
+        std::vector<float> Q(num_vars * num_vars, 0);
+        std::vector<std::pair<int, int>> interactions;
+        for (int u = 0; u < num_vars; u++) {
+            Q[u * num_vars + u] = bias(rng);
+            for (int v = u + 1; v < num_vars; v++) {
+                if (density(rng) < 0.1) {
+                    Q[u * num_vars + v] = bias(rng);
+                    interactions.push_back({u, v});
+                }
+            }
+        }
+        auto bqm = dimod::BinaryQuadraticModel<float, int>(Q.data(), num_vars,
+                                                            dimod::Vartype::BINARY);
+
+        IncrementalRoofDuality<int, float> roof_duality(bqm);
+        std::uniform_int_distribution<int> variable(0, num_vars - 1);
+        std::uniform_int_distribution<int> interaction(0, interactions.size() - 1);
+        std::uniform_real_distribution<float> delta(-1, 1);
+
+        int num_changes = 50;
+        for (int change = 0; change < num_changes; change++) {
+            if (change % 2) {
+                int v = variable(rng);
+                roof_duality.addLinear(v, delta(rng));
+            } else {
+                auto& uv = interactions[interaction(rng)];
+                roof_duality.addQuadratic(uv.first, uv.second, delta(rng));
+            }
+
+            auto current = roof_duality.getBQM();
+            for (auto strict : {true, false}) {
+                auto result = roof_duality.fixVariables(strict, 1.5);
+                auto expected = fixQuboVariables(current, strict, 1.5);
+                REQUIRE(result.first == Approx(expected.first));
+                if (strict) {
+                    REQUIRE(result.second == expected.second);
+                } else {
+                    REQUIRE(result.second.size() == expected.second.size());
+                }
+            }
+        }
+
+        // most of the changes did not need a new network
+        REQUIRE(roof_duality.getNumRebuilds() < static_cast<std::size_t>(num_changes / 2));
+    }
+
+    SECTION("Test shrinking biases gives the same result as fixQuboVariables") {
+        std::mt19937 rng(13);
+        std::uniform_real_distribution<double> bias(-10, 10);
+        std::uniform_real_distribution<double> density(0, 1);
+
+        int num_vars = 40;
+        auto bqm = dimod::BinaryQuadraticModel<double, int>(num_vars, dimod::Vartype::BINARY);
+        for (int u = 0; u < num_vars; u++) {
+            bqm.set_linear(u, bias(rng));
+            for (int v = u + 1; v < num_vars; v++) {
+                if (density(rng) < 0.15) bqm.add_quadratic(u, v, bias(rng));
+            }
+        }
+
+        IncrementalRoofDuality<int, double> roof_duality(bqm);
+
+        // each step quarters a few of the biases. Those keep their signs, so the
+        // network mostly keeps its scale while fixQuboVariables() scales them
+        // afresh, though the posiform coefficients can still flip sign.
+        std::uniform_int_distribution<int> variable(0, num_vars - 1);
+        for (int step = 0; step < 20; step++) {
+            for (int i = 0; i < 5; i++) {
+                int u = variable(rng);
+                roof_duality.addLinear(u, -0.75 * roof_duality.getBQM().linear(u));
+                auto it = roof_duality.getBQM().cbegin_neighborhood(u);
+                if (it != roof_duality.getBQM().cend_neighborhood(u)) {
+                    roof_duality.addQuadratic(u, it->v, -0.75 * it->bias);
+                }
+            }
+
+            auto current = roof_duality.getBQM();
+            auto result = roof_duality.fixVariables(true);
+            auto expected = fixQuboVariables(current, true);
+            REQUIRE(result.first == Approx(expected.first));
+            REQUIRE(result.second == expected.second);
+        }
+        REQUIRE(roof_duality.getNumRebuilds() < 10);
+    }
+
+    SECTION("Test a new interaction rebuilds the network") {
+        float Q[9] = {22, -4, 0, 0, 0, 4, 0, 0, -2};
+
+        auto bqm = dimod::BinaryQuadraticModel<float, int>(Q, 3, dimod::Vartype::BINARY);
+        IncrementalRoofDuality<int, float> roof_duality(bqm);
+        roof_duality.fixVariables(true);
+        REQUIRE(roof_duality.getNumRebuilds() == 1);
+
+        roof_duality.addLinear(0, -1);
+        roof_duality.addQuadratic(0, 1, 1);
+        auto current = roof_duality.getBQM();
+        auto result = roof_duality.fixVariables(true);
+        REQUIRE(roof_duality.getNumRebuilds() == 1);
+        REQUIRE(result.first == Approx(fixQuboVariables(current, true).first));
+
+        roof_duality.addQuadratic(0, 2, 3);
+        current = roof_duality.getBQM();
+        result = roof_duality.fixVariables(true);
+        REQUIRE(roof_duality.getNumRebuilds() == 2);
+        REQUIRE(result == fixQuboVariables(current, true));
+    }
+}
+
 }  // namespace fix_variables_
@@ -0,0 +1,123 @@
+// Copyright 2023 D-Wave Systems Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "dwave-preprocessing/spin_reversal_transform.hpp"
+
+TEST_CASE("Tests for spinReversalTransformBatch", "[spinreversaltransform]") {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> bias(-5, 5);
+    std::uniform_int_distribution<int> coin(0, 1);
+
+    for (auto vartype : {dimod::Vartype::SPIN, dimod::Vartype::BINARY}) {
+        bool binary = vartype == dimod::Vartype::BINARY;
+        WHEN(std::string("the BQM is ") + (binary ? "BINARY" : "SPIN")) {
+            const int num_variables = 8;
+            const int num_transforms = 5;
+
+            auto bqm = dimod::BinaryQuadraticModel<double, int>(num_variables, vartype);
+            for (int u = 0; u < num_variables; u++) {
+                bqm.set_linear(u, bias(rng));
+                for (int v = u + 1; v < num_variables; v++) {
+                    if (coin(rng)) bqm.add_quadratic(u, v, bias(rng));
+                }
+            }
+            bqm.set_offset(1.5);
+            std::size_t num_interactions = bqm.num_interactions();
+
+            std::vector<std::int8_t> flips(num_transforms * num_variables);
+            for (auto& flip : flips) flip = coin(rng);
+
+            std::vector<double> linear(num_transforms * num_variables);
+            std::vector<double> quadratic(num_transforms * num_interactions);
+            std::vector<double> offsets(num_transforms);
+            std::vector<int> irow(num_interactions);
+            std::vector<int> icol(num_interactions);
+
+            for (int num_threads : {1, 3}) {
+                spinReversalTransformBatch(bqm, flips.data(), num_transforms, linear.data(),
+                                           quadratic.data(), offsets.data(), irow.data(),
+                                           icol.data(), num_threads);
+
+                for (int t = 0; t < num_transforms; t++) {
+                    auto transformed = dimod::BinaryQuadraticModel<double, int>(num_variables, vartype);
+                    for (int v = 0; v < num_variables; v++) {
+                        transformed.set_linear(v, linear[t * num_variables + v]);
+                    }
+                    for (std::size_t i = 0; i < num_interactions; i++) {
+                        REQUIRE(irow[i] < icol[i]);
+                        transformed.add_quadratic(irow[i], icol[i],
+                                                  quadratic[t * num_interactions + i]);
+                    }
+                    transformed.set_offset(offsets[t]);
+
+                    // Every sample, with the variables of the transform flipped, has the
+                    // same energy in the transformed BQM.
+                    for (int s = 0; s < (1 << num_variables); s++) {
+                        std::vector<int> sample(num_variables);
+                        std::vector<int> flipped(num_variables);
+                        for (int v = 0; v < num_variables; v++) {
+                            int value = (s >> v) & 1;
+                            int flipped_value = value ^ flips[t * num_variables + v];
+                            sample[v] = binary ? value : 2 * value - 1;
+                            flipped[v] = binary ? flipped_value : 2 * flipped_value - 1;
+                        }
+                        REQUIRE(transformed.energy(flipped.begin()) ==
+                                Approx(bqm.energy(sample.begin())));
+                    }
+                }
+            }
+
+            AND_WHEN("samples of the transformed BQMs are unflipped") {
+                std::vector<std::ptrdiff_t> num_samples = {2, 0, 1, 3, 1};
+                std::vector<std::int8_t> samples;
+                std::vector<std::int8_t> expected;
+                for (int t = 0; t < num_transforms; t++) {
+                    for (int r = 0; r < num_samples[t]; r++) {
+                        for (int v = 0; v < num_variables; v++) {
+                            int value = coin(rng);
+                            int flipped_value = value ^ flips[t * num_variables + v];
+                            expected.push_back(binary ? value : 2 * value - 1);
+                            samples.push_back(binary ? flipped_value : 2 * flipped_value - 1);
+                        }
+                    }
+                }
+
+                spinReversalUnflipBatch(samples.data(), num_samples.data(), num_variables,
+                                        flips.data(), num_transforms, vartype, 2);
+
+                THEN("they are the samples of the BQM") {
+                    CHECK(samples == expected);
+                }
+            }
+        }
+    }
+
+    SECTION("Test invalid arguments") {
+        auto bqm = dimod::BinaryQuadraticModel<double, int>(1, dimod::Vartype::SPIN);
+        std::int8_t flip = 1;
+        double linear, offset;
+        double* quadratic = nullptr;
+        int* irow = nullptr;
+        REQUIRE_THROWS_AS(spinReversalTransformBatch(bqm, &flip, 1, &linear, quadratic, &offset,
+                                                     irow, irow, 0),
+                          std::invalid_argument);
+    }
+}